@@ -0,0 +1,338 @@
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <stdlib.h>
+#include <boost/shared_ptr.hpp>
+#include <utils/eoRNG.h>
+#include "chromosome/eoChromosome.h"
+#include "testset/ITC2007TestSet.h"
+#include "graphColouring/GraphColouringHeuristics.h"
+#include "kempeChain/ETTPKempeChainHeuristic.h"
+
+using namespace std;
+
+
+//
+// Microbenchmarks of the hot kernels of the solver on the ITC2007 instances.
+//
+// Each kernel is timed in isolation, with a fixed seed per repetition, so that two
+// builds run exactly the same calls on the same solutions. The Kempe chain kernels
+// are timed on the same sequence of random moves from the initial solution, which is
+// restored after each move. Results are reported as nanoseconds per call (mean, standard
+// deviation, minimum, median and maximum over the repetitions) in a CSV file; given the
+// CSV file of a previous build, the speedup of the median of each kernel is reported.
+//
+
+
+typedef chrono::steady_clock Clock;
+
+// Kernels
+enum Kernel {
+    Load, SaturationDegree, ComputeCost, Copy, Build, EvaluateSolutionMove,
+    ComputeSolutionCostIncremental, Apply, GetFeasibleRoom, NumKernels
+};
+
+char const *kernelNames[NumKernels] = {
+    "ITC2007TestSet::load",
+    "GCHeuristics::saturationDegree",
+    "eoChromosome::computeCost",
+    "eoChromosome::copy",
+    "ETTPKempeChainHeuristic::build",
+    "ETTPKempeChainHeuristic::evaluateSolutionMove",
+    "eoChromosome::computeSolutionCostIncremental",
+    "ETTPKempeChainHeuristic::apply",
+    "eoChromosome::getFeasibleRoom"
+};
+
+// Calls per repetition
+const int numCostEvaluations = 20;
+const int numCopies = 200;
+const int numMoves = 2000;
+// Seed of the first repetition
+const uint32_t firstSeed = 1;
+
+
+/**
+ * @brief The Timing struct. Time spent in the calls of one kernel during one repetition
+ */
+struct Timing {
+    double ns;
+    unsigned long calls;
+
+    void add(Clock::time_point _start) {
+        ns += chrono::duration<double, nano>(Clock::now() - _start).count();
+        ++calls;
+    }
+};
+
+
+/**
+ * @brief The Summary struct. Nanoseconds per call of one kernel over the repetitions
+ */
+struct Summary {
+    unsigned long calls;
+    double mean;
+    double stdDev;
+    double min;
+    double median;
+    double max;
+};
+
+
+/**
+ * @brief summarise
+ * @param _timings Timings of the repetitions
+ * @return
+ */
+Summary summarise(vector<Timing> const& _timings) {
+    Summary summary = Summary();
+    vector<double> nsPerCall;
+    for (auto const& timing : _timings) {
+        summary.calls += timing.calls;
+        if (timing.calls > 0)
+            nsPerCall.push_back(timing.ns / timing.calls);
+    }
+    if (nsPerCall.empty()) {
+        summary.mean = summary.stdDev = summary.min = summary.median = summary.max = NAN;
+        return summary;
+    }
+    sort(nsPerCall.begin(), nsPerCall.end());
+    double n = nsPerCall.size(), sum = 0, sumSquares = 0;
+    for (double x : nsPerCall) {
+        sum += x;
+        sumSquares += x*x;
+    }
+    summary.mean = sum / n;
+    summary.stdDev = (n > 1) ? sqrt(max(0.0, (sumSquares - sum*sum/n) / (n-1))) : 0.0;
+    summary.min = nsPerCall.front();
+    summary.max = nsPerCall.back();
+    size_t middle = nsPerCall.size() / 2;
+    summary.median = (nsPerCall.size() % 2) ? nsPerCall[middle] : (nsPerCall[middle-1] + nsPerCall[middle]) / 2;
+    return summary;
+}
+
+
+/**
+ * @brief readBaseline Read the median of each instance and kernel from a CSV file of a previous run
+ * @param _filename
+ * @return
+ */
+map<pair<string, string>, double> readBaseline(string const& _filename) {
+    ifstream file(_filename);
+    if (!file)
+        throw runtime_error("Couldn't open baseline file: " + _filename);
+    map<pair<string, string>, double> baseline;
+    string line;
+    getline(file, line); // Header
+    while (getline(file, line)) {
+        vector<string> fields;
+        stringstream sstream(line);
+        string field;
+        while (getline(sstream, field, ','))
+            fields.push_back(field);
+        // instance,kernel,repetitions,calls,mean_ns,stddev_ns,min_ns,median_ns,...
+        if (fields.size() < 8)
+            throw runtime_error(_filename + ": malformed line: " + line);
+        baseline[make_pair(fields[0], fields[1])] = atof(fields[7].c_str());
+    }
+    return baseline;
+}
+
+
+/**
+ * @brief runRepetition Time the kernels once on an instance
+ * @param _instanceFile
+ * @param _instance
+ * @param _benchmarksDir
+ * @param _data Instance, already loaded
+ * @param _seed
+ * @param _timings Receives the timing of each kernel
+ */
+void runRepetition(string const& _instanceFile, string const& _instance, string const& _benchmarksDir,
+                   TimetableProblemData const *_data, uint32_t _seed, vector<Timing>& _timings) {
+    _timings.assign(NumKernels, Timing());
+    eoRng gen(_seed);
+
+    // Instance loading
+    {
+        ITC2007TestSet testSet(_instanceFile, _instance, _benchmarksDir);
+        auto start = Clock::now();
+        testSet.load();
+        _timings[Load].add(start);
+    }
+
+    // Construction of the initial solution
+    eoChromosome solution;
+    solution.setTimetableProblemData(_data);
+    {
+        auto start = Clock::now();
+        GCHeuristics<eoChromosome>::saturationDegree(_data, solution, gen);
+        _timings[SaturationDegree].add(start);
+    }
+
+    // Full evaluation
+    for (int i = 0; i < numCostEvaluations; ++i) {
+        auto start = Clock::now();
+        solution.computeCost();
+        _timings[ComputeCost].add(start);
+    }
+    solution.fitness(solution.getSolutionCost());
+
+    // Copy
+    {
+        vector<eoChromosome> copies(numCopies);
+        for (auto& copy : copies) {
+            auto start = Clock::now();
+            copy = solution;
+            _timings[Copy].add(start);
+        }
+    }
+
+    // Kempe chain moves: build, evaluate, re-run the incremental evaluation, apply the
+    // move and restore the solution
+    ETTPKempeChainHeuristic<eoChromosome> kempeChainHeuristic(gen);
+    long solutionCost = solution.getSolutionCost();
+    for (int i = 0; i < numMoves; ++i) {
+        auto start = Clock::now();
+        kempeChainHeuristic.build(solution);
+        _timings[Build].add(start);
+        start = Clock::now();
+        kempeChainHeuristic.evaluateSolutionMove(solution);
+        _timings[EvaluateSolutionMove].add(start);
+        if (!kempeChainHeuristic.isFeasibleNeighbour())
+            continue;
+        start = Clock::now();
+        solution.computeSolutionCostIncremental(kempeChainHeuristic.getKempeChain());
+        _timings[ComputeSolutionCostIncremental].add(start);
+        if (solution.getSolutionCost() != kempeChainHeuristic.getNeighborSolutionCost())
+            throw runtime_error(_instance + ": the incremental evaluation is not reproducible");
+        solution.setSolutionCost(solutionCost);
+        start = Clock::now();
+        kempeChainHeuristic(solution);
+        _timings[Apply].add(start);
+        kempeChainHeuristic.undoSolutionMove(solution);
+    }
+
+    // Room selection of random exams moved to random periods. The exam is unscheduled
+    // during the call, as in the Kempe chain moves.
+    TimetableContainer& timetableCont = solution.getTimetableContainer();
+    int numExams = solution.getNumExams(), numPeriods = solution.getNumPeriods(), rk;
+    for (int i = 0; i < numMoves && numPeriods > 1; ++i) {
+        int ei = gen.uniform(numExams);
+        int ti = solution.getScheduledExamsVector()[ei].getPeriod();
+        int ri = solution.getScheduledExamsVector()[ei].getRoom();
+        int tj = gen.uniform(numPeriods - 1);
+        if (tj >= ti)
+            ++tj;
+        timetableCont.unscheduleExam(ei, ti);
+        auto start = Clock::now();
+        solution.getFeasibleRoom(ei, tj, rk, gen);
+        _timings[GetFeasibleRoom].add(start);
+        timetableCont.scheduleExam(ei, ti, ri);
+    }
+}
+
+
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        cout << "Usage: ./benchmarkKernels <test benchmarks directory>   [# repetitions]   [output CSV file]   "
+                "[baseline CSV file]   [instances...]" << endl;
+        cout << "   Example: ./benchmarkKernels ./../../ETTP-Benchmarks/ITC2007 10 kernels.csv previous.csv set1 set4" << endl;
+        cout << "   An empty file name (\"\") skips the output or baseline. By default the instances are set1 to set12." << endl;
+        return -1;
+    }
+    // Get test benchmarks directory
+    string testBenchmarksDir = argv[1];
+    // Get # repetitions
+    int numRepetitions = (argc > 2) ? atoi(argv[2]) : 10;
+    if (numRepetitions <= 0)
+        numRepetitions = 1;
+    // Get output and baseline CSV files
+    string csvFilename = (argc > 3) ? argv[3] : "";
+    string baselineFilename = (argc > 4) ? argv[4] : "";
+    // Get instances
+    vector<string> instances;
+    for (int i = 5; i < argc; ++i)
+        instances.push_back(argv[i]);
+    if (instances.empty()) {
+        for (int i = 1; i <= 12; ++i)
+            instances.push_back("set" + to_string(i));
+    }
+
+    map<pair<string, string>, double> baseline;
+    ofstream csvFile;
+    try {
+        if (!baselineFilename.empty())
+            baseline = readBaseline(baselineFilename);
+        if (!csvFilename.empty()) {
+            csvFile.open(csvFilename);
+            if (!csvFile)
+                throw runtime_error("Couldn't create output file: " + csvFilename);
+            csvFile << "instance,kernel,repetitions,calls,mean_ns,stddev_ns,min_ns,median_ns,max_ns,"
+                       "baseline_median_ns,speedup" << endl;
+        }
+    }
+    catch (runtime_error const& e) {
+        cerr << e.what() << endl;
+        return -1;
+    }
+
+    cout << numRepetitions << " repetitions, seeds " << firstSeed << " to " << firstSeed + numRepetitions - 1 << endl;
+    int status = 0;
+    for (auto const& instance : instances) {
+        string instanceFile = ITC2007TestSet::findInstanceFile(testBenchmarksDir, instance);
+        if (instanceFile.empty()) {
+            cerr << instance << ": instance file not found in " << testBenchmarksDir << endl;
+            status = -1;
+            continue;
+        }
+        vector<vector<Timing> > timings(NumKernels, vector<Timing>(numRepetitions));
+        try {
+            ITC2007TestSet testSet(instanceFile, instance, testBenchmarksDir);
+            testSet.load();
+            vector<Timing> repetitionTimings;
+            for (int r = 0; r < numRepetitions; ++r) {
+                runRepetition(instanceFile, instance, testBenchmarksDir, testSet.getTimetableProblemData().get(),
+                              firstSeed + r, repetitionTimings);
+                for (int k = 0; k < NumKernels; ++k)
+                    timings[k][r] = repetitionTimings[k];
+            }
+        }
+        catch (runtime_error const& e) {
+            cerr << instance << ": " << e.what() << endl;
+            status = -1;
+            continue;
+        }
+
+        cout << endl << instance << endl;
+        cout << left << setw(48) << "Kernel" << right << setw(10) << "Calls" << setw(14) << "Mean (ns)"
+             << setw(12) << "Std dev" << setw(14) << "Min" << setw(14) << "Median" << setw(14) << "Max"
+             << setw(10) << "Speedup" << endl;
+        for (int k = 0; k < NumKernels; ++k) {
+            Summary summary = summarise(timings[k]);
+            auto it = baseline.find(make_pair(instance, string(kernelNames[k])));
+            double baselineMedian = (it != baseline.end()) ? it->second : NAN;
+            double speedup = baselineMedian / summary.median;
+            cout << left << setw(48) << kernelNames[k] << right << fixed << setprecision(1) << setw(10)
+                 << summary.calls << setw(14) << summary.mean << setw(12) << summary.stdDev << setw(14)
+                 << summary.min << setw(14) << summary.median << setw(14) << summary.max << setprecision(3)
+                 << setw(10) << speedup << endl;
+            if (csvFile.is_open())
+                csvFile << instance << "," << kernelNames[k] << "," << numRepetitions << "," << summary.calls
+                        << fixed << setprecision(1) << "," << summary.mean << "," << summary.stdDev << ","
+                        << summary.min << "," << summary.median << "," << summary.max << "," << baselineMedian
+                        << setprecision(3) << "," << speedup << endl;
+        }
+    }
+    return status;
+}
@@ -0,0 +1,152 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <utils/eoRNG.h>
+#include "chromosome/eoChromosome.h"
+#include "testset/ITC2007TestSet.h"
+#include "graphColouring/GraphColouringHeuristics.h"
+#include "eval/eoETTPEval.h"
+#include "algorithms/mo/moSimpleCoolingSchedule.h"
+#include "statistics/optimised/ExamMoveStatisticsOpt.h"
+
+using namespace std;
+
+
+//
+// Checkpoint/resume test of FastTA (ExamMoveStatisticsOpt with a moTACheckpoint).
+//
+// A seeded FastTA run is checkpointed and stopped halfway, then resumed from its checkpoint
+// with another seed, so that the whole search state has to come from the file. The resumed
+// run must end exactly as an uninterrupted run from the same seed: same best solution, same
+// # evaluations and same exam fixing state.
+//
+
+
+// Default cooling schedule (Sch #1 with alpha = 0.001): about 43k iterations
+const double defaultInitT = 0.1, defaultAlpha = 0.001, defaultSpan = 5, defaultFinalT = 2e-5;
+// FastTA threshold bins, as in MainApp
+const int numBins = 10;
+
+// Determine # evaluations
+extern int getSANumberEvaluations(double tmax, double r, double k, double tmin);
+
+
+/**
+ * @brief The RunState struct. State of a FastTA run at its end
+ */
+struct RunState {
+    bool resumed;
+    long evaluations;
+    long cost;
+    double fitness;
+    // Solution, by exam
+    vector<int> periods;
+    vector<int> rooms;
+    // Exam fixing state (ExamMoveStatisticsOpt::saveState)
+    vector<int> fixingState;
+};
+
+
+/**
+ * @brief runFastTA Run FastTA from the seeded initial solution, checkpointed to _checkpointFilename
+ * @param _testSet Instance
+ * @param _workDir Directory of the FastTA statistics files
+ * @param _seed
+ * @param _checkpointFilename
+ * @param _interval # iterations between checkpoints
+ * @param _stopIteration Iteration at which the search is stopped, or 0
+ * @return State at the end of the run
+ */
+RunState runFastTA(ITC2007TestSet const& _testSet, string const& _workDir, uint32_t _seed,
+                   string const& _checkpointFilename, unsigned long _interval, uint64_t _stopIteration) {
+    TimetableProblemData const *data = _testSet.getTimetableProblemData().get();
+    moSimpleCoolingSchedule<eoChromosome> coolSchedule(defaultInitT, defaultAlpha, defaultSpan, defaultFinalT);
+    ExamMoveStatisticsOpt fastTA(_testSet, _workDir, numBins, coolSchedule);
+    fastTA.generateThresholds();
+    fastTA.determineExamsColorDegree();
+    fastTA.setCheckpoint(_checkpointFilename, _interval, _stopIteration);
+    // Initial solution
+    rng.reseed(_seed);
+    eoChromosome solution;
+    solution.setTimetableProblemData(data);
+    GCHeuristics<eoChromosome>::saturationDegree(data, solution, rng);
+    if (!solution.isFeasible())
+        throw runtime_error("no feasible initial solution");
+    eoETTPEval<eoChromosome> eval;
+    eval(solution);
+
+    RunState state;
+    state.evaluations = fastTA.search(solution);
+    state.resumed = fastTA.isResumed();
+    state.cost = solution.getSolutionCost();
+    state.fitness = solution.fitness();
+    for (auto const& scheduledExam : solution.getScheduledExamsVector()) {
+        state.periods.push_back(scheduledExam.getPeriod());
+        state.rooms.push_back(scheduledExam.getRoom());
+    }
+    fastTA.saveState(state.fixingState);
+    return state;
+}
+
+
+/**
+ * @brief check Print the outcome of a check
+ * @return _passed
+ */
+bool check(char const *_what, bool _passed) {
+    cout << (_passed ? "  ok    " : "  FAIL  ") << _what << endl;
+    return _passed;
+}
+
+
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3) {
+        cout << "Usage: ./checkpointResume <test benchmarks directory> <instance> [work directory] [seed]" << endl;
+        cout << "   Example: ./checkpointResume ./../../ETTP-Benchmarks/ITC2007 set4 /tmp 1" << endl;
+        cout << "   Exits with status 1 if the resumed run differs from the uninterrupted one." << endl;
+        return -1;
+    }
+    string testBenchmarksDir = argv[1];
+    string instance = argv[2];
+    string workDir = (argc > 3) ? argv[3] : ".";
+    uint32_t seed = (argc > 4) ? strtoul(argv[4], nullptr, 10) : 1;
+    try {
+        auto testSet = ITC2007TestSet::loadInstance(testBenchmarksDir, instance);
+        // Stop halfway, with a few periodic checkpoints before
+        uint64_t stopIteration = getSANumberEvaluations(defaultInitT, defaultAlpha, defaultSpan, defaultFinalT) / 2;
+        unsigned long interval = stopIteration / 4 + 1;
+        string referenceFilename = workDir + "/" + instance + "_reference.ckpt";
+        string checkpointFilename = workDir + "/" + instance + "_resumed.ckpt";
+        remove(referenceFilename.c_str());
+        remove(checkpointFilename.c_str());
+
+        RunState reference = runFastTA(*testSet, workDir, seed, referenceFilename, interval, 0);
+        RunState stopped = runFastTA(*testSet, workDir, seed, checkpointFilename, interval, stopIteration);
+        RunState resumed = runFastTA(*testSet, workDir, seed+1, checkpointFilename, interval, 0);
+        remove(referenceFilename.c_str());
+        remove(checkpointFilename.c_str());
+
+        cout << instance << ", seed " << seed << ", stopped at iteration " << stopIteration << endl;
+        cout << "  uninterrupted: cost " << reference.cost << ", " << reference.evaluations << " evaluations" << endl;
+        cout << "  stopped:       cost " << stopped.cost << ", " << stopped.evaluations << " evaluations" << endl;
+        cout << "  resumed:       cost " << resumed.cost << ", " << resumed.evaluations << " evaluations" << endl;
+        bool passed = true;
+        passed &= check("the stopped run starts afresh", !stopped.resumed);
+        passed &= check("the stopped run stops early", stopped.evaluations < reference.evaluations);
+        passed &= check("the resumed run resumes", resumed.resumed);
+        passed &= check("same # evaluations", resumed.evaluations == reference.evaluations);
+        passed &= check("same best solution", resumed.cost == reference.cost && resumed.fitness == reference.fitness
+                        && resumed.periods == reference.periods && resumed.rooms == reference.rooms);
+        passed &= check("same exam fixing state", resumed.fixingState == reference.fixingState);
+        return passed ? 0 : 1;
+    }
+    catch (runtime_error const& e) {
+        cerr << e.what() << endl;
+        return -1;
+    }
+}
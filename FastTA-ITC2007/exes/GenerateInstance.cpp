@@ -0,0 +1,51 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <stdexcept>
+#include "testset/ITC2007Generator.h"
+
+using namespace std;
+
+
+//
+// Generation of synthetic ITC2007 examination track instances, for scaling tests beyond
+// the sizes of the competition sets. The parameters are given as name=value pairs; the
+// defaults give an instance of the size of set 1.
+//
+
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        cout << "Usage: ./generateInstance <output .exam file>   [name=value ...]" << endl;
+        cout << "   Example: ./generateInstance large.exam seed=1 exams=50000 students=500000 days=40 rooms=200" << endl;
+        cout << "   Parameters (defaults):" << endl;
+        ITC2007Generator::Parameters().print(cout);
+        return -1;
+    }
+    string outputFilename = argv[1];
+    try {
+        ITC2007Generator::Parameters parameters;
+        for (int i = 2; i < argc; ++i) {
+            string argument = argv[i];
+            size_t equals = argument.find('=');
+            if (equals == string::npos)
+                throw runtime_error("expected name=value: " + argument);
+            parameters.set(argument.substr(0, equals), argument.substr(equals+1));
+        }
+        parameters.print(cout);
+        cout << endl;
+        auto start = chrono::steady_clock::now();
+        ITC2007Generator generator(parameters);
+        generator.generate();
+        generator.write(outputFilename);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        generator.printStatistics(cout);
+        cout << endl << outputFilename << " written in " << seconds << " s" << endl;
+    }
+    catch (runtime_error const& e) {
+        cerr << e.what() << endl;
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,313 @@
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <stdexcept>
+#include <stdlib.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <boost/shared_ptr.hpp>
+#include "chromosome/eoChromosome.h"
+#include "testset/ITC2007TestSet.h"
+#include "init/ETTPSolutionInit.h"
+#include "statistics/FriedmanTest.h"
+#include "utils/WorkStealingPool.h"
+
+using namespace std;
+
+
+//
+// Re-evaluate the solutions of a results tree and rank the algorithms.
+//
+// The tree has the layout <runs directory>/<algorithm>/<run>/<instance>.sln, e.g.
+// RUNS/FastTA100/Run1/set1.sln. Each solution is checked against the hard constraints
+// and its cost is recomputed with eoChromosome::computeCost. The algorithms are then
+// ranked by their average cost on each instance with the Friedman test, and compared
+// with the best ranked one with Holm's procedure, as done by Rankings/multipleTest.
+//
+
+
+/**
+ * @brief The SolutionFile struct. A solution of the results tree and its evaluation
+ */
+struct SolutionFile {
+    int algorithm;
+    int instance;
+    string filename;
+    // Evaluation
+    bool feasible;
+    long cost;
+    string error;
+};
+
+
+/**
+ * @brief The Aggregate struct. Results of one algorithm on one instance
+ */
+struct Aggregate {
+    int numRuns;
+    int numFeasible;
+    long best;
+    double mean;
+    double stdDev;
+};
+
+
+/**
+ * @brief listDirectory
+ * @param _dir
+ * @param _directories If true, list the subdirectories, otherwise the regular files
+ * @return Sorted entry names
+ */
+vector<string> listDirectory(string const& _dir, bool _directories) {
+    vector<string> entries;
+    DIR *dir = opendir(_dir.c_str());
+    if (dir == nullptr)
+        throw runtime_error("Couldn't open directory: " + _dir);
+    while (struct dirent *entry = readdir(dir)) {
+        string name = entry->d_name;
+        if (name == "." || name == "..")
+            continue;
+        struct stat st;
+        if (stat((_dir + "/" + name).c_str(), &st) != 0)
+            continue;
+        if ((_directories && S_ISDIR(st.st_mode)) || (!_directories && S_ISREG(st.st_mode)))
+            entries.push_back(name);
+    }
+    closedir(dir);
+    sort(entries.begin(), entries.end());
+    return entries;
+}
+
+
+/**
+ * @brief naturalLess Order names by length first, so that set2 comes before set10
+ */
+bool naturalLess(string const& _s1, string const& _s2) {
+    return _s1.size() != _s2.size() ? _s1.size() < _s2.size() : _s1 < _s2;
+}
+
+
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3 || argc > 5) {
+        cout << "Usage: ./rankRuns <test benchmarks directory>   <runs directory>   [# threads]   [output CSV file]" << endl;
+        cout << "   Example: ./rankRuns ./../../ETTP-Benchmarks/ITC2007 ./../../RUNS 8 ranking.csv" << endl;
+        return -1;
+    }
+    // Get test benchmarks directory
+    string testBenchmarksDir = argv[1];
+    // Get runs directory
+    string runsDir = argv[2];
+    // Get # threads. All cores by default.
+    unsigned numThreads = (argc > 3) ? atoi(argv[3]) : thread::hardware_concurrency();
+    if (numThreads == 0)
+        numThreads = 1;
+    // Get output CSV file
+    string csvFilename = (argc > 4) ? argv[4] : "";
+
+    auto start = chrono::high_resolution_clock::now();
+
+    //
+    // Scan the results tree
+    //
+    vector<string> algorithms, instances;
+    vector<SolutionFile> solutions;
+    // Instance name of each solution, and index of each instance name
+    vector<string> solutionInstances;
+    map<string, int> instanceIndex;
+    try {
+        algorithms = listDirectory(runsDir, true);
+        for (int a = 0; a < (int)algorithms.size(); ++a) {
+            string algorithmDir = runsDir + "/" + algorithms[a];
+            for (auto const& run : listDirectory(algorithmDir, true)) {
+                string runDir = algorithmDir + "/" + run;
+                for (auto const& file : listDirectory(runDir, false)) {
+                    if (file.size() <= 4 || file.compare(file.size()-4, 4, ".sln") != 0)
+                        continue;
+                    SolutionFile solution;
+                    solution.algorithm = a;
+                    solution.instance = -1;
+                    solution.filename = runDir + "/" + file;
+                    solution.feasible = false;
+                    solution.cost = 0;
+                    solutions.push_back(solution);
+                    solutionInstances.push_back(file.substr(0, file.size()-4));
+                    instanceIndex[solutionInstances.back()] = -1;
+                }
+            }
+        }
+    }
+    catch (runtime_error const& e) {
+        cerr << e.what() << endl;
+        return -1;
+    }
+    for (auto const& entry : instanceIndex)
+        instances.push_back(entry.first);
+    sort(instances.begin(), instances.end(), naturalLess);
+    for (int i = 0; i < (int)instances.size(); ++i)
+        instanceIndex[instances[i]] = i;
+    for (std::size_t s = 0; s < solutions.size(); ++s)
+        solutions[s].instance = instanceIndex[solutionInstances[s]];
+    cout << solutions.size() << " solutions of " << algorithms.size() << " algorithms on "
+         << instances.size() << " instances, " << numThreads << " threads" << endl;
+    if (solutions.empty())
+        return 0;
+
+    WorkStealingPool pool(numThreads);
+
+    //
+    // Load the instances
+    //
+    vector<boost::shared_ptr<ITC2007TestSet> > testSets(instances.size());
+    vector<string> instanceErrors(instances.size());
+    pool.parallelFor(instances.size(), [&](unsigned _i, unsigned) {
+        try {
+            testSets[_i] = ITC2007TestSet::loadInstance(testBenchmarksDir, instances[_i]);
+        }
+        catch (runtime_error const& e) {
+            instanceErrors[_i] = e.what();
+        }
+    });
+
+    //
+    // Re-evaluate the solutions
+    //
+    pool.parallelFor(solutions.size(), [&](unsigned _s, unsigned) {
+        SolutionFile& solution = solutions[_s];
+        if (!testSets[solution.instance]) {
+            solution.error = solution.filename + ": instance " + instances[solution.instance] + ": "
+                    + instanceErrors[solution.instance];
+            return;
+        }
+        try {
+            ETTPSolutionInit<eoChromosome> init(testSets[solution.instance]->getTimetableProblemData().get(),
+                                                solution.filename);
+            eoChromosome chrom;
+            init(chrom);
+            solution.cost = chrom.getSolutionCost();
+            solution.feasible = true;
+        }
+        catch (runtime_error const& e) {
+            solution.error = e.what();
+        }
+    });
+    for (auto const& solution : solutions) {
+        if (!solution.feasible)
+            cerr << solution.error << endl;
+    }
+
+    //
+    // Aggregate the results of each algorithm on each instance
+    //
+    vector<vector<vector<long> > > costs(algorithms.size(), vector<vector<long> >(instances.size()));
+    vector<vector<Aggregate> > aggregates(algorithms.size(), vector<Aggregate>(instances.size()));
+    for (auto const& solution : solutions) {
+        ++aggregates[solution.algorithm][solution.instance].numRuns;
+        if (solution.feasible)
+            costs[solution.algorithm][solution.instance].push_back(solution.cost);
+    }
+    cout << endl << left << setw(24) << "Algorithm" << setw(12) << "Instance" << right
+         << setw(6) << "Runs" << setw(10) << "Feasible" << setw(10) << "Best"
+         << setw(14) << "Mean" << setw(12) << "Std dev" << endl;
+    cout << fixed << setprecision(1);
+    for (int a = 0; a < (int)algorithms.size(); ++a) {
+        for (int i = 0; i < (int)instances.size(); ++i) {
+            Aggregate& aggregate = aggregates[a][i];
+            vector<long> const& instanceCosts = costs[a][i];
+            aggregate.numFeasible = instanceCosts.size();
+            aggregate.best = 0;
+            aggregate.mean = aggregate.stdDev = NAN;
+            if (!instanceCosts.empty()) {
+                aggregate.best = *min_element(instanceCosts.begin(), instanceCosts.end());
+                double sum = 0, sumSquares = 0;
+                for (long cost : instanceCosts) {
+                    sum += cost;
+                    sumSquares += (double)cost*cost;
+                }
+                double n = instanceCosts.size();
+                aggregate.mean = sum / n;
+                aggregate.stdDev = (n > 1) ? sqrt(max(0.0, (sumSquares - sum*sum/n) / (n-1))) : 0.0;
+            }
+            if (aggregate.numRuns == 0)
+                continue;
+            cout << left << setw(24) << algorithms[a] << setw(12) << instances[i] << right
+                 << setw(6) << aggregate.numRuns << setw(10) << aggregate.numFeasible << setw(10)
+                 << aggregate.best << setw(14) << aggregate.mean << setw(12) << aggregate.stdDev << endl;
+        }
+    }
+
+    //
+    // Friedman test on the average costs. An algorithm without feasible solutions on
+    // an instance is ranked last there; instances some algorithm wasn't run on are left out.
+    //
+    vector<vector<double> > results;
+    vector<int> rankedInstances;
+    for (int i = 0; i < (int)instances.size(); ++i) {
+        vector<double> instanceResults;
+        bool complete = true;
+        for (int a = 0; a < (int)algorithms.size(); ++a) {
+            complete = complete && aggregates[a][i].numRuns > 0;
+            instanceResults.push_back(aggregates[a][i].numFeasible > 0 ? aggregates[a][i].mean : INFINITY);
+        }
+        if (complete) {
+            results.push_back(instanceResults);
+            rankedInstances.push_back(i);
+        }
+        else
+            cerr << "Instance " << instances[i] << " left out of the ranking: not run by every algorithm" << endl;
+    }
+    if (algorithms.size() >= 2 && !results.empty()) {
+        FriedmanTest friedman(results);
+        cout << endl << "Average rankings (" << results.size() << " instances)" << endl;
+        cout << setprecision(4);
+        for (int a = 0; a < (int)algorithms.size(); ++a)
+            cout << left << setw(24) << algorithms[a] << right << setw(10) << friedman.getAverageRanks()[a] << endl;
+        cout << endl << scientific << setprecision(6);
+        cout << "Friedman statistic (chi-square with " << algorithms.size()-1 << " degrees of freedom) = "
+             << friedman.getStatistic() << ", p-value = " << friedman.getPValue() << endl;
+        cout << "Iman-Davenport statistic (F with " << algorithms.size()-1 << " and "
+             << (algorithms.size()-1)*(results.size()-1) << " degrees of freedom) = "
+             << friedman.getImanDavenportStatistic() << ", p-value = " << friedman.getImanDavenportPValue() << endl;
+        cout << endl << "Holm's procedure, control algorithm " << algorithms[friedman.getControl()]
+             << ", alpha = 0.05" << endl;
+        cout << left << setw(24) << "Algorithm" << right << setw(14) << "z" << setw(14) << "p"
+             << setw(14) << "Holm alpha" << setw(14) << "Holm APV" << setw(10) << "Rejected" << endl;
+        for (auto const& comparison : friedman.getComparisons()) {
+            cout << left << setw(24) << algorithms[comparison.algorithm] << right
+                 << setw(14) << comparison.z << setw(14) << comparison.p << setw(14) << comparison.alpha
+                 << setw(14) << comparison.adjustedP << setw(10) << (comparison.rejected ? "yes" : "no") << endl;
+        }
+    }
+
+    //
+    // CSV of the average costs, in the input format of Rankings/multipleTest
+    // (values are negated, that tool ranks the highest value first)
+    //
+    if (!csvFilename.empty()) {
+        ofstream csvFile(csvFilename);
+        csvFile << "Instance";
+        for (auto const& algorithm : algorithms)
+            csvFile << "," << algorithm;
+        csvFile << endl << fixed << setprecision(1);
+        for (std::size_t r = 0; r < results.size(); ++r) {
+            csvFile << instances[rankedInstances[r]];
+            for (double result : results[r])
+                csvFile << "," << -result;
+            csvFile << endl;
+        }
+    }
+
+    auto finish = chrono::high_resolution_clock::now();
+    cout << endl << fixed << setprecision(3) << "Seconds elapsed = "
+         << chrono::duration<double>(finish - start).count() << endl;
+    return 0;
+}
@@ -0,0 +1,443 @@
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <stdlib.h>
+#include <unistd.h>
+#include <boost/shared_ptr.hpp>
+#include <utils/eoRNG.h>
+#include "chromosome/eoChromosome.h"
+#include "testset/ITC2007TestSet.h"
+#include "init/ETTPSolutionInit.h"
+#include "graphColouring/GraphColouringHeuristics.h"
+#include "kempeChain/ETTPKempeChainHeuristic.h"
+#include "neighbourhood/ETTPneighbor.h"
+#include "neighbourhood/ETTPneighborhood.h"
+#include "neighbourhood/statistics/ETTPneighborEvalNumEvalsCounter.h"
+#include "eval/eoNumberEvalsCounter.h"
+#include "eval/eoETTPEvalNumberEvalsCounter.h"
+#include "algorithms/mo/moTA.h"
+#include "algorithms/mo/moSimpleCoolingSchedule.h"
+#include "statistics/optimised/ExamMoveStatisticsOpt.h"
+
+using namespace std;
+
+
+//
+// Performance regression runs of TA and FastTA on the ITC2007 instances.
+//
+// Each variant of the published results (RUNS/TA, RUNS/FastTA80, RUNS/FastTA100) is run on
+// each instance from a fixed seed with a fixed cooling schedule, which fixes the # TA
+// iterations, and the search time, the # evaluations per second and the final cost are
+// recorded in a CSV file. Given the CSV file of a previous build, the run fails when the
+// throughput drops or the cost rises beyond a tolerance. Given the RUNS directory, the gap
+// to the mean cost of the published solutions of the variant is reported, and checked
+// when a gap tolerance is set (meaningful with the cooling schedule of the published runs).
+//
+
+
+typedef chrono::steady_clock Clock;
+
+
+/**
+ * @brief The Variant struct. Algorithm variant of the published results
+ */
+struct Variant {
+    char const *name;
+    // FastTA, with the fraction of the exams, by decreasing conflict degree, that can be fixed
+    bool fast;
+    double highDegreeExamFraction;
+};
+
+const Variant variants[] = {
+    { "TA", false, 0 },
+    { "FastTA80", true, 0.8 },
+    { "FastTA100", true, 1 }
+};
+
+// Default cooling schedule (Sch #1 with alpha = 0.001): about 43k iterations
+const double defaultInitT = 0.1, defaultAlpha = 0.001, defaultSpan = 5, defaultFinalT = 2e-5;
+// FastTA threshold bins, as in MainApp
+const int numBins = 10;
+
+
+/**
+ * @brief The Result struct. Result of one variant on one instance
+ */
+struct Result {
+    string instance;
+    string variant;
+    uint32_t seed;
+    double initT;
+    double alpha;
+    double span;
+    double finalT;
+    long evaluations;
+    // Search time, fastest repetition
+    double seconds;
+    double evalsPerSecond;
+    long cost;
+};
+
+
+/**
+ * @brief split
+ * @param _line
+ * @param _separator
+ * @return Fields of _line
+ */
+vector<string> split(string const& _line, char _separator) {
+    vector<string> fields;
+    stringstream sstream(_line);
+    string field;
+    while (getline(sstream, field, _separator))
+        fields.push_back(field);
+    return fields;
+}
+
+
+/**
+ * @brief readBaseline Read the results of a previous run
+ * @param _filename CSV file written by a previous run
+ * @return Results by instance and variant
+ */
+map<pair<string, string>, Result> readBaseline(string const& _filename) {
+    ifstream file(_filename);
+    if (!file)
+        throw runtime_error("Couldn't open baseline file: " + _filename);
+    map<pair<string, string>, Result> baseline;
+    string line;
+    getline(file, line); // Header
+    while (getline(file, line)) {
+        // instance,variant,seed,initT,alpha,span,finalT,evaluations,seconds,evals_per_second,cost,...
+        vector<string> fields = split(line, ',');
+        if (fields.size() < 11)
+            throw runtime_error(_filename + ": malformed line: " + line);
+        Result result;
+        result.instance = fields[0];
+        result.variant = fields[1];
+        result.seed = strtoul(fields[2].c_str(), nullptr, 10);
+        result.initT = atof(fields[3].c_str());
+        result.alpha = atof(fields[4].c_str());
+        result.span = atof(fields[5].c_str());
+        result.finalT = atof(fields[6].c_str());
+        result.evaluations = atol(fields[7].c_str());
+        result.seconds = atof(fields[8].c_str());
+        result.evalsPerSecond = atof(fields[9].c_str());
+        result.cost = atol(fields[10].c_str());
+        baseline[make_pair(result.instance, result.variant)] = result;
+    }
+    return baseline;
+}
+
+
+/**
+ * @brief publishedMeanCost Re-evaluate the published solutions of a variant on an instance
+ * @param _data Instance
+ * @param _variantDir Results of the variant, e.g. RUNS/TA, holding Run1/set1.sln, ...
+ * @param _instance
+ * @param _numSolutions Receives the # solutions found
+ * @return Mean cost of the solutions, NAN if there are none
+ */
+double publishedMeanCost(TimetableProblemData const *_data, string const& _variantDir, string const& _instance,
+                         int& _numSolutions) {
+    _numSolutions = 0;
+    double sum = 0;
+    for (int run = 1; ; ++run) {
+        string runDir = _variantDir + "/Run" + to_string(run);
+        if (access(runDir.c_str(), F_OK) != 0)
+            break;
+        string filename = runDir + "/" + _instance + ".sln";
+        if (access(filename.c_str(), R_OK) != 0)
+            continue;
+        ETTPSolutionInit<eoChromosome> init(_data, filename);
+        eoChromosome solution;
+        init(solution);
+        sum += solution.getSolutionCost();
+        ++_numSolutions;
+    }
+    return (_numSolutions > 0) ? sum / _numSolutions : NAN;
+}
+
+
+/**
+ * @brief The CoutSilencer struct. Discards what is written to cout during its lifetime:
+ * FastTA reports its progress on cout
+ */
+struct CoutSilencer {
+    ostringstream discarded;
+    streambuf *buffer;
+
+    CoutSilencer() : buffer(cout.rdbuf(discarded.rdbuf())) { }
+    ~CoutSilencer() { cout.rdbuf(buffer); }
+};
+
+
+/**
+ * @brief runVariant Run a variant once from the seeded initial solution
+ * @param _testSet Instance
+ * @param _variant
+ * @param _result Run parameters; receives the # evaluations, the search time and the cost
+ * @param _workDir Directory of the FastTA statistics files
+ */
+void runVariant(ITC2007TestSet const& _testSet, Variant const& _variant, Result& _result, string const& _workDir) {
+    TimetableProblemData const *data = _testSet.getTimetableProblemData().get();
+    // The whole run draws from the global generators, reseeded with the run seed
+    rng.reseed(_result.seed);
+    srand(_result.seed);
+    // Initial solution
+    eoChromosome solution;
+    solution.setTimetableProblemData(data);
+    GCHeuristics<eoChromosome>::saturationDegree(data, solution, rng);
+    if (!solution.isFeasible())
+        throw runtime_error("no feasible initial solution");
+    eoNumberEvalsCounter numEvalsCounter;
+    eoETTPEvalNumberEvalsCounter<eoChromosome> fullEval(numEvalsCounter);
+    fullEval(solution);
+    moSimpleCoolingSchedule<eoChromosome> coolSchedule(_result.initT, _result.alpha, _result.span, _result.finalT);
+    Clock::time_point start;
+    if (_variant.fast) {
+        CoutSilencer silencer;
+        ExamMoveStatisticsOpt fastTA(_testSet, _workDir, numBins, coolSchedule, _variant.highDegreeExamFraction);
+        // Setup, not timed as in ExamMoveStatisticsOpt::run
+        fastTA.generateThresholds();
+        fastTA.determineExamsColorDegree();
+        start = Clock::now();
+        _result.evaluations = fastTA.search(solution);
+    }
+    else {
+        boost::shared_ptr<ETTPKempeChainHeuristic<eoChromosome> > kempeChainHeuristic(
+                    new ETTPKempeChainHeuristic<eoChromosome>(rng));
+        ETTPneighborhood<eoChromosome> neighborhood(kempeChainHeuristic);
+        ETTPneighborEvalNumEvalsCounter<eoChromosome> neighEval(numEvalsCounter);
+        moTA<ETTPneighbor<eoChromosome> > ta(neighborhood, fullEval, neighEval, coolSchedule);
+        long initialEvaluations = numEvalsCounter.getTotalNumEvals();
+        start = Clock::now();
+        ta(solution);
+        _result.evaluations = numEvalsCounter.getTotalNumEvals() - initialEvaluations;
+    }
+    _result.seconds = chrono::duration<double>(Clock::now() - start).count();
+    _result.cost = solution.getSolutionCost();
+}
+
+
+
+int main(int argc, char* argv[])
+{
+    vector<Variant> selectedVariants(begin(variants), end(variants));
+    uint32_t seed = 1;
+    double initT = defaultInitT, alpha = defaultAlpha, span = defaultSpan, finalT = defaultFinalT;
+    int numRepetitions = 3;
+    string csvFilename, baselineFilename, runsDir, workDir = ".";
+    double throughputTolerance = 0.1, costTolerance = 0.05, gapTolerance = NAN;
+    int option;
+    try {
+        while ((option = getopt(argc, argv, "v:s:c:n:o:b:r:t:q:g:w:")) != -1) {
+            switch (option) {
+            case 'v':
+                selectedVariants.clear();
+                for (auto const& name : split(optarg, ',')) {
+                    auto it = find_if(begin(variants), end(variants),
+                                      [&name](Variant const& _variant) { return name == _variant.name; });
+                    if (it == end(variants))
+                        throw runtime_error("unknown variant: " + name);
+                    selectedVariants.push_back(*it);
+                }
+                break;
+            case 's':
+                seed = strtoul(optarg, nullptr, 10);
+                break;
+            case 'c': {
+                vector<string> fields = split(optarg, ',');
+                if (fields.size() != 4)
+                    throw runtime_error("expected initT,alpha,span,finalT: " + string(optarg));
+                initT = atof(fields[0].c_str());
+                alpha = atof(fields[1].c_str());
+                span = atof(fields[2].c_str());
+                finalT = atof(fields[3].c_str());
+                if (initT <= 0 || alpha <= 0 || span < 1 || finalT <= 0 || finalT >= initT)
+                    throw runtime_error("invalid cooling schedule: " + string(optarg));
+                break;
+            }
+            case 'n':
+                numRepetitions = max(1, atoi(optarg));
+                break;
+            case 'o':
+                csvFilename = optarg;
+                break;
+            case 'b':
+                baselineFilename = optarg;
+                break;
+            case 'r':
+                runsDir = optarg;
+                break;
+            case 't':
+                throughputTolerance = atof(optarg);
+                break;
+            case 'q':
+                costTolerance = atof(optarg);
+                break;
+            case 'g':
+                gapTolerance = atof(optarg);
+                break;
+            case 'w':
+                workDir = optarg;
+                break;
+            default:
+                argc = 0; // Print usage
+            }
+        }
+    }
+    catch (runtime_error const& e) {
+        cerr << e.what() << endl;
+        return -1;
+    }
+    if (optind >= argc) {
+        cout << "Usage: ./regressionRuns [options] <test benchmarks directory>   [instances...]" << endl;
+        cout << "   -v TA,FastTA80,FastTA100   Variants to run (default: all)" << endl;
+        cout << "   -s seed                    Seed of the runs (default 1)" << endl;
+        cout << "   -c initT,alpha,span,finalT Cooling schedule, fixing the # iterations (default "
+             << defaultInitT << "," << defaultAlpha << "," << defaultSpan << "," << defaultFinalT << ")" << endl;
+        cout << "   -n repetitions             Timing repetitions, the fastest is kept (default 3)" << endl;
+        cout << "   -o file                    Output CSV file, the baseline of later runs" << endl;
+        cout << "   -b file                    Baseline CSV file of a previous run" << endl;
+        cout << "   -t tolerance               Maximum drop of evaluations/s relative to the baseline (default 0.1)" << endl;
+        cout << "   -q tolerance               Maximum cost rise relative to the baseline (default 0.05)" << endl;
+        cout << "   -r directory               RUNS directory: report the gap to the published mean cost" << endl;
+        cout << "   -g tolerance               Maximum gap to the published mean cost (default: not checked)" << endl;
+        cout << "   -w directory               Directory of the FastTA statistics files (default .)" << endl;
+        cout << "   Example: ./regressionRuns -b baseline.csv -o current.csv -r ./../../RUNS ./../../ETTP-Benchmarks/ITC2007 set1 set4" << endl;
+        cout << "   By default the instances are set1 to set12. Exits with status 1 on a regression." << endl;
+        return -1;
+    }
+    // Get test benchmarks directory
+    string testBenchmarksDir = argv[optind];
+    // Get instances
+    vector<string> instances(argv + optind + 1, argv + argc);
+    if (instances.empty()) {
+        for (int i = 1; i <= 12; ++i)
+            instances.push_back("set" + to_string(i));
+    }
+
+    map<pair<string, string>, Result> baseline;
+    ofstream csvFile;
+    try {
+        if (!baselineFilename.empty())
+            baseline = readBaseline(baselineFilename);
+        if (!csvFilename.empty()) {
+            csvFile.open(csvFilename);
+            if (!csvFile)
+                throw runtime_error("Couldn't create output file: " + csvFilename);
+            csvFile << "instance,variant,seed,initT,alpha,span,finalT,evaluations,seconds,evals_per_second,cost,"
+                       "baseline_evals_per_second,baseline_cost,published_mean_cost,status" << endl;
+        }
+    }
+    catch (runtime_error const& e) {
+        cerr << e.what() << endl;
+        return -1;
+    }
+
+    cout << "Seed " << seed << ", cooling schedule " << initT << ", " << alpha << ", " << span << ", " << finalT
+         << ", " << numRepetitions << " repetitions" << endl;
+    cout << left << setw(10) << "Instance" << setw(11) << "Variant" << right << setw(12) << "Evals"
+         << setw(10) << "Seconds" << setw(12) << "Evals/s" << setw(10) << "Cost" << setw(10) << "vs base"
+         << setw(11) << "Base cost" << setw(12) << "Published" << setw(9) << "Gap" << "  Status" << endl;
+    int numRegressions = 0, numErrors = 0;
+    for (auto const& instance : instances) {
+        boost::shared_ptr<ITC2007TestSet> testSet;
+        try {
+            testSet = ITC2007TestSet::loadInstance(testBenchmarksDir, instance);
+        }
+        catch (runtime_error const& e) {
+            cerr << instance << ": " << e.what() << endl;
+            ++numErrors;
+            continue;
+        }
+        for (auto const& variant : selectedVariants) {
+            Result result = Result();
+            result.instance = instance;
+            result.variant = variant.name;
+            result.seed = seed;
+            result.initT = initT;
+            result.alpha = alpha;
+            result.span = span;
+            result.finalT = finalT;
+            double publishedMean = NAN;
+            try {
+                // Same seed, same run: keep the fastest repetition
+                double seconds = INFINITY;
+                for (int r = 0; r < numRepetitions; ++r) {
+                    long cost = result.cost, evaluations = result.evaluations;
+                    runVariant(*testSet, variant, result, workDir);
+                    if (r > 0 && (result.cost != cost || result.evaluations != evaluations))
+                        throw runtime_error("the run is not reproducible: repetitions differ");
+                    seconds = min(seconds, result.seconds);
+                }
+                result.seconds = seconds;
+                result.evalsPerSecond = result.evaluations / result.seconds;
+                if (!runsDir.empty()) {
+                    int numSolutions;
+                    publishedMean = publishedMeanCost(testSet->getTimetableProblemData().get(),
+                                                      runsDir + "/" + variant.name, instance, numSolutions);
+                }
+            }
+            catch (runtime_error const& e) {
+                cerr << instance << ", " << variant.name << ": " << e.what() << endl;
+                ++numErrors;
+                continue;
+            }
+
+            // Checks
+            string status = "ok";
+            double throughputRatio = NAN, baselineEvalsPerSecond = NAN, baselineCost = NAN;
+            auto it = baseline.find(make_pair(instance, string(variant.name)));
+            if (it != baseline.end()) {
+                Result const& base = it->second;
+                if (base.seed != seed || base.initT != initT || base.alpha != alpha || base.span != span ||
+                        base.finalT != finalT)
+                    status = "BASELINE MISMATCH";
+                else {
+                    baselineEvalsPerSecond = base.evalsPerSecond;
+                    baselineCost = base.cost;
+                    throughputRatio = result.evalsPerSecond / base.evalsPerSecond;
+                    if (throughputRatio < 1 - throughputTolerance)
+                        status = "SLOWER";
+                    if (result.cost > base.cost * (1 + costTolerance))
+                        status = (status == "ok") ? "WORSE COST" : status + ", WORSE COST";
+                }
+            }
+            else if (!baseline.empty())
+                status = "no baseline";
+            double gap = (result.cost - publishedMean) / publishedMean;
+            if (!std::isnan(gapTolerance) && !std::isnan(publishedMean) && gap > gapTolerance)
+                status = (status == "ok") ? "WORSE THAN PUBLISHED" : status + ", WORSE THAN PUBLISHED";
+            if (status != "ok" && status != "no baseline")
+                ++numRegressions;
+
+            cout << left << setw(10) << instance << setw(11) << variant.name << right << setw(12) << result.evaluations
+                 << fixed << setprecision(2) << setw(10) << result.seconds << setprecision(0) << setw(12)
+                 << result.evalsPerSecond << setw(10) << result.cost << setprecision(3) << setw(10) << throughputRatio
+                 << setprecision(0) << setw(11) << baselineCost << setprecision(1) << setw(12) << publishedMean
+                 << setw(8) << 100 * gap << "%  " << status << endl;
+            if (csvFile.is_open())
+                csvFile << setprecision(10) << instance << "," << variant.name << "," << seed << "," << initT << ","
+                        << alpha << "," << span << "," << finalT << "," << result.evaluations << "," << result.seconds << ","
+                        << fixed << setprecision(1) << result.evalsPerSecond << "," << result.cost
+                        << "," << baselineEvalsPerSecond << "," << setprecision(0) << baselineCost << ","
+                        << setprecision(1) << publishedMean << "," << status << endl;
+            cout.unsetf(ios::floatfield);
+            csvFile.unsetf(ios::floatfield);
+        }
+    }
+    cout << endl << numRegressions << " regressions, " << numErrors << " errors" << endl;
+    if (numErrors > 0)
+        return -1;
+    return (numRegressions > 0) ? 1 : 0;
+}
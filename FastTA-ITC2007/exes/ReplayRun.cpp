@@ -0,0 +1,139 @@
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <stdexcept>
+#include <boost/shared_ptr.hpp>
+#include <utils/eoRNG.h>
+#include "chromosome/eoChromosome.h"
+#include "testset/ITC2007TestSet.h"
+#include "graphColouring/GraphColouringHeuristics.h"
+#include "kempeChain/ETTPKempeChainHeuristic.h"
+#include "neighbourhood/ETTPneighbor.h"
+#include "neighbourhood/ETTPneighborhood.h"
+#include "neighbourhood/statistics/ETTPneighborEvalNumEvalsCounter.h"
+#include "eval/eoNumberEvalsCounter.h"
+#include "eval/eoETTPEvalNumberEvalsCounter.h"
+#include "algorithms/mo/moTA.h"
+#include "algorithms/mo/moSA.h"
+#include "algorithms/mo/moSimpleCoolingSchedule.h"
+#include "utils/MoveLog.h"
+
+using namespace std;
+
+
+//
+// Deterministic record and replay of a seeded TA or SA run.
+//
+// "record" runs the search from a fixed seed and logs every iteration (move built, neighbour
+// cost, outcome) to a move log. "replay" repeats the run described by the log, typically
+// with a later build, and reports the first iteration where the trajectory diverges. The
+// whole run draws from the global generator rng, reseeded with the run seed: the initial
+// solution, the Kempe chain moves and the SA acceptance test.
+//
+
+
+// Default cooling schedule (Sch #1)
+const double defaultInitT = 0.1, defaultAlpha = 0.001, defaultSpan = 5, defaultFinalT = 2e-5;
+
+
+/**
+ * @brief runSearch Run the search described by the log, recording or replaying its moves
+ * @param _data Instance
+ * @param _moveLog
+ * @return Final solution cost
+ */
+long runSearch(TimetableProblemData const *_data, MoveLog& _moveLog) {
+    MoveLog::RunInfo const& runInfo = _moveLog.getRunInfo();
+    rng.reseed(static_cast<uint32_t>(runInfo.seed));
+    // Initial solution
+    eoChromosome solution;
+    solution.setTimetableProblemData(_data);
+    GCHeuristics<eoChromosome>::saturationDegree(_data, solution, rng);
+    eoNumberEvalsCounter numEvalsCounter;
+    eoETTPEvalNumberEvalsCounter<eoChromosome> fullEval(numEvalsCounter);
+    fullEval(solution);
+    // Local search
+    moSimpleCoolingSchedule<eoChromosome> coolSchedule(runInfo.initT, runInfo.alpha, runInfo.span, runInfo.finalT);
+    boost::shared_ptr<ETTPKempeChainHeuristic<eoChromosome> > kempeChainHeuristic(
+                new ETTPKempeChainHeuristic<eoChromosome>(rng));
+    ETTPneighborhood<eoChromosome> neighborhood(kempeChainHeuristic);
+    ETTPneighborEvalNumEvalsCounter<eoChromosome> neighEval(numEvalsCounter);
+    if (strcmp(runInfo.algorithm, "TA") == 0) {
+        moTA<ETTPneighbor<eoChromosome> > ta(neighborhood, fullEval, neighEval, coolSchedule);
+        ta.setMoveLog(&_moveLog);
+        ta(solution);
+    }
+    else if (strcmp(runInfo.algorithm, "SA") == 0) {
+        moSA<ETTPneighbor<eoChromosome> > sa(neighborhood, fullEval, neighEval, coolSchedule);
+        sa.setMoveLog(&_moveLog);
+        sa(solution);
+    }
+    else
+        throw runtime_error(string("unknown algorithm: ") + runInfo.algorithm);
+    return solution.getSolutionCost();
+}
+
+
+
+int main(int argc, char* argv[])
+{
+    string mode = (argc > 1) ? argv[1] : "";
+    // The cooling schedule is given in full or not at all
+    bool recordArgs = (argc >= 5 && argc <= 7) || argc == 11;
+    if (!((mode == "record" && recordArgs) || (mode == "replay" && argc >= 4))) {
+        cout << "Usage: ./replayRun record <test benchmarks directory> <instance> <move log>   [TA|SA]   [seed]   "
+                "[initT alpha span finalT]" << endl;
+        cout << "       ./replayRun replay <test benchmarks directory> <move log>" << endl;
+        cout << "   Example: ./replayRun record ./../../ETTP-Benchmarks/ITC2007 set4 set4_TA.mlog TA 1" << endl;
+        cout << "            ./replayRun replay ./../../ETTP-Benchmarks/ITC2007 set4_TA.mlog" << endl;
+        cout << "   replay exits with status 1 if the run diverges from the log." << endl;
+        return -1;
+    }
+    string testBenchmarksDir = argv[2];
+    try {
+        if (mode == "record") {
+            string instance = argv[3];
+            string moveLogFilename = argv[4];
+            string algorithm = (argc > 5) ? argv[5] : "TA";
+            if (instance.size() >= sizeof(MoveLog::RunInfo::instance) ||
+                algorithm.size() >= sizeof(MoveLog::RunInfo::algorithm))
+                throw runtime_error("instance or algorithm name too long");
+            auto testSet = ITC2007TestSet::loadInstance(testBenchmarksDir, instance);
+            MoveLog::RunInfo runInfo;
+            memset(&runInfo, 0, sizeof(runInfo));
+            runInfo.seed = (argc > 6) ? strtoull(argv[6], nullptr, 10) : 1;
+            runInfo.instanceHash = testSet->getTimetableProblemData()->getInstanceHash();
+            runInfo.initT = (argc > 10) ? atof(argv[7]) : defaultInitT;
+            runInfo.alpha = (argc > 10) ? atof(argv[8]) : defaultAlpha;
+            runInfo.span = (argc > 10) ? atof(argv[9]) : defaultSpan;
+            runInfo.finalT = (argc > 10) ? atof(argv[10]) : defaultFinalT;
+            strcpy(runInfo.algorithm, algorithm.c_str());
+            strcpy(runInfo.instance, instance.c_str());
+            MoveLog moveLog(moveLogFilename, runInfo);
+            long cost = runSearch(testSet->getTimetableProblemData().get(), moveLog);
+            cout << algorithm << " " << instance << ", seed " << runInfo.seed << ": " << moveLog.getNumMoves()
+                 << " iterations recorded to " << moveLogFilename << ", final cost " << cost << endl;
+            return 0;
+        }
+        else {
+            string moveLogFilename = argv[3];
+            MoveLog moveLog(moveLogFilename);
+            MoveLog::RunInfo const& runInfo = moveLog.getRunInfo();
+            auto testSet = ITC2007TestSet::loadInstance(testBenchmarksDir, runInfo.instance);
+            if (testSet->getTimetableProblemData()->getInstanceHash() != runInfo.instanceHash)
+                throw runtime_error(string(runInfo.instance) + ": the instance differs from the recorded one");
+            cout << runInfo.algorithm << " " << runInfo.instance << ", seed " << runInfo.seed << ", cooling schedule "
+                 << runInfo.initT << ", " << runInfo.alpha << ", " << runInfo.span << ", " << runInfo.finalT
+                 << ", " << moveLog.getNumRecords() << " iterations logged" << endl;
+            long cost = runSearch(testSet->getTimetableProblemData().get(), moveLog);
+            cout << moveLog.getNumMoves() << " iterations replayed, final cost " << cost << endl;
+            moveLog.printDivergence(cout);
+            return moveLog.hasDiverged() ? 1 : 0;
+        }
+    }
+    catch (runtime_error const& e) {
+        cerr << e.what() << endl;
+        return -1;
+    }
+}
@@ -0,0 +1,41 @@
+#include <iostream>
+#include <string>
+#include <stdexcept>
+#include <stdlib.h>
+#include "testset/ITC2007TestSet.h"
+#include "validator/ExamValidator.h"
+
+using namespace std;
+
+
+//
+// Validate an ITC2007 examination track solution (.sln) against its instance (.exam):
+// prints the hard constraint violations and the soft cost components.
+// Exit status: 0 if the solution is feasible, 1 if it isn't, -1 on error.
+//
+int main(int argc, char* argv[])
+{
+    if (argc != 3) {
+        cout << "Usage: ./validateExam <instance file>   <solution file>" << endl;
+        cout << "   Example: ./validateExam ./../../ETTP-Benchmarks/ITC2007/exam_comp_set1.exam ./../../RUNS/TA/Run1/set1.sln" << endl;
+        return -1;
+    }
+    string instanceFilename = argv[1];
+    string solutionFilename = argv[2];
+    // Split the instance file name into directory and name, as expected by ITC2007TestSet
+    size_t slash = instanceFilename.find_last_of('/');
+    string rootDir = (slash == string::npos) ? "." : instanceFilename.substr(0, slash);
+    string name = (slash == string::npos) ? instanceFilename : instanceFilename.substr(slash+1);
+    try {
+        ITC2007TestSet testSet(name, name, rootDir);
+        testSet.load();
+        ExamValidator validator(testSet.getTimetableProblemData().get());
+        ExamValidator::Report report = validator.validate(solutionFilename);
+        ExamValidator::print(cout, report);
+        return report.isFeasible() ? 0 : 1;
+    }
+    catch (runtime_error const& e) {
+        cerr << e.what() << endl;
+        return -1;
+    }
+}
@@ -7,10 +7,17 @@
 #include <string>
 
 #include "validator/validator.h"
+#include "validator/ExamValidator.h"
 
 #include "testset/TestSetDescription.h"
 #include "testset/ITC2007TestSet.h"
 #include "init/ETTPInit.h"
+#include "init/ETTPSolutionInit.h"
+#include "chromosome/SolutionArchive.h"
+#include "algorithms/mo/moTACheckpoint.h"
+#include "utils/TraceSink.h"
+#include "utils/SearchTelemetry.h"
+#include "utils/PerfCounters.h"
 
 
 // For counting the # evaluations
@@ -33,6 +40,8 @@
 #include "algorithms/eo/eoGenerationContinue.h"
 #include "algorithms/mo/moSA.h"
 #include "algorithms/mo/moSAexplorer.h"
+#include "algorithms/mo/moTAParallelTempering.h"
+#include "algorithms/mo/moTASpeculative.h"
 
 #include "algorithms/eo/eoGenerationContinuePopVector.h"
 #include "eoSelectOne.h"
@@ -65,10 +74,23 @@ extern int getSANumberEvaluations(double tmax, double r, double k, double tmin);
 void generateExamMoveStatistics(const string &_outputDir, const TestSet &_testSet);
 
 void runTA(TestSet const& _testSet, string const& _outputDir,
-           moSimpleCoolingSchedule<eoChromosome> &_coolSchedule);
+           moSimpleCoolingSchedule<eoChromosome> &_coolSchedule,
+           string const& _initialSolutionFilename = "",
+           string const& _checkpointFilename = "", unsigned long _checkpointInterval = 1000000,
+           string const& _traceFilename = "");
 
 void runSA(TestSet const& _testSet, string const& _outputDir,
-           moSimpleCoolingSchedule<eoChromosome> &_coolSchedule);
+           moSimpleCoolingSchedule<eoChromosome> &_coolSchedule, string const& _traceFilename = "");
+
+void runTAParallelTempering(TestSet const& _testSet, string const& _outputDir,
+                            moSimpleCoolingSchedule<eoChromosome> &_coolSchedule,
+                            unsigned _numReplicas, unsigned long _exchangeInterval);
+
+void runTASpeculative(TestSet const& _testSet, string const& _outputDir,
+                      moSimpleCoolingSchedule<eoChromosome> &_coolSchedule, unsigned _numLanes);
+
+void archiveSolution(string const& _outputDir, string const& _algorithm, TestSet const& _testSet,
+                     eoChromosome const& _solution, uint64_t _seed, double _seconds, uint64_t _numEvals);
 
 
 
@@ -635,8 +657,36 @@ void generateExamMoveStatistics(string const& _outputDir, TestSet const& _testSe
 
 
 
+// Append _solution to the binary solution archive of _algorithm on _testSet,
+// <_outputDir>/<_algorithm>_<instance>.slnb, which accumulates the runs.
+void archiveSolution(string const& _outputDir, string const& _algorithm, TestSet const& _testSet,
+                     eoChromosome const& _solution, uint64_t _seed, double _seconds, uint64_t _numEvals) {
+    string archiveFilename = _outputDir + "/" + _algorithm + "_" + _testSet.getName() + SolutionArchive::getExtension();
+    try {
+        SolutionArchiveWriter archive(archiveFilename, _testSet.getTimetableProblemData().get(), _algorithm);
+        archive.append(_solution, _seed, _seconds, _numEvals);
+    }
+    catch (std::runtime_error const& e) {
+        cerr << e.what() << endl;
+    }
+}
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+
+// If _initialSolutionFilename is given, TA starts from that .sln solution, or from the
+// best solution of that .slnb archive (warm start) instead of a constructed one, at
+// threshold _coolSchedule.initT.
+// If _checkpointFilename is given, the search state is saved to that file every
+// _checkpointInterval iterations, and a run finding the file resumes from it.
+// If _traceFilename is given, a structured trace of the search (one record per threshold
+// change) is written to that file (CSV if it ends in .csv, JSON lines otherwise).
 void runTA(TestSet const& _testSet, string const& _outputDir,
-           moSimpleCoolingSchedule<eoChromosome> &_coolSchedule) {
+           moSimpleCoolingSchedule<eoChromosome> &_coolSchedule,
+           string const& _initialSolutionFilename,
+           string const& _checkpointFilename, unsigned long _checkpointInterval,
+           string const& _traceFilename) {
 
     // Creating the output filename
     stringstream sstream;
@@ -658,18 +708,51 @@ void runTA(TestSet const& _testSet, string const& _outputDir,
     // Print max # evaluations to file
     outFile << "numberEvaluations = " << maxNumEval << std::endl;
     ///////////////////////////////////////////////////////////
-    // Solution initializer
-    ETTPInit<eoChromosome> init(_testSet.getTimetableProblemData().get());
-    // Generate initial solution
-    eoChromosome initialSolution;
-    init(initialSolution);
     // # evaluations counter
     eoNumberEvalsCounter numEvalsCounter;
     // eoETTPEval used to evaluate the solutions; receives as argument an
     // eoNumberEvalsCounter for counting neigbour # evaluations
     eoETTPEvalNumberEvalsCounter<eoChromosome> fullEval(numEvalsCounter);
-    // Evaluate solution
-    fullEval(initialSolution);
+    eoChromosome initialSolution;
+    // Checkpoint: restore the search state of an interrupted run, if any
+    boost::shared_ptr<moTACheckpoint<ETTPneighbor<eoChromosome> > > checkpoint;
+    bool resumed = false;
+    if (!_checkpointFilename.empty()) {
+        checkpoint = boost::make_shared<moTACheckpoint<ETTPneighbor<eoChromosome> > >(
+                    _checkpointFilename, _checkpointInterval, _testSet.getTimetableProblemData().get(),
+                    _coolSchedule, numEvalsCounter);
+        resumed = checkpoint->resume(initialSolution);
+    }
+    // Seed of the run, recorded in the solution archive. The initialisation and the
+    // search draw from rng. A resumed run restores the generator state from the
+    // checkpoint instead, which doesn't keep the seed: 0 is recorded.
+    uint32_t seed = 0;
+    if (!resumed) {
+        seed = static_cast<uint32_t>(time(0));
+        rng.reseed(seed);
+        // Solution initializer: read the given solution, or build a new one
+        boost::shared_ptr<eoInit<eoChromosome> > init;
+        string extension = SolutionArchive::getExtension();
+        if (_initialSolutionFilename.empty())
+            init = boost::make_shared<ETTPInit<eoChromosome> >(_testSet.getTimetableProblemData().get(), rng);
+        else if (_initialSolutionFilename.size() > extension.size() &&
+                 _initialSolutionFilename.compare(_initialSolutionFilename.size()-extension.size(),
+                                                  extension.size(), extension) == 0) {
+            SolutionArchiveReader archive(_initialSolutionFilename);
+            if (archive.getNumRecords() == 0)
+                throw std::runtime_error(_initialSolutionFilename + ": empty solution archive");
+            init = boost::make_shared<ETTPSolutionInit<eoChromosome> >(_testSet.getTimetableProblemData().get(),
+                                                                       archive, archive.getBestRecord());
+        }
+        else
+            init = boost::make_shared<ETTPSolutionInit<eoChromosome> >(_testSet.getTimetableProblemData().get(),
+                                                                       _initialSolutionFilename);
+        ETTP_PERF_SCOPE(Init);
+        // Generate initial solution
+        (*init)(initialSolution);
+        // Evaluate solution
+        fullEval(initialSolution);
+    }
 
     //
     // Local search used: Threshold Accepting algorithm
@@ -683,6 +766,20 @@ void runTA(TestSet const& _testSet, string const& _outputDir,
     ETTPneighborEvalNumEvalsCounter<eoChromosome> neighEval(numEvalsCounter);
 
     moTA<ETTPneighbor<eoChromosome> > ta(neighborhood, fullEval, neighEval, _coolSchedule);
+    if (checkpoint)
+        ta.setContinuator(*checkpoint);
+    // Search trace, written by a background thread
+    boost::shared_ptr<TraceSink> trace;
+    if (!_traceFilename.empty()) {
+        trace = boost::make_shared<TraceSink>(_traceFilename);
+        ta.setTrace(trace.get());
+    }
+    // Search telemetry counters, compiled in with ETTP_TELEMETRY
+    SearchTelemetry telemetry;
+    if (SearchTelemetry::isEnabled()) {
+        kempeChainHeuristic->setTelemetry(&telemetry);
+        ta.setTelemetry(&telemetry);
+    }
 
     /////// Write to output File ///////////////////////////////////////////
     cout << "Start Date/Time = " << currentDateTime() << endl;
@@ -691,6 +788,10 @@ void runTA(TestSet const& _testSet, string const& _outputDir,
     outFile << "SA parameters:" << endl;
     outFile << "cooling schedule: " << _coolSchedule.initT << ", " << _coolSchedule.alpha << ", "
             << _coolSchedule.span << ", " << _coolSchedule.finalT << endl;
+    if (!_initialSolutionFilename.empty())
+        outFile << "initial solution: " << _initialSolutionFilename << endl;
+    if (resumed)
+        outFile << "resumed from checkpoint: " << _checkpointFilename << endl;
     outFile << _testSet << std::endl;
 
     /////////////////////////////////////////
@@ -702,8 +803,16 @@ void runTA(TestSet const& _testSet, string const& _outputDir,
 
     cout << "Before TA - initialSolution.fitness() = " << initialSolution.fitness() << endl;
 
-    // Apply TA to the solution
-    ta(initialSolution);
+    // Apply TA to the solution, unless the checkpoint was taken at the end of the search
+    if (!(resumed && checkpoint->isFinished()))
+        ta(initialSolution);
+    // TA ends at its current solution: report the best one, kept by the checkpoint across resumes
+    if (checkpoint) {
+        eoChromosome bestSolution;
+        checkpoint->getBestSolution(bestSolution);
+        if (bestSolution.fitness() < initialSolution.fitness())
+            initialSolution = bestSolution;
+    }
 
     // Validate solution
 //    initialSolution.validate();
@@ -718,6 +827,9 @@ void runTA(TestSet const& _testSet, string const& _outputDir,
     // Print real # evaluations performed
     std::cout << "# evaluations performed = " << numEvalsCounter.getTotalNumEvals() << std::endl;
     outFile << "# evaluations performed = " << numEvalsCounter.getTotalNumEvals() << endl;
+    // Check the incrementally computed solution with the independent validator
+    ExamValidator validator(_testSet.getTimetableProblemData().get());
+    outFile << "Validated = " << (validator.check(initialSolution, outFile) ? "yes" : "no") << endl;
     // Print solution timetable to file
     outFile << initialSolution << endl;
     outFile << "==============================================================" << endl;
@@ -733,6 +845,226 @@ void runTA(TestSet const& _testSet, string const& _outputDir,
     // Write to file
     outFile << "End Date/Time = " << currentDateTime() << endl;
     outFile << "Seconds elapsed = " << seconds << endl;
+    if (trace)
+        outFile << "trace: " << trace->getFilename() << ", " << trace->getNumDropped() << " records dropped" << endl;
+    if (SearchTelemetry::isEnabled()) {
+        telemetry.print(cout);
+        telemetry.print(outFile);
+    }
+    // Hardware counters per phase, if the run is profiled
+    if (PerfProfiler::getCurrent()) {
+        PerfProfiler::getCurrent()->print(cout);
+        PerfProfiler::getCurrent()->print(outFile);
+    }
+    // Add the solution to the solution archive
+    archiveSolution(_outputDir, "TA", _testSet, initialSolution, seed, seconds, numEvalsCounter.getTotalNumEvals());
+}
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+
+void runTAParallelTempering(TestSet const& _testSet, string const& _outputDir,
+                            moSimpleCoolingSchedule<eoChromosome> &_coolSchedule,
+                            unsigned _numReplicas, unsigned long _exchangeInterval) {
+
+    // Creating the output filename
+    stringstream sstream;
+    sstream << _outputDir << "/TAPT_" << _testSet.getName() << "_cool_"
+            << _coolSchedule.initT << "_" << _coolSchedule.alpha << "_"
+            << _coolSchedule.span << "_" << _coolSchedule.finalT
+            << "_R_" << _numReplicas << "_I_" << _exchangeInterval << ".txt";
+    string outFilename;
+    sstream >> outFilename;
+    std::cout << outFilename << std::endl;
+    // Output file
+    std::ofstream outFile(outFilename);
+    ///////////////////////////////////////////////////////////
+    long maxNumEval;
+    double tmax = _coolSchedule.initT, r = _coolSchedule.alpha,
+           k = _coolSchedule.span, tmin = _coolSchedule.finalT;
+    // max # evaluations. The replicas share the same budget as a single TA run.
+    maxNumEval = getSANumberEvaluations(tmax, r, k, tmin);
+    std::cout << "numberEvaluations = " << maxNumEval << std::endl;
+    // Print max # evaluations to file
+    outFile << "numberEvaluations = " << maxNumEval << std::endl;
+    ///////////////////////////////////////////////////////////
+    // Seed of the run, recorded in the solution archive. The initialisation and
+    // the search draw from rng.
+    uint32_t seed = static_cast<uint32_t>(time(0));
+    rng.reseed(seed);
+    // Solution initializer
+    ETTPInit<eoChromosome> init(_testSet.getTimetableProblemData().get(), rng);
+    // Generate initial solution
+    eoChromosome initialSolution;
+    init(initialSolution);
+    // # evaluations counter
+    eoNumberEvalsCounter numEvalsCounter;
+    // eoETTPEval used to evaluate the solutions; receives as argument an
+    // eoNumberEvalsCounter for counting neigbour # evaluations
+    eoETTPEvalNumberEvalsCounter<eoChromosome> fullEval(numEvalsCounter);
+    // Evaluate solution
+    fullEval(initialSolution);
+
+    //
+    // Local search used: replica-exchange Threshold Accepting algorithm
+    //
+    moTAParallelTempering<eoChromosome> taPT(_coolSchedule, _numReplicas, _exchangeInterval,
+                                             maxNumEval, numEvalsCounter, rng.rand());
+
+    /////// Write to output File ///////////////////////////////////////////
+    cout << "Start Date/Time = " << currentDateTime() << endl;
+    // Write Start time and algorithm parameters to file
+    outFile << "Start Date/Time = " << currentDateTime() << endl;
+    outFile << "TA parallel tempering parameters:" << endl;
+    outFile << "cooling schedule: " << _coolSchedule.initT << ", " << _coolSchedule.alpha << ", "
+            << _coolSchedule.span << ", " << _coolSchedule.finalT << endl;
+    outFile << "# replicas = " << _numReplicas << ", exchange interval = " << _exchangeInterval << endl;
+    outFile << _testSet << std::endl;
+
+    /////////////////////////////////////////
+    // Get current time
+    time_t now;
+    double seconds = 0.0;
+    time(&now);  // get current time; same as: now = time(NULL)
+    /////////////////////////////////////////
+
+    cout << "Before TA - initialSolution.fitness() = " << initialSolution.fitness() << endl;
+
+    // Apply TA to the solution
+    taPT(initialSolution);
+
+    cout << "After TA - initialSolution.fitness() = " << initialSolution.fitness() << endl;
+    taPT.printExchangeStatistics(cout);
+
+    // Write best solution to file
+    outFile << "==============================================================" << endl;
+    outFile << "Date/Time = " << currentDateTime() << endl;
+    // Print solution fitness
+    outFile << "Solution fitness = " << initialSolution.fitness() << endl;
+    // Print real # evaluations performed
+    std::cout << "# evaluations performed = " << numEvalsCounter.getTotalNumEvals() << std::endl;
+    outFile << "# evaluations performed = " << numEvalsCounter.getTotalNumEvals() << endl;
+    taPT.printExchangeStatistics(outFile);
+    // Print solution timetable to file
+    outFile << initialSolution << endl;
+    outFile << "==============================================================" << endl;
+    /////////////////////////////////////////
+    // Get current time
+    time_t final;
+    time(&final);  // get current time
+    // Get difference in seconds
+    seconds = difftime(final, now);
+    /////////////////////////////////////////
+    cout << "End Date/Time = " << currentDateTime() << endl;
+    cout << "Seconds elapsed = " << seconds << endl;
+    // Write to file
+    outFile << "End Date/Time = " << currentDateTime() << endl;
+    outFile << "Seconds elapsed = " << seconds << endl;
+    // Add the solution to the solution archive
+    archiveSolution(_outputDir, "TAPT", _testSet, initialSolution, seed, seconds, numEvalsCounter.getTotalNumEvals());
+}
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+
+void runTASpeculative(TestSet const& _testSet, string const& _outputDir,
+                      moSimpleCoolingSchedule<eoChromosome> &_coolSchedule, unsigned _numLanes) {
+
+    // Creating the output filename
+    stringstream sstream;
+    sstream << _outputDir << "/TASpec_" << _testSet.getName() << "_cool_"
+            << _coolSchedule.initT << "_" << _coolSchedule.alpha << "_"
+            << _coolSchedule.span << "_" << _coolSchedule.finalT << "_K_" << _numLanes << ".txt";
+    string outFilename;
+    sstream >> outFilename;
+    std::cout << outFilename << std::endl;
+    // Output file
+    std::ofstream outFile(outFilename);
+    ///////////////////////////////////////////////////////////
+    long maxNumEval;
+    double tmax = _coolSchedule.initT, r = _coolSchedule.alpha,
+           k = _coolSchedule.span, tmin = _coolSchedule.finalT;
+    // max # evaluations
+    maxNumEval = getSANumberEvaluations(tmax, r, k, tmin);
+    std::cout << "numberEvaluations = " << maxNumEval << std::endl;
+    // Print max # evaluations to file
+    outFile << "numberEvaluations = " << maxNumEval << std::endl;
+    ///////////////////////////////////////////////////////////
+    // Seed of the run, recorded in the solution archive. The initialisation and
+    // the search draw from rng.
+    uint32_t seed = static_cast<uint32_t>(time(0));
+    rng.reseed(seed);
+    // Solution initializer
+    ETTPInit<eoChromosome> init(_testSet.getTimetableProblemData().get(), rng);
+    // Generate initial solution
+    eoChromosome initialSolution;
+    init(initialSolution);
+    // # evaluations counter
+    eoNumberEvalsCounter numEvalsCounter;
+    // eoETTPEval used to evaluate the solutions; receives as argument an
+    // eoNumberEvalsCounter for counting neigbour # evaluations
+    eoETTPEvalNumberEvalsCounter<eoChromosome> fullEval(numEvalsCounter);
+    // Evaluate solution
+    fullEval(initialSolution);
+
+    //
+    // Local search used: Threshold Accepting algorithm with speculative neighbour evaluation
+    //
+    moTASpeculative<eoChromosome> ta(fullEval, _coolSchedule, numEvalsCounter, _numLanes, rng.rand());
+
+    /////// Write to output File ///////////////////////////////////////////
+    cout << "Start Date/Time = " << currentDateTime() << endl;
+    // Write Start time and algorithm parameters to file
+    outFile << "Start Date/Time = " << currentDateTime() << endl;
+    outFile << "TA parameters:" << endl;
+    outFile << "cooling schedule: " << _coolSchedule.initT << ", " << _coolSchedule.alpha << ", "
+            << _coolSchedule.span << ", " << _coolSchedule.finalT << endl;
+    outFile << "# lanes = " << _numLanes << endl;
+    outFile << _testSet << std::endl;
+
+    /////////////////////////////////////////
+    // Get current time
+    time_t now;
+    double seconds = 0.0;
+    time(&now);  // get current time; same as: now = time(NULL)
+    /////////////////////////////////////////
+
+    cout << "Before TA - initialSolution.fitness() = " << initialSolution.fitness() << endl;
+
+    // Apply TA to the solution
+    ta(initialSolution);
+
+    cout << "After TA - initialSolution.fitness() = " << initialSolution.fitness() << endl;
+
+    // Write best solution to file
+    outFile << "==============================================================" << endl;
+    outFile << "Date/Time = " << currentDateTime() << endl;
+    // Print solution fitness
+    outFile << "Solution fitness = " << initialSolution.fitness() << endl;
+    // Print real # evaluations performed
+    std::cout << "# evaluations performed = " << numEvalsCounter.getTotalNumEvals()
+              << " (discarded = " << ta.getNumDiscarded() << ")" << std::endl;
+    outFile << "# evaluations performed = " << numEvalsCounter.getTotalNumEvals()
+            << " (discarded = " << ta.getNumDiscarded() << ")" << endl;
+    // Print solution timetable to file
+    outFile << initialSolution << endl;
+    outFile << "==============================================================" << endl;
+    /////////////////////////////////////////
+    // Get current time
+    time_t final;
+    time(&final);  // get current time
+    // Get difference in seconds
+    seconds = difftime(final, now);
+    /////////////////////////////////////////
+    cout << "End Date/Time = " << currentDateTime() << endl;
+    cout << "Seconds elapsed = " << seconds << endl;
+    // Write to file
+    outFile << "End Date/Time = " << currentDateTime() << endl;
+    outFile << "Seconds elapsed = " << seconds << endl;
+    // Add the solution to the solution archive
+    archiveSolution(_outputDir, "TASpec", _testSet, initialSolution, seed, seconds, numEvalsCounter.getTotalNumEvals());
 }
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -740,7 +1072,7 @@ void runTA(TestSet const& _testSet, string const& _outputDir,
 
 
 void runSA(TestSet const& _testSet, string const& _outputDir,
-           moSimpleCoolingSchedule<eoChromosome> &_coolSchedule) {
+           moSimpleCoolingSchedule<eoChromosome> &_coolSchedule, string const& _traceFilename) {
 
     // Creating the output filename
     stringstream sstream;
@@ -762,11 +1094,18 @@ void runSA(TestSet const& _testSet, string const& _outputDir,
     // Print max # evaluations to file
     outFile << "numberEvaluations = " << maxNumEval << std::endl;
     ///////////////////////////////////////////////////////////
+    // Seed of the run, recorded in the solution archive. The initialisation and
+    // the search draw from rng.
+    uint32_t seed = static_cast<uint32_t>(time(0));
+    rng.reseed(seed);
     // Solution initializer
-    ETTPInit<eoChromosome> init(_testSet.getTimetableProblemData().get());
+    ETTPInit<eoChromosome> init(_testSet.getTimetableProblemData().get(), rng);
     // Generate initial solution
     eoChromosome initialSolution;
-    init(initialSolution);
+    {
+        ETTP_PERF_SCOPE(Init);
+        init(initialSolution);
+    }
     // # evaluations counter
     eoNumberEvalsCounter numEvalsCounter;
     // eoETTPEval used to evaluate the solutions; receives as argument an
@@ -787,6 +1126,18 @@ void runSA(TestSet const& _testSet, string const& _outputDir,
     ETTPneighborEvalNumEvalsCounter<eoChromosome> neighEval(numEvalsCounter);
 
     moSA<ETTPneighbor<eoChromosome> > sa(neighborhood, fullEval, neighEval, _coolSchedule);
+    // Search trace, written by a background thread
+    boost::shared_ptr<TraceSink> trace;
+    if (!_traceFilename.empty()) {
+        trace = boost::make_shared<TraceSink>(_traceFilename);
+        sa.setTrace(trace.get());
+    }
+    // Search telemetry counters, compiled in with ETTP_TELEMETRY
+    SearchTelemetry telemetry;
+    if (SearchTelemetry::isEnabled()) {
+        kempeChainHeuristic->setTelemetry(&telemetry);
+        sa.setTelemetry(&telemetry);
+    }
 
     /////// Write to output File ///////////////////////////////////////////
     cout << "Start Date/Time = " << currentDateTime() << endl;
@@ -837,6 +1188,19 @@ void runSA(TestSet const& _testSet, string const& _outputDir,
     // Write to file
     outFile << "End Date/Time = " << currentDateTime() << endl;
     outFile << "Seconds elapsed = " << seconds << endl;
+    if (trace)
+        outFile << "trace: " << trace->getFilename() << ", " << trace->getNumDropped() << " records dropped" << endl;
+    if (SearchTelemetry::isEnabled()) {
+        telemetry.print(cout);
+        telemetry.print(outFile);
+    }
+    // Hardware counters per phase, if the run is profiled
+    if (PerfProfiler::getCurrent()) {
+        PerfProfiler::getCurrent()->print(cout);
+        PerfProfiler::getCurrent()->print(outFile);
+    }
+    // Add the solution to the solution archive
+    archiveSolution(_outputDir, "SA", _testSet, initialSolution, seed, seconds, numEvalsCounter.getTotalNumEvals());
 }
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -1062,11 +1426,23 @@ void runITC2007Datasets(int _datasetIndex, string const& _testBenchmarksDir, str
 //#endif
     // Iterator to test set
     vector<TestSetDescription>::iterator it = itc2007Benchmarks.begin() + _datasetIndex;
-    // Create TestSet instance
-    ITC2007TestSet testSet((*it).getName(), (*it).getDescription(), _testBenchmarksDir);
+    // Create TestSet instance. Runs share the preprocessed instance through the instance cache.
+    ITC2007TestSet testSet((*it).getName(), (*it).getDescription(), _testBenchmarksDir, true,
+                           std::thread::hardware_concurrency());
     // Load dataset
     ITC2007TestSet* ptr = &testSet;
-    ptr->load();
+    // Hardware counters per phase of the run, compiled in with ETTP_PERF_COUNTERS
+    boost::shared_ptr<PerfProfiler> profiler;
+    if (PerfProfiler::isEnabled()) {
+        profiler = boost::make_shared<PerfProfiler>();
+        if (!profiler->isAvailable())
+            profiler->print(cerr);
+    }
+    PerfProfiler::Activation profilerActivation(profiler.get());
+    {
+        ETTP_PERF_SCOPE(Load);
+        ptr->load();
+    }
 //#ifdef MAINAPP_DEBUG
 //    // Print testset info
 //    cout << testSet << endl;
@@ -17,6 +17,13 @@ class Mutation : public eoMonOp<EOT>
 
 public:
 
+    /**
+     * @brief Mutation Constructor
+     * @param _gen Random number generator used to build the Kempe chain moves. Threads
+     * mutating concurrently must each supply their own generator.
+     */
+    Mutation(eoRng &_gen = rng) : gen(_gen) { }
+
     /**
     * the class name (used to display statistics)
     */
@@ -27,6 +34,10 @@ public:
     * @param _chromosome the chromosome
     */
     bool operator()(EOT& _chromosome);
+
+private:
+    // Random number generator
+    eoRng &gen;
 };
 
 
@@ -163,7 +174,7 @@ bool Mutation<EOT>::operator()(EOT& _chrom)
 //    _chrom.validate();
 
 
-    ETTPKempeChainHeuristic<EOT> kempe;
+    ETTPKempeChainHeuristic<EOT> kempe(gen);
     kempe.build(_chrom);
     kempe.evaluateSolutionMove(_chrom);
     kempe(_chrom);
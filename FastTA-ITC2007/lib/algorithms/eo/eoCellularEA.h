@@ -2,6 +2,8 @@
 #define EOCELLULARGA_H
 
 #include <fstream>
+#include <string>
+#include <unordered_set>
 #include "algorithms/eo/eoGenerationContinuePopVector.h"
 #include <eoEvalFunc.h>
 #include <eoSelectOne.h>
@@ -16,7 +18,11 @@
 #include "algorithms/mo/moSimpleCoolingSchedule.h"
 #include "algorithms/mo/moTA.h"
 #include "eval/eoETTPEval.h"
+#include "eval/eoETTPEvalNumberEvalsCounter.h"
+#include "eval/eoShardedNumberEvalsCounter.h"
 #include "eval/eoNumberEvalsCounter.h"
+#include "utils/WorkStealingPool.h"
+#include "utils/MemoryAccounting.h"
 
 #include "utils/CurrentDateTime.h"
 #include <boost/make_shared.hpp>
@@ -34,6 +40,9 @@ namespace a = boost::accumulators;
 
 #define EOCELLULARGA_DEBUG
 
+// Print children fitness after local search (cells are processed concurrently)
+//#define EOCELLULARGA_DEBUG_TA
+
 
 /**
    The abstract cellular evolutionary algorithm.
@@ -61,7 +70,8 @@ public :
                  eoSelectOne<EOT> & _sel_child, // To choose one from the both children
                  eoSelectOne<EOT> & _sel_repl,   // Which to keep between the new
                                                  // child and the old individual?
-                 eoNumberEvalsCounter &_numEvalCounter // # evaluations counter
+                 eoNumberEvalsCounter &_numEvalCounter, // # evaluations counter
+                 unsigned _numThreads = 1 // # threads used to produce the generation offspring
                  ) :
         outFile(_outFile),
         nrows(_nrows), ncols(_ncols),
@@ -76,8 +86,14 @@ public :
         sel_repl(_sel_repl),
         bestSolution(nullptr),
         popVariance(0),
-        numEvalsCounter(_numEvalCounter)
-    { }
+        numEvalsCounter(_numEvalCounter),
+        pool(_numThreads),
+        localSearchNumEvals(pool.getNumThreads())
+    {
+        // One persistent search context per worker
+        for (unsigned w = 0; w < pool.getNumThreads(); ++w)
+            searchContexts.push_back(boost::make_shared<SearchContext>(coolSchedule, localSearchNumEvals.getShard(w)));
+    }
 
     /**
      *   Evolve a given population
@@ -108,8 +124,27 @@ public :
             // Get reference to original population
             std::vector<boost::shared_ptr<EOT> > &originalPop = *_pop.get();
 
-            // Produce the generation offspring
-            for (int i = 0; i < originalPop.size(); ++i) {
+            // Number of cells
+            unsigned popSize = originalPop.size();
+            // Cell children and their local search parameters
+            std::vector<boost::shared_ptr<EOT> > solCopies(popSize), parts(popSize);
+            // Children are shared with the previous generation until they are
+            // modified (copy-on-write). These flags indicate if they were copied.
+            // (char rather than bool: flags are written concurrently, one per cell)
+            std::vector<char> solCopyOwned(popSize), partOwned(popSize);
+            std::vector<bool> improve(popSize);
+            std::vector<uint32_t> seeds(popSize);
+            // Offspring population slots, one per cell
+            (*offspringPop.get()).resize(popSize);
+
+            //
+            // Variation. Done sequentially because the selection and variation
+            // operators draw from the global rng. The random choices of the
+            // local search stage (whether it is applied and its seed) are also
+            // drawn here, so the generation does not depend on the number of
+            // threads nor on the order in which cells are processed.
+            //
+            for (unsigned i = 0; i < popSize; ++i) {
                 // Who are neighbouring to the current individual?
                 //
                 // The neighbours method return a vector containing const pointers
@@ -119,59 +154,63 @@ public :
                 // cout << "Neighbours: " << endl;
                 // cout << "_pop[i].fitness() = " << _pop[i].fitness() << endl;
 
-                // Create, in the heap, object copies of current individual and its neighbour
-                boost::shared_ptr<EOT> solCopy(new EOT(*originalPop[i].get())); // Invoke the copy ctor
-                boost::shared_ptr<EOT> part(new EOT(*sel_neigh(neighs).get())); // Invoke the copy ctor
+                // Handles to the current individual and its partner. They are only
+                // copied, in the heap, before being modified.
+                solCopies[i] = originalPop[i];
+                parts[i] = sel_neigh(neighs);
+                solCopyOwned[i] = partOwned[i] = false;
 
                 // To perform cross-over
                 if (rng.uniform() < cp) {
+                    copyOnWrite(solCopies[i], solCopyOwned[i]);
+                    copyOnWrite(parts[i], partOwned[i]);
                     // Change the _pop[i] and part solutions directly
-                    cross(*solCopy.get(), *part.get());
+                    cross(*solCopies[i].get(), *parts[i].get());
                     // # evals statistics computation. Add 2 to # evals
                     numEvalsCounter.addNumEvalsToGenerationTotal(2);
                 }
                 // To perform mutation
                 if (rng.uniform() < mp) {
+                    copyOnWrite(solCopies[i], solCopyOwned[i]);
+                    copyOnWrite(parts[i], partOwned[i]);
                     // Change the solutions directly
-                    mut(*solCopy.get());
-                    mut(*part.get());
+                    mut(*solCopies[i].get());
+                    mut(*parts[i].get());
                     // # evals statistics computation. Add 2 to # evals
                     numEvalsCounter.addNumEvalsToGenerationTotal(2);
                 }
+                improve[i] = rng.uniform() < ip;
+                seeds[i] = rng.rand();
+            }
 
-                //
-                // Improvement by Local search.
-                // Local search used: Threshold Accepting algorithm
-                //
-                // moTA parameters
-                boost::shared_ptr<ETTPKempeChainHeuristic<EOT> > kempeChainHeuristic(new ETTPKempeChainHeuristic<EOT>());
-                ETTPneighborhood<EOT> neighborhood(kempeChainHeuristic);
-//                ETTPneighborEval<EOT> neighEval;
-                // ETTPneighborEvalWithStatistics which receives as argument an
-                // eoNumberEvalsCounter for counting neigbour # evaluations
-                ETTPneighborEvalNumEvalsCounter<EOT> neighEval(this->numEvalsCounter);
-                // Copy of cool schedule to use in TA solver
-                auto cool = coolSchedule;
-
-                moTA<ETTPneighbor<EOT> > ta(neighborhood, fullEval, neighEval, cool);
-
-                if (rng.uniform() < ip) {
+            //
+            // Improvement by Local search and replacement. Each cell only reads
+            // the previous generation and writes its own offspring slot, so cells
+            // are processed concurrently. Cell work is highly imbalanced (a full
+            // TA run or nothing), hence the work-stealing pool.
+            //
+            pool.parallelFor(popSize, [&](unsigned i, unsigned _worker) {
+                boost::shared_ptr<EOT> &solCopy = solCopies[i];
+                boost::shared_ptr<EOT> &part = parts[i];
+
+                if (improve[i]) {
+                    //
+                    // Local search used: Threshold Accepting algorithm, using
+                    // the worker search context
+                    //
+                    SearchContext &context = *searchContexts[_worker];
+                    // Random number generator of this cell
+                    context.gen.reseed(seeds[i]);
+                    copyOnWrite(solCopy, solCopyOwned[i]);
+                    copyOnWrite(part, partOwned[i]);
                     // Change the solutions directly
-                    ta(*solCopy.get());
-//                    std::cout << "After TA" << std::endl;
-//                    std::cout << "# evaluations generation: " << numEvalsCounter.getGenerationNumEvals()
-//                    << ", Total # evaluations: " << numEvalsCounter.getTotalNumEvals() << std::endl;
-
-                    ta(*part.get());
-//                    std::cout << "After TA" << std::endl;
-//                    std::cout << "# evaluations generation: " << numEvalsCounter.getGenerationNumEvals()
-//                    << ", Total # evaluations: " << numEvalsCounter.getTotalNumEvals() << std::endl;
-#ifdef EOCELLULARGA_DEBUG
+                    context.ta(*solCopy.get());
+                    context.ta(*part.get());
+#ifdef EOCELLULARGA_DEBUG_TA
                     std::cout << "After TA" << std::endl;
                     std::cout << "sol.fitness() = " << (*solCopy.get()).fitness() << std::endl;
                     std::cout << "part.fitness() = " << (*part.get()).fitness() << std::endl;
 #endif
-
                 }
 
                 // To choose the best of the two children
@@ -182,19 +221,27 @@ public :
                     offspringSol = part;
 
 
-                // To choose the best between the new made child and the old individual
+                // To choose the best between the new made child and the old individual.
+                // Individuals are never modified once in a population, so the old
+                // individual is shared rather than copied.
                 boost::shared_ptr<EOT> bestOffspringSol;
-                if ((*originalPop[i].get()).fitness() < (*offspringSol.get()).fitness()) {
-                    boost::shared_ptr<EOT> originalSol(new EOT(*originalPop[i].get())); // Invoke the copy ctor
-                    bestOffspringSol = originalSol;
-                }
+                if ((*originalPop[i].get()).fitness() < (*offspringSol.get()).fitness())
+                    bestOffspringSol = originalPop[i];
                 else
                     bestOffspringSol = offspringSol;
 
                 // Insert into the offspring vector
-                (*offspringPop.get()).push_back(bestOffspringSol);
+                (*offspringPop.get())[i] = bestOffspringSol;
+
+                // Release children
+                solCopy.reset();
+                part.reset();
+            });
 
-            } // End of generation
+            // Merge local search # evaluations
+            numEvalsCounter.addNumEvalsToTotal(localSearchNumEvals.getTotalNumEvals());
+            localSearchNumEvals.reset();
+            // End of generation
 
             // Swap offspring and original populations
             offspringPop.swap(_pop);
@@ -250,6 +297,9 @@ public :
             // Save best solution to file
             outFile << *getBestSolution() << std::endl;
             cout << "==============================================================" << std::endl;
+            // Population memory footprint
+            if (MemoryAccounting::isEnabled())
+                printPopulationMemory(finalPop);
             outFile << "==============================================================" << std::endl;
             ///////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -267,6 +317,10 @@ public :
         outFile << std::endl << "End of evolution cycle" << std::endl
                 << "Best solution: " << std::endl;
         outFile << *getBestSolution() << std::endl;
+        if (MemoryAccounting::isEnabled()) {
+            MemoryAccounting::printProcess(std::cout);
+            MemoryAccounting::printProcess(outFile);
+        }
     }
 
 
@@ -274,6 +328,64 @@ public :
 
 protected :
 
+    /**
+     * @brief The SearchContext struct. Local search objects of one worker,
+     * created once and reused for every cell the worker processes.
+     */
+    struct SearchContext {
+        SearchContext(moSimpleCoolingSchedule<EOT> const &_coolSchedule, eoNumberEvalsCounter &_numEvalsCounter)
+            : kempeChainHeuristic(new ETTPKempeChainHeuristic<EOT>(gen)),
+              neighborhood(kempeChainHeuristic),
+              neighEval(_numEvalsCounter),
+              fullEval(_numEvalsCounter),
+              cool(_coolSchedule),
+              ta(neighborhood, fullEval, neighEval, cool) { }
+
+        // Random number generator, reseeded for each cell
+        eoRng gen;
+        // moTA parameters
+        boost::shared_ptr<ETTPKempeChainHeuristic<EOT> > kempeChainHeuristic;
+        ETTPneighborhood<EOT> neighborhood;
+        ETTPneighborEvalNumEvalsCounter<EOT> neighEval;
+        eoETTPEvalNumberEvalsCounter<EOT> fullEval;
+        // Copy of cool schedule to use in TA solver. moTA resets it on each run.
+        moSimpleCoolingSchedule<EOT> cool;
+        moTA<ETTPneighbor<EOT> > ta;
+    };
+
+    /**
+     * @brief copyOnWrite Replace _sol by a private copy, if not already done
+     * @param _sol
+     * @param _owned
+     */
+    static void copyOnWrite(boost::shared_ptr<EOT> &_sol, char &_owned) {
+        if (!_owned) {
+            _sol = boost::make_shared<EOT>(*_sol.get()); // Invoke the copy ctor
+            _owned = true;
+        }
+    }
+
+    /**
+     * @brief printPopulationMemory Sample and print the current and peak population footprint.
+     * Individuals shared by several cells are counted once. The footprint of each individual
+     * is also updated in the memory accounting, as the local search grows its period vectors.
+     * @param _pop
+     */
+    void printPopulationMemory(std::vector<boost::shared_ptr<EOT> > &_pop) {
+        std::unordered_set<EOT const*> individuals;
+        MemoryAccounting::Footprint footprint;
+        for (auto &individual : _pop) {
+            if (individuals.insert(individual.get()).second) {
+                individual->updateMemoryAccounting();
+                individual->getMemoryFootprint(footprint);
+            }
+        }
+        populationMemory.sample(footprint);
+        std::string title = "Population memory (" + std::to_string(individuals.size()) + " individuals)";
+        populationMemory.print(std::cout, title);
+        populationMemory.print(outFile, title);
+    }
+
     virtual std::vector<boost::shared_ptr<EOT> > neighbours (
             const std::vector<boost::shared_ptr<EOT> > &_pop, int _rank) const = 0;
 
@@ -295,6 +407,10 @@ protected :
     boost::shared_ptr<EOT> bestSolution; // Reference to the best solution
     double popVariance; // Population variance
     eoNumberEvalsCounter &numEvalsCounter;
+    WorkStealingPool pool; // Thread pool used to produce the generation offspring
+    eoShardedNumberEvalsCounter localSearchNumEvals; // Local search # evaluations, one shard per worker
+    std::vector<boost::shared_ptr<SearchContext> > searchContexts; // Per-worker search contexts
+    MemoryAccounting::Tracker populationMemory; // Population footprint, sampled every generation
 };
 
 
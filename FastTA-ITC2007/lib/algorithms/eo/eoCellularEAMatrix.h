@@ -31,10 +31,12 @@ public :
                      eoMonOp<EOT> & _mut, // Mutation operator
                      eoSelectOne<EOT> & _sel_child, // To choose one from the both children
                      eoSelectOne<EOT> & _sel_repl,  // Which to keep between the new child and the old individual?
-                     eoNumberEvalsCounter &_numEvalCounter // # evaluations counter
+                     eoNumberEvalsCounter &_numEvalCounter, // # evaluations counter
+                     unsigned _numThreads = 1 // # threads used to produce the generation offspring
                     )
         : eoCellularEA<EOT>(_outFile, _nrows, _ncols, _cp, _mp, _ip, _coolSchedule,
-                            _cont, _eval, _sel_neigh, _cross, _mut, _sel_child, _sel_repl, _numEvalCounter)
+                            _cont, _eval, _sel_neigh, _cross, _mut, _sel_child, _sel_repl, _numEvalCounter,
+                            _numThreads)
   { }
 
     // Neighbouring of the current individual with rank _rank
@@ -15,6 +15,14 @@
 #include <boost/accumulators/statistics/variance.hpp>
 
 //#include "neighbourhood/statistics/ETTPneighborEvalWithStatistics.h"
+#include "eval/eoETTPEvalNumberEvalsCounter.h"
+#include "eval/eoNumberEvalsCounter.h"
+#include "eval/eoShardedNumberEvalsCounter.h"
+#include "utils/WorkStealingPool.h"
+#include "utils/MemoryAccounting.h"
+#include "init/ETTPBatchInit.h"
+#include <utils/eoRNG.h>
+#include "algorithms/eo/Mutation.h"
 //#include "statistics/ExamMoveStatistics.h"
 #include "algorithms/mo/statistics/moTAWithStatistics.h"
 //#include "neighbourhood/statistics/ETTPneighborhoodWithStatistics.h"
@@ -119,6 +127,11 @@ public:
      * @param _init - An eoInit that initializes each frog (solution)
      * @param _continuator - An eoContinue that manages the stopping criterion and the checkpointing system
      * @param _eval - An eoEvalFunc: the evaluation performer
+     * @param _numThreads - # threads building an empty initial population and evolving
+     *   the memeplexes. With more than one thread,
+     *   each memeplex is evolved with a private random number generator, evaluation
+     *   function (eoETTPEvalNumberEvalsCounter), whose evaluations are reported by
+     *   getNumEvalsCounter(), and Kempe chain mutation (Mutation) in place of _mut
      */
     eoSCEA<EOT>(TestSet const& _testSet, std::string const& _outputDir, int _numBins,
                 ofstream& _outFile, string const& _filename,
@@ -127,8 +140,10 @@ public:
                 eoInit<EOT>& _init, eoContinue<EOT>& _continuator,
                 eoEvalFunc<EOT>& _eval, // Evaluation function
                 eoQuadOp <EOT> & _cross, // Crossover operator
-                eoMonOp<EOT> & _mut // Mutation operator
-                /*eoBinOp<EOT>& _chromEvolOperator*/) :
+                eoMonOp<EOT> & _mut, // Mutation operator
+                /*eoBinOp<EOT>& _chromEvolOperator*/
+                unsigned _numThreads = 1 // # threads evolving the memeplexes
+                ) :
         testSet(_testSet),
         outputDir(_outputDir),
         numBins(_numBins),
@@ -139,8 +154,14 @@ public:
         mut(_mut),
 //        chromEvolOperator(_chromEvolOperator),
         bestSolution(0), // null
-        popVariance(0)
-    { }
+        popVariance(0),
+        pool(_numThreads),
+        workerNumEvals(pool.getNumThreads())
+    {
+        // One search context per worker
+        for (unsigned w = 0; w < pool.getNumThreads(); ++w)
+            searchContexts.push_back(boost::make_shared<SearchContext>(workerNumEvals.getShard(w)));
+    }
 
     // Apply SCEA to the population
     virtual void operator()(eoPop<EOT> &_pop)
@@ -148,23 +169,28 @@ public:
         try
         {
             // Step 0 and 1 - Initialization and generation of virtual population of frogs
-            //   The population is already initialized by the 'init' object
+            //   The population is already initialized by the 'init' object, or it is empty
+            //   and the F frogs are built concurrently
+            if (_pop.empty())
+                generatePopulation(_pop);
             //
             // Step 2 - Frog ranking
             rankFrogs(_pop);
-            // Create memeplex structure
-            vector<vector<EOT> > memplexes = createMemeplexes();
+            // Create memeplex structure. Memeplexes hold indexes into the population.
+            vector<vector<int> > memplexes = createMemeplexes();
 
             do
             {
                 // Step 3 Partition frogs into memeplex
                 partitionFrogsIntoMemplexes(_pop, memplexes);
                 // Step 4 Frog-leaping algorithm for local search
-                frogLeapingLocalSearch(memplexes);
+                frogLeapingLocalSearch(_pop, memplexes);
+                // Print memeplex info
+                printMemplexes(_pop, memplexes);
                 // Step 5 Shuffle memeplexes. After a defined number of memetic evolutionary steps within each memeplex,
                 // replace Y1,...,Ym into X such that X={Yk, k = 1..., m}. Sort X in order of decreasing performance value.
                 // Update the population the best frog’s position PX.
-                shuffleMemplexes(memplexes, _pop);
+                shuffleMemplexes(_pop);
                 // Step 6 Check convergences. If the convergence criteria are satisfied, stop. Otherwise, return to step 3.
                 // Typically, the decision on when to stop is made by a prespecified number of consecutive time loops when
                 // at least one frog carries the “best memetic pattern” without change. Alternatively, a maximum total number of
@@ -172,8 +198,11 @@ public:
 
                 // Compute best solution and statistics
                 computeVariance(_pop);
-                // Print memeplex info and save best solution on file
-                printMemplexes(memplexes);
+                // Print statistics and save best solution on file
+                printStatistics();
+                // Population memory footprint
+                if (MemoryAccounting::isEnabled())
+                    printPopulationMemory(_pop);
             }
             while (continuator(_pop));
         }
@@ -184,6 +213,10 @@ public:
             throw std::runtime_error(s);
         }
         cout << "Best solution overall fitness = " << Pg.fitness() << endl;
+        if (MemoryAccounting::isEnabled()) {
+            MemoryAccounting::printProcess(cout);
+            MemoryAccounting::printProcess(outFile);
+        }
     }
 
 
@@ -191,21 +224,32 @@ public:
         return Pg;
     }
 
+    /**
+     * @brief getNumEvalsCounter
+     * @return # evaluations performed by the memeplex workers in threaded mode
+     */
+    eoNumberEvalsCounter const& getNumEvalsCounter() const {
+        return numEvalsCounter;
+    }
+
 protected:
 
     //
     // Auxiliary methods
     //
-    void printMemplexes(vector<vector<EOT> >& _memeplexes) {
+    void printMemplexes(eoPop<EOT> const& _pop, vector<vector<int> > const& _memeplexes) {
         // Iterate over the memeplexes
         for (int im = 0; im < m; ++im) {
             cout << "Memplex #" << im << ":" << endl;
             // Iterate memeplex
             for (int iN = 0; iN < N; ++iN) {
-                cout << '\t' << _memeplexes[im][iN].fitness() << endl;
+                cout << '\t' << _pop[_memeplexes[im][iN]].fitness() << endl;
             }
         }
         cout << endl;
+    }
+
+    void printStatistics() {
         cout << endl << "Date/Time = " << currentDateTime() << ", popVariance = " << popVariance
              << ", best sol = " << Pg.fitness() << endl;
 
@@ -234,6 +278,26 @@ protected:
         solutionFile.close();
     }
 
+    /**
+     * @brief printPopulationMemory Sample and print the current and peak footprint of the
+     * frogs and of the global best frog. The footprint of each frog is also updated in the
+     * memory accounting, as the local search grows its period vectors.
+     * @param _pop
+     */
+    void printPopulationMemory(eoPop<EOT> &_pop) {
+        MemoryAccounting::Footprint footprint;
+        for (unsigned i = 0; i < _pop.size(); ++i) {
+            _pop[i].updateMemoryAccounting();
+            _pop[i].getMemoryFootprint(footprint);
+        }
+        Pg.updateMemoryAccounting();
+        Pg.getMemoryFootprint(footprint);
+        populationMemory.sample(footprint);
+        std::string title = "Population memory (" + std::to_string(_pop.size()) + " frogs and Pg)";
+        populationMemory.print(cout, title);
+        populationMemory.print(outFile, title);
+    }
+
     void computeVariance(eoPop<EOT> const& _pop) {
         ///
         /// TODO - Compute Memeplex variance
@@ -254,15 +318,15 @@ protected:
         // The best frog is located at index 0 in the ranked population
         Pg = _chrom;
     }
-    EOT getMemeplexBestFrog(vector<EOT>& _memeplex) {
+    EOT const& getMemeplexBestFrog(eoPop<EOT> const& _pop, vector<int> const& _memeplex) {
         // Pre-condition: vector _memeplex is sorted by fitness
         // Memeplex best frog is located at index 0 in the memeplex vector
-        return _memeplex[0];
+        return _pop[_memeplex[0]];
     }
-    EOT getMemeplexWorstFrog(vector<EOT>& _memeplex) {
+    EOT const& getMemeplexWorstFrog(eoPop<EOT> const& _pop, vector<int> const& _memeplex) {
         // Pre-condition: vector _memeplex is sorted by fitness
         // Memeplex worst frog is located at the last index in the memeplex vector
-        return _memeplex[_memeplex.size()-1];
+        return _pop[_memeplex[_memeplex.size()-1]];
     }
 
     struct FitnessCmp {
@@ -271,6 +335,20 @@ protected:
         }
     };
 
+    // Compares population indexes by the fitness of the frogs they reference
+    struct IndexFitnessCmp {
+        IndexFitnessCmp(eoPop<EOT> const& _pop) : pop(_pop) { }
+        bool operator()(int _idx1, int _idx2) {
+            return pop[_idx1].fitness() < pop[_idx2].fitness(); // Ascending order because we're minimizing
+        }
+        eoPop<EOT> const& pop;
+    };
+
+    void sortMemeplex(eoPop<EOT> const& _pop, vector<int>& _memeplex) {
+        // Only the indexes are moved, frogs stay in place in the population
+        sort(_memeplex.begin(), _memeplex.end(), IndexFitnessCmp(_pop));
+    }
+
     void rankFrogs(eoPop<EOT>& _pop) {
         // Step 2 Rank frogs. Sort the F frogs in order of decreasing performance value. Store them in an array
         // X={U(i), f(i), i=1,...,F} so that i=1 represents the frog with the best performance value.
@@ -283,45 +361,32 @@ protected:
 
     /// TODO: Optimizar copia do vector no retorno
 
-    vector<vector<EOT> > createMemeplexes() {
-        vector<vector<EOT> > memeplexes;
+    vector<vector<int> > createMemeplexes() {
+        vector<vector<int> > memeplexes;
         for (int i = 0; i < m; ++i)
-            memeplexes.push_back(vector<EOT>(N));
+            memeplexes.push_back(vector<int>(N));
         return memeplexes;
     }
 
-    void partitionFrogsIntoMemplexes(eoPop<EOT>& _pop, vector<vector<EOT> >& _memeplexes) {
+    void partitionFrogsIntoMemplexes(eoPop<EOT>& _pop, vector<vector<int> >& _memeplexes) {
         // Step 3 Partition frogs into memeplex. Partition array X into m memeplexes Y1, Y2,...,Ym, each containing
         // n frogs. E.g., for m=3, rank 1 goes to memeplex 1, rank 2 goes to memeplex 2, rank 3 goes to memeplex 3,
         // rank 4 goes to memeplex 1, and so on (Fig. 2).
         vector<int> memeplexIndexes(m);
         for (int i = 0; i < _pop.size(); ++i) {
             // Each entry in each memeplex references a solution contained in population vector
-            _memeplexes[i%m][memeplexIndexes[i%m]] = _pop[i];
+            _memeplexes[i%m][memeplexIndexes[i%m]] = i;
             // Increment memeplex solution index
             ++memeplexIndexes[i%m];
         }
     }
 
-    void shuffleMemplexes(vector<vector<EOT> >& _memeplexes, eoPop<EOT>& _pop) {
+    void shuffleMemplexes(eoPop<EOT>& _pop) {
         // Step 5 Shuffle memeplexes. After a defined number of memetic evolutionary steps within each memeplex,
         // replace Y1,...,Ym into X such that X={Yk, k = 1..., m}. Sort X in order of decreasing performance value.
         // Update the population the best frog’s position PX.
-
-        ///
-        /// TODO: Eliminate copies...
-        ///
-        /// Memeplexes should have references to population vector
-        ///
-
-        int k = 0;
-        // Iterate over the memeplexes
-        for (int im = 0; im < m; ++im) {
-            // Perform N evolutionary steps
-            for (int iN = 0; iN < N; ++iN) {
-                _pop[k++] = _memeplexes[im][iN];
-            }
-        }
+        //
+        // Memeplexes reference the population vector, so the evolved frogs are already in X.
 
         // Sort the population vector.
         sort(_pop.begin(), _pop.end(), FitnessCmp());
@@ -332,37 +397,62 @@ protected:
     }
 
 
-    void frogLeapingLocalSearch(vector<vector<EOT> >& _memeplexes) {
-        // Iterate over the memeplexes
-        for (int im = 0; im < m; ++im) {
+    void frogLeapingLocalSearch(eoPop<EOT>& _pop, vector<vector<int> >& _memeplexes) {
+        if (pool.getNumThreads() == 1) {
+            // Iterate over the memeplexes
+            for (int im = 0; im < m; ++im)
+                evolveMemeplex(_pop, _memeplexes[im], -1, rng, eval, mut);
+            return;
+        }
+        // Memeplexes are independent until shuffled, so each one is evolved on its own
+        // worker. Memeplexes only reference disjoint frogs of the population.
+        // Seeds are drawn serially, so the run doesn't depend on the scheduling.
+        vector<uint32_t> seeds(m);
+        for (int im = 0; im < m; ++im)
+            seeds[im] = rng.rand();
+        pool.parallelFor(m, [&](unsigned _im, unsigned _worker) {
+            SearchContext &context = *searchContexts[_worker];
+            context.gen.reseed(seeds[_im]);
+            evolveMemeplex(_pop, _memeplexes[_im], _im, context.gen, context.fullEval, context.mut);
+        });
+        // Barrier: parallelFor returns after every memeplex was evolved.
+        // Collect # evaluations of the workers.
+        numEvalsCounter.addNumEvalsToTotal(workerNumEvals.getTotalNumEvals());
+        workerNumEvals.reset();
+    }
 
-            // Use Sub-memeplexes
+
+    // Evolve memeplex _memeplex. _memeplexIndex names the memeplex files written by a worker
+    // of the threaded path; it is -1 on the serial path.
+    void evolveMemeplex(eoPop<EOT>& _pop, vector<int>& _memeplex, int _memeplexIndex, eoRng& _gen,
+                        eoEvalFunc<EOT>& _eval, eoMonOp<EOT>& _mut) {
+        // Use Sub-memeplexes
 //            vector<bool> marked(N);
 //            auto resultPair = createSubMemeplex(_memeplexes[im], q, marked);
 //            auto subMemeplex = resultPair.first;
 //            auto randomIdxs = resultPair.second;
 //            sort(subMemeplex.begin(), subMemeplex.end(), FitnessCmp());
 
-            // Do not use Sub-memeplexes
-            auto& subMemeplex = _memeplexes[im];
+        // Do not use Sub-memeplexes
+        auto& subMemeplex = _memeplex;
 
-            // Perform N evolutionary steps
-            for (int iN = 0; iN < N; ++iN) {
-                // Identify as Pb and Pw, respectively, the frogs with the best and the worst fitness.
-                // Also, the frog with the global best fitness is identified as Pg.
-                // Then, an evolution process is applied to improve only the frog with
-                // the worst fitness (i.e., not all frogs) in each cycle.
+        // Perform N evolutionary steps
+        for (int iN = 0; iN < N; ++iN) {
+            // Identify as Pb and Pw, respectively, the frogs with the best and the worst fitness.
+            // Also, the frog with the global best fitness is identified as Pg.
+            // Then, an evolution process is applied to improve only the frog with
+            // the worst fitness (i.e., not all frogs) in each cycle.
 
 /*
-                // Use Sub-memeplexes
-                // Optimize submemeplex
+            // Use Sub-memeplexes
+            // Optimize submemeplex
 //                POT Pb = getMemeplexBestFrog(subMemeplex);
-                POT Pw = getMemeplexWorstFrog(subMemeplex);
-                int numSelected = 0;
-                int k = 0;
+            POT Pw = getMemeplexWorstFrog(subMemeplex);
+            int numSelected = 0;
+            int k = 0;
 //                while (numSelected < 1) {
-                    int idx = (int)triangular(1, q, 1);
-                    // cout << "idx = " << idx << endl;
+                int idx = (int)triangular(1, q, 1);
+                // cout << "idx = " << idx << endl;
 //                    if (!marked[idx]) {
 //                        marked[idx] = true;
 //                        ++numSelected;
@@ -371,24 +461,24 @@ protected:
 //                        submemeplex[k++] = _memeplex[idx];
 //                    }
 //                }
-                POT Pb = subMemeplex[idx];
+            POT Pb = subMemeplex[idx];
 */
 
-                // Select a random frog except the memeplex's best frog
+            // Select a random frog except the memeplex's best frog
 //                EOT& newPw = subMemeplex[rng.random(subMemeplex.size()-1)+1];
 
-                // LAST
+            // LAST
 //                int indexNewPw = rng.random(subMemeplex.size()-1)+1;
 
 
-                // Change best solution eventually
-                int indexNewPw = rng.random(subMemeplex.size());
+            // Change best solution eventually
+            int indexNewPw = _gen.random(subMemeplex.size());
 
 
-                EOT& newPw = subMemeplex[indexNewPw];
+            EOT& newPw = _pop[subMemeplex[indexNewPw]];
 
-                // Select a random frog
-                EOT _Pw = subMemeplex[rng.random(subMemeplex.size())];
+            // Select a random frog
+            EOT const& _Pw = _pop[subMemeplex[_gen.random(subMemeplex.size())]];
 
 /// TODO - Create custom cross and mut operators
 //                // To perform cross-over
@@ -405,13 +495,13 @@ protected:
 //                fullEval(newPw);
 
 
-                // To perform mutation
-                if (rng.uniform() < mp) {
-                    // Change the solutions directly
-                    mut(newPw);
-                    // # evals statistics computation. Add 2 to # evals
+            // To perform mutation
+            if (_gen.uniform() < mp) {
+                // Change the solutions directly
+                _mut(newPw);
+                // # evals statistics computation. Add 2 to # evals
 //                    numEvalsCounter.addNumEvalsToGenerationTotal(2);
-                }
+            }
 
 
 /// COMMENTED 4-MARCH-2016
@@ -500,24 +590,24 @@ protected:
 //                    _chromosome.computeProximityCosts();
 //                }
 
-                newPw.invalidate();
-                eval(newPw);
+            newPw.invalidate();
+            _eval(newPw);
 
-                sort(_memeplexes[im].begin(), _memeplexes[im].end(), FitnessCmp());
+            sortMemeplex(_pop, subMemeplex);
 
-                //POT newFrog = improveWorstFrogPosition(Pb, Pw);
+            //POT newFrog = improveWorstFrogPosition(Pb, Pw);
 
 //                int randomIdx = rng.random(subMemeplex.size()/2);
 //                int randomIdx = rng.random(subMemeplex.size()/4); // LAST
-                int randomIdx = rng.random(subMemeplex.size()); // NOT GOOD
+            int randomIdx = _gen.random(subMemeplex.size()); // NOT GOOD
 
 
-                EOT improvedFrog = subMemeplex[randomIdx];
+            EOT improvedFrog = _pop[subMemeplex[randomIdx]];
 
 //                if (rng.uniform() < 0) {
 //                if (rng.uniform() < 0.1) { // NOT GOOD
 //                if (rng.uniform() < 1) {
-                if (rng.uniform() < ip) {
+            if (_gen.uniform() < ip) {
 //                    /////////////////////////////////////////////////////////////
 ////                    moSimpleCoolingSchedule<EOT> coolSchedule(0.01, 0.00001, 5, 1e-7); // SLOW
 ////                    moSimpleCoolingSchedule<EOT> coolSchedule(0.001, 0.00001, 5, 1e-4); // Set 2: 440
@@ -526,16 +616,16 @@ protected:
 ////                    moSimpleCoolingSchedule<EOT> coolSchedule(0.01, 0.1, 5, 1e-7);
 
 //                    moSimpleCoolingSchedule<eoChromosome> coolSchedule(0.1, 0.0001, 5, 1e-7);
-                    moSimpleCoolingSchedule<eoChromosome> coolSchedule(0.01, 0.00001, 5, 1e-6); // VERY GOOD, BUT SLOW
+                moSimpleCoolingSchedule<eoChromosome> coolSchedule(0.01, 0.00001, 5, 1e-6); // VERY GOOD, BUT SLOW
 
 
-                    // Copy of cool schedule to use in TA solver
-                    auto cool = coolSchedule;
+                // Copy of cool schedule to use in TA solver
+                auto cool = coolSchedule;
 
 //                    ExamMoveStatistics examMoveStatistics(testSet, outputDir,
 //                                                          numBins, cool);
-                    ExamMoveStatistics *examMoveStatistics = new ExamMoveStatistics(testSet, outputDir,
-                                                          numBins, cool);
+                ExamMoveStatistics *examMoveStatistics = new ExamMoveStatistics(testSet, outputDir,
+                                                      numBins, cool, _memeplexIndex);
 //                    // Generate initial solution
 //                    examMoveStatistics.setPtrInitialSolution(&subMemeplex[randomIdx]);
 //                    // Determine exams color degree necessary for sorting ExamInfo array by color degree
@@ -543,49 +633,49 @@ protected:
 //                    // Determine thresholds based on the max number of evaluations
 //                    examMoveStatistics.generateThresholds();
 
-                    // Generate initial solution
-                    examMoveStatistics->setPtrInitialSolution(&subMemeplex[randomIdx]);
-                    // Determine exams color degree necessary for sorting ExamInfo array by color degree
-                    examMoveStatistics->determineExamsColorDegree();
-                    // Determine thresholds based on the max number of evaluations
-                    examMoveStatistics->generateThresholds();
+                // Generate initial solution
+                examMoveStatistics->setPtrInitialSolution(&_pop[subMemeplex[randomIdx]]);
+                // Determine exams color degree necessary for sorting ExamInfo array by color degree
+                examMoveStatistics->determineExamsColorDegree();
+                // Determine thresholds based on the max number of evaluations
+                examMoveStatistics->generateThresholds();
 
 
-                    //
-                    // Local search used: Threshold Accepting algorithm
-                    //
+                //
+                // Local search used: Threshold Accepting algorithm
+                //
 
-                    //
-                    // moTA with statistics
-                    //
-                    // moTA parameters
-                    boost::shared_ptr<ETTPKempeChainHeuristicWithStatistics<EOT> > kempeChainHeuristic(
-                                new ETTPKempeChainHeuristicWithStatistics<EOT>());
+                //
+                // moTA with statistics
+                //
+                // moTA parameters
+                boost::shared_ptr<ETTPKempeChainHeuristicWithStatistics<EOT> > kempeChainHeuristic(
+                            new ETTPKempeChainHeuristicWithStatistics<EOT>(_gen));
 //                    eoETTPEval<eoChromosome> fullEval; // eoEvalFunc used to evaluate the solutions
-                    ETTPNeighborhoodWithStatistics<EOT> neighborhood(kempeChainHeuristic);
-                    ETTPneighborEvalWithStatistics<EOT> neighEval;
-                    moTAWithStatistics<ETTPneighborWithStatistics<EOT> > ta(
-                                *examMoveStatistics, neighborhood, eval, neighEval, cool);
+                ETTPNeighborhoodWithStatistics<EOT> neighborhood(kempeChainHeuristic);
+                ETTPneighborEvalWithStatistics<EOT> neighEval;
+                moTAWithStatistics<ETTPneighborWithStatistics<EOT> > ta(
+                            *examMoveStatistics, neighborhood, _eval, neighEval, cool);
 //                    moTA<ETTPneighbor<EOT> > ta(neighborhood, eval, neighEval, cool);
-                    ta(improvedFrog);
+                ta(improvedFrog);
 
-                    delete examMoveStatistics;
-                    /////////////////////////////////////////////////////////////
+                delete examMoveStatistics;
+                /////////////////////////////////////////////////////////////
 
 
-                    //
-                    // Improvement by Local search.
-                    // Local search used: Great Deluge algorithm
-                    //
-                    // moGDA parameters
+                //
+                // Improvement by Local search.
+                // Local search used: Great Deluge algorithm
+                //
+                // moGDA parameters
 //                    boost::shared_ptr<ETTPKempeChainHeuristic<EOT> > kempeChainHeuristic(new ETTPKempeChainHeuristic<EOT>());
 //                    ETTPneighborhood<EOT> neighborhood(kempeChainHeuristic);
 //                    ETTPneighborEval<EOT> neighEval;
 
 
 
-                    // ETTPneighborEvalWithStatistics which receives as argument an
-                    // eoNumberEvalsCounter for counting neigbour # evaluations
+                // ETTPneighborEvalWithStatistics which receives as argument an
+                // eoNumberEvalsCounter for counting neigbour # evaluations
 //                    ETTPneighborEvalNumEvalsCounter<EOT> neighEval(this->numEvalsCounter);
 
 
@@ -624,21 +714,21 @@ protected:
                                                                                                 // Dataset 11: 36841
                                                                                                 // Dataset 12: 5167
 
-                    /// NOT VERIFIED RESULTS....
+                /// NOT VERIFIED RESULTS....
 
 
-                    /// WITH CHANGED ACCEPTANCE CRITERION SA - NOT GOOD
-                    ///
-                    // WITH SHIFT MOVE + ROOM MOVE
+                /// WITH CHANGED ACCEPTANCE CRITERION SA - NOT GOOD
+                ///
+                // WITH SHIFT MOVE + ROOM MOVE
 //                    moSimpleCoolingSchedule<eoChromosome> coolSchedule(1000, 0.01, 5, 0.01);  // Dataset 1: 13910
                                                                                                 // Dataset 2: 3000
                                                                                                 // Dataset 4: 15300
                                                                                                 // Dataset 6: 28180
 
 //                    moSimpleCoolingSchedule<eoChromosome> coolSchedule(1000, 0.001, 5, 0.001); // Dataset 1: 8314
-                    //////////////////////////////////////////////////////////////////////////////////////////                                                                                               // Dataset 2: 831
+                //////////////////////////////////////////////////////////////////////////////////////////                                                                                               // Dataset 2: 831
 
-                    // WITH SHIFT MOVE + ROOM MOVE
+                // WITH SHIFT MOVE + ROOM MOVE
 //                    moSimpleCoolingSchedule<eoChromosome> coolSchedule(0.01, 0.00001, 5, 1e-6); // VERY GOOD, BUT SLOW
                                                                                                 // Dataset 1: 5466
                                                                                                 // Dataset 2: 440
@@ -652,8 +742,8 @@ protected:
                                                                                                 // Dataset 10: 13805
                                                                                                 // Dataset 11: 31461
                                                                                                 // Dataset 12: 5223
-                    //////////////////////////////////////////////////////////////////////////////////
-                    /// SCEA+TA + SHIFT MOVE + ROOM MOVE
+                //////////////////////////////////////////////////////////////////////////////////
+                /// SCEA+TA + SHIFT MOVE + ROOM MOVE
 //                    moSimpleCoolingSchedule<eoChromosome> coolSchedule(100, 0.0001, 5, 2e-6); // FAST
                                                                                             // Dataset 1: 5935
                                                                                             // Dataset 2: 475
@@ -668,7 +758,7 @@ protected:
                                                                                             // Dataset 11: 36604
                                                                                             // Dataset 12: 5208
 
-                    /// SCEA+TA + SHIFT MOVE ONLY
+                /// SCEA+TA + SHIFT MOVE ONLY
 //                    moSimpleCoolingSchedule<eoChromosome> coolSchedule(100, 0.0001, 5, 2e-6); // FAST
                                                                                             // Dataset 1: 6118
                                                                                             // Dataset 2: 450
@@ -684,11 +774,11 @@ protected:
                                                                                             // Dataset 12: 5192
 
 
-                    //////////////////////////////////////////////////////////////////////////////////
+                //////////////////////////////////////////////////////////////////////////////////
 
-                    // WITH SHIFT MOVE ONLY
+                // WITH SHIFT MOVE ONLY
 //                    moSimpleCoolingSchedule<eoChromosome> coolSchedule(0.1, 0.00001, 5, 1e-6); // VERY GOOD, BUT SLOW
-                    moSimpleCoolingSchedule<eoChromosome> coolSchedule1(0.01, 0.00001, 5, 1e-6); // VERY GOOD, BUT SLOW
+                moSimpleCoolingSchedule<eoChromosome> coolSchedule1(0.01, 0.00001, 5, 1e-6); // VERY GOOD, BUT SLOW
                                                                                                 // Dataset 1: 5376
                                                                                                 // Dataset 2: 420
                                                                                                 // Dataset 3: 10307
@@ -703,8 +793,8 @@ protected:
                                                                                                 // Dataset 12: 5178
 
 
-                    // TA
-                    moSimpleCoolingSchedule<eoChromosome> coolSchedule2(100, 0.00001, 5, 2e-6);
+                // TA
+                moSimpleCoolingSchedule<eoChromosome> coolSchedule2(100, 0.00001, 5, 2e-6);
 
 
 //                    moSimpleCoolingSchedule<eoChromosome> coolSchedule2(100, 0.0001, 5, 2e-6);
@@ -757,7 +847,7 @@ protected:
 //                    }
 
 
-                    // APPROACH 1
+                // APPROACH 1
 
 //                    // LAST - JUSTIFY UNDERSTAND REASONING... HAVE MORE DIVERSITY THAN APPROACH 2
 //                    if (improvedFrog.fitness() < subMemeplex[randomIdx].fitness() &&
@@ -766,7 +856,7 @@ protected:
 ////                        subMemeplex[q-1] = improvedFrog;
 //                        replaceWorstFrog(improvedFrog, subMemeplex);
 //                    }
-                    // ADDED 10-jun - WORSE RESULTS
+                // ADDED 10-jun - WORSE RESULTS
 //                    else {
 //                        // Randomly generate a solution to replace the worst frog with another frog having any arbitrary fitness
 //                        EOT newFrogRandom = generateRandomFrogPosition();
@@ -775,13 +865,13 @@ protected:
 
 
 
-                    // APPROACH 2 - USED IN RUN 1
+                // APPROACH 2 - USED IN RUN 1
 
-                    if (improvedFrog.fitness() < subMemeplex[q-1].fitness()) {
-                       //  If improves the worst frog then replace it
+                if (improvedFrog.fitness() < _pop[subMemeplex[q-1]].fitness()) {
+                   //  If improves the worst frog then replace it
 //                        subMemeplex[q-1] = improvedFrog;
-                        replaceWorstFrog(improvedFrog, subMemeplex); // Maintains memeplex order
-                    }
+                    replaceWorstFrog(improvedFrog, _pop, subMemeplex); // Maintains memeplex order
+                }
 
 //                    else {
 //                        // Randomly generate a solution to replace the worst frog with another frog having any arbitrary fitness
@@ -792,18 +882,37 @@ protected:
 //                    subMemeplex[randomIdx] = improvedFrog;
 //                    sort(_memeplexes[im].begin(), _memeplexes[im].end(), FitnessCmp());
 
-                    // Just replace worst frog
+                // Just replace worst frog
 //                    subMemeplex[q-1] = improvedFrog;// All solutions tend to be equal, Uta 3.58 Up = 0.00001
 
 
-                }
             }
+        }
 
 
 /*
-                // Step 4-3 Improve the worst frog’s position.
-                POT newFrog = improveWorstFrogPosition(Pb, Pw);
+            // Step 4-3 Improve the worst frog’s position.
+            POT newFrog = improveWorstFrogPosition(Pb, Pw);
+
+            if (newFrog.fitness() < Pw.fitness()) {
+                replaceWorstFrog(newFrog, subMemeplex);
+            }
+            else {
+                // Randomly generate a solution to replace the worst frog with another frog having any arbitrary fitness
+                POT newFrogRandom = generateRandomFrogPosition();
+                replaceWorstFrog(newFrogRandom, subMemeplex);
+            }
 
+            // Step 4-4 If this process produces a better frog (solution), it replaces the worst frog.
+            // Otherwise, the calculations in Eqs. 5 and 6 are repeated with respect to the global best frog (i.e., Pg replaces Pb).
+            // Step 4-5 If no improvement becomes possible in this latter case, then a new solution is
+            // randomly generated to replace the worst frog with another frog having any arbitrary fitness (as shown in Fig. 3b).
+            if (newFrog.fitness() < Pw.fitness()) {
+                replaceWorstFrog(newFrog, subMemeplex);
+            }
+            else {
+                // Repeat computations with respect to the global best frog (i.e., Pg replaces Pb).
+                POT newFrog = improveWorstFrogPosition(Pg, Pw);
                 if (newFrog.fitness() < Pw.fitness()) {
                     replaceWorstFrog(newFrog, subMemeplex);
                 }
@@ -812,28 +921,9 @@ protected:
                     POT newFrogRandom = generateRandomFrogPosition();
                     replaceWorstFrog(newFrogRandom, subMemeplex);
                 }
+            }
 
-                // Step 4-4 If this process produces a better frog (solution), it replaces the worst frog.
-                // Otherwise, the calculations in Eqs. 5 and 6 are repeated with respect to the global best frog (i.e., Pg replaces Pb).
-                // Step 4-5 If no improvement becomes possible in this latter case, then a new solution is
-                // randomly generated to replace the worst frog with another frog having any arbitrary fitness (as shown in Fig. 3b).
-                if (newFrog.fitness() < Pw.fitness()) {
-                    replaceWorstFrog(newFrog, subMemeplex);
-                }
-                else {
-                    // Repeat computations with respect to the global best frog (i.e., Pg replaces Pb).
-                    POT newFrog = improveWorstFrogPosition(Pg, Pw);
-                    if (newFrog.fitness() < Pw.fitness()) {
-                        replaceWorstFrog(newFrog, subMemeplex);
-                    }
-                    else {
-                        // Randomly generate a solution to replace the worst frog with another frog having any arbitrary fitness
-                        POT newFrogRandom = generateRandomFrogPosition();
-                        replaceWorstFrog(newFrogRandom, subMemeplex);
-                    }
-                }
-
-                // Update Global frog
+            // Update Global frog
 //                POT bestMemeplexFrog = getMemeplexBestFrog(subMemeplex);
 //                if (bestMemeplexFrog.fitness() < Pg.fitness())
 //                    updateGlobalBestFrog(bestMemeplexFrog);
@@ -842,13 +932,12 @@ protected:
 
 
 //            sort(_memeplexes[im].begin(), _memeplexes[im].end(), FitnessCmp()); // don't know if necessary....
-            // Update Global frog
+        // Update Global frog
 //            POT bestMemeplexFrog = getMemeplexBestFrog(subMemeplex);
 //            if (bestMemeplexFrog.fitness() < Pg.fitness())
 //                updateGlobalBestFrog(bestMemeplexFrog);
 
 */
-        }
 
 /*
 //            cout << "[After improvement] Sorted submemeplex fitnesses" << endl;
@@ -880,6 +969,19 @@ protected:
     }
 
 
+    // Build and evaluate the F frogs of the initial population on the pool workers.
+    // The batch seed is drawn from the global generator.
+    void generatePopulation(eoPop<EOT>& _pop) {
+        ETTPBatchInit<EOT> batchInit(testSet.getTimetableProblemData().get(), pool.getNumThreads(), rng.rand());
+        _pop.resize(F);
+        batchInit(_pop);
+        batchInit.printConstructionTimes(cout);
+        batchInit.printConstructionTimes(outFile);
+        for (auto& frog : _pop)
+            eval(frog);
+    }
+
+
     EOT generateRandomFrogPosition() {
 //        boost::shared_ptr<POT> ptrNewFrogRandom(new POT());
         EOT newFrogRandom = EOT();
@@ -890,23 +992,20 @@ protected:
     }
 
 
-    void replaceWorstFrog(EOT& newFrog, vector<EOT>& _memeplex) {
+    void replaceWorstFrog(EOT& newFrog, eoPop<EOT>& _pop, vector<int>& _memeplex) {
         // Replace worst frog by the new one and then orderly relocate new frog in the memeplex vector
-        _memeplex[_memeplex.size()-1] = newFrog;
+        _pop[_memeplex[_memeplex.size()-1]] = newFrog;
         int i;
         for (i = _memeplex.size()-2; i >= 0; --i) {
-            if (_memeplex[i].fitness() > _memeplex[i+1].fitness()) {
+            if (_pop[_memeplex[i]].fitness() > _pop[_memeplex[i+1]].fitness()) {
                 // Swap entries
-                EOT aux = _memeplex[i];
-                _memeplex[i] = _memeplex[i+1];
-                _memeplex[i+1] = aux;
+                std::swap(_memeplex[i], _memeplex[i+1]);
             }
             else // Stop. The memeplex is ordered.
                 break;
         }
-        // Update the global frog
-        if (_memeplex[0].fitness() < Pg.fitness())
-            updateGlobalBestFrog(_memeplex[0]);
+        // The global best frog is updated when the memeplexes are shuffled, as
+        // memeplexes may be evolved concurrently
     }
 
 
@@ -1026,6 +1125,20 @@ protected:
     }
 */
 
+    /**
+     * @brief The SearchContext struct. Objects private to one memeplex worker.
+     */
+    struct SearchContext {
+        SearchContext(eoNumberEvalsCounter &_numEvalsCounter) : fullEval(_numEvalsCounter), mut(gen) { }
+
+        // Random number generator, reseeded for each memeplex
+        eoRng gen;
+        // Evaluation function
+        eoETTPEvalNumberEvalsCounter<EOT> fullEval;
+        // Mutation operator, drawing from gen
+        Mutation<EOT> mut;
+    };
+
 protected:
     /**
      * @brief _testSet
@@ -1078,6 +1191,16 @@ protected:
     EOT* bestSolution;
     // Population variance
     double popVariance;
+    // Pool of threads evolving the memeplexes
+    WorkStealingPool pool;
+    // # evaluations of the memeplex workers, one shard per worker
+    eoShardedNumberEvalsCounter workerNumEvals;
+    // Per-worker search contexts
+    std::vector<boost::shared_ptr<SearchContext> > searchContexts;
+    // # evaluations performed by the memeplex workers
+    eoNumberEvalsCounter numEvalsCounter;
+    // Population footprint, sampled every time loop
+    MemoryAccounting::Tracker populationMemory;
 };
 
 
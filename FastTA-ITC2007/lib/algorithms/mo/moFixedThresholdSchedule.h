@@ -0,0 +1,59 @@
+#ifndef MOFIXEDTHRESHOLDSCHEDULE_H
+#define MOFIXEDTHRESHOLDSCHEDULE_H
+
+
+#include <coolingSchedule/moCoolingSchedule.h>
+
+
+/**
+ * Cooling schedule which keeps the threshold constant and stops the search
+ * after a given number of iterations. Used by the replicas of the parallel
+ * tempering TA, where each replica runs at its own fixed threshold.
+ */
+template< class EOT >
+class moFixedThresholdSchedule : public moCoolingSchedule<EOT>
+{
+public:
+    /**
+     * Constructor
+     * @param _threshold the (constant) threshold
+     * @param _numIterations number of iterations performed before stopping
+     */
+    moFixedThresholdSchedule(double _threshold, unsigned long _numIterations)
+        : threshold(_threshold), numIterations(_numIterations), step(0) {}
+
+    /**
+     * Getter on the threshold
+     * @return the threshold
+     */
+    virtual double init(EOT &) {
+        // Reset number of iterations performed
+        step = 0;
+        return threshold;
+    }
+
+    /**
+     * The threshold is not updated, only the number of iterations performed
+     */
+    virtual void update(double &, bool) {
+        ++step;
+    }
+
+    /**
+     * @return true while the number of iterations was not reached
+     */
+    virtual bool operator()(double) {
+        return step < numIterations;
+    }
+
+    // The threshold
+    double threshold;
+    // Number of iterations performed before stopping
+    unsigned long numIterations;
+    // Number of iterations performed
+    unsigned long step;
+};
+
+
+
+#endif // MOFIXEDTHRESHOLDSCHEDULE_H
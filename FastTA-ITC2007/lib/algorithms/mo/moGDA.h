@@ -49,6 +49,14 @@ public:
             explorer(_neighborhood, _eval, defaultSolNeighborComp, _up)
     {}
 
+    /**
+     * Count the moves in _telemetry (nullptr disables the counters)
+     * @param _telemetry the search telemetry counters
+     */
+    void setTelemetry(SearchTelemetry *_telemetry) {
+        explorer.setTelemetry(_telemetry);
+    }
+
 
 private:
     moTrueContinuator<Neighbor> trueCont;
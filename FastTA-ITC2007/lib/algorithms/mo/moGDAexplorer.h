@@ -8,6 +8,8 @@
 
 #include <neighborhood/moNeighborhood.h>
 
+#include "utils/SearchTelemetry.h"
+
 
 /**
  * Explorer for the Great Deluge algorithm
@@ -34,7 +36,8 @@ public:
      */
   moGDAexplorer(Neighborhood& _neighborhood, moEval<Neighbor>& _eval,
                moSolNeighborComparator<Neighbor>& _solNeighborComparator, double _up)
-      : moNeighborhoodExplorer<Neighbor>(_neighborhood, _eval), solNeighborComparator(_solNeighborComparator), up(_up) {
+      : moNeighborhoodExplorer<Neighbor>(_neighborhood, _eval), solNeighborComparator(_solNeighborComparator), up(_up),
+        telemetry(nullptr) {
 
         isAccept = false;
 
@@ -65,6 +68,9 @@ public:
 
         isAccept = false;
 
+        ETTP_TELEMETRY_HOOK(telemetry, setThreshold(level));
+        ETTP_TELEMETRY_HOOK(telemetry, start());
+
 //        cout << "Initial solution: " << initLevel << endl;
 
 
@@ -82,15 +88,29 @@ public:
         // Update the water level
 //        level = level - up;
 
+        ETTP_TELEMETRY_HOOK(telemetry, moveDone(this->moveApplied()));
+
         level = level * up;
 
+        ETTP_TELEMETRY_HOOK(telemetry, setThreshold(level));
+
     };
 
     /**
-     * terminate: NOTHING TO DO
+     * terminate: stop the telemetry counters
      * @param _solution unused solution
      */
-    virtual void terminate(EOT & _solution) { }
+    virtual void terminate(EOT & _solution) {
+        ETTP_TELEMETRY_HOOK(telemetry, stop());
+    }
+
+    /**
+     * Count the moves in _telemetry (nullptr disables the counters)
+     * @param _telemetry the search telemetry counters
+     */
+    void setTelemetry(SearchTelemetry *_telemetry) {
+        telemetry = _telemetry;
+    }
 
     /**
      * Explore one random solution in the neighborhood
@@ -162,6 +182,7 @@ public:
             ETTPneighbor<EOT> *neighbourPtr = (ETTPneighbor<EOT> *)selectedNeighborPtr;
             if (neighbourPtr != nullptr && !neighbourPtr->isFeasible()) {
                 isAccept = false;
+                ETTP_TELEMETRY_HOOK(telemetry, moveInfeasible());
 #ifdef MOTAEXPLORER_DEBUG
             std::cout << "In [moTAexplorer::accept(sol)] method:" << std::endl;
             std::cout << "Infeasible solution, it will not be accepted. Generating a new one..." << std::endl;
@@ -195,6 +216,8 @@ private:
     double level;
     double initLevel;
     double up;
+    // Search telemetry counters, if any
+    SearchTelemetry *telemetry;
 };
 
 
@@ -57,7 +57,7 @@ public:
      * @param _finalT final temperature, threshold of the stopping criteria
      */
     moSimpleCoolingSchedule(double _initT, double _alpha, unsigned _span, double _finalT)
-        : initT(_initT), alpha(_alpha), span(_span), finalT(_finalT), step(0), t(0) {}
+        : initT(_initT), alpha(_alpha), span(_span), finalT(_finalT), step(0), t(0), resumed(false) {}
 
     /**
      * Getter on the initial temperature
@@ -65,6 +65,13 @@ public:
      * @return the initial temperature
      */
     virtual double init(EOT & _solution) {
+        // Resumed search: continue where the checkpoint was taken
+        if (resumed) {
+            resumed = false;
+            step = resumeStep;
+            t = resumeT;
+            return t == 0 ? initT : Temp(t, initT, alpha);
+        }
         // number of iteration with the same temperature
         step = 0;
         // Reset t
@@ -72,6 +79,17 @@ public:
         return initT;
     }
 
+    /**
+     * Make the next init() continue at (_step, _t) instead of the initial temperature (see moTACheckpoint)
+     * @param _step number of steps with the current temperature
+     * @param _t rate increment variable
+     */
+    void resume(unsigned _step, int _t) {
+        resumed = true;
+        resumeStep = _step;
+        resumeT = _t;
+    }
+
     /**
      * update the temperature by a factor
      * @param _temp current temperature to update
@@ -118,6 +136,11 @@ public:
 
     // Rate increment variable
     int t;
+
+    // true if the next init() resumes at (resumeStep, resumeT)
+    bool resumed;
+    unsigned int resumeStep;
+    int resumeT;
 };
 
 
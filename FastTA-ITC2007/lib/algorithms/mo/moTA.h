@@ -36,6 +36,31 @@ public:
             explorer(_neighborhood, _eval, defaultSolNeighborComp, _cool)
     {}
 
+    /**
+     * Trace the search to _sink (nullptr disables tracing)
+     * @param _sink the trace sink
+     * @param _interval trace every _interval-th threshold change
+     */
+    void setTrace(TraceSink *_sink, unsigned long _interval = 1) {
+        explorer.setTrace(_sink, _interval);
+    }
+
+    /**
+     * Count the moves in _telemetry (nullptr disables the counters)
+     * @param _telemetry the search telemetry counters
+     */
+    void setTelemetry(SearchTelemetry *_telemetry) {
+        explorer.setTelemetry(_telemetry);
+    }
+
+    /**
+     * Record the moves in _moveLog, or compare them with it (nullptr disables the log)
+     * @param _moveLog the move log
+     */
+    void setMoveLog(MoveLog *_moveLog) {
+        explorer.setMoveLog(_moveLog);
+    }
+
 
 private:
     moTrueContinuator<Neighbor> trueCont;
@@ -0,0 +1,668 @@
+#ifndef MOTACHECKPOINT_H
+#define MOTACHECKPOINT_H
+
+#include <continuator/moContinuator.h>
+#include <utils/eoRNG.h>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <limits>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <unistd.h>
+
+#include "algorithms/mo/moSimpleCoolingSchedule.h"
+#include "eval/eoNumberEvalsCounter.h"
+#include "data/TimetableProblemData.hpp"
+#include "utils/MappedFile.h"
+
+
+// For debugging purposes
+//#define MOTACHECKPOINT_DEBUG
+
+
+
+/**
+ * @brief The moCheckpointState class. Search state kept outside the solution and the
+ * cooling schedule, e.g. the exam fixing state of FastTA (ExamMoveStatisticsOpt),
+ * saved in moTACheckpoint files as an array of ints.
+ */
+class moCheckpointState {
+
+public:
+    virtual ~moCheckpointState() { }
+    /**
+     * @brief saveState
+     * @param _state Filled with the state
+     */
+    virtual void saveState(std::vector<int> &_state) const = 0;
+    /**
+     * @brief restoreState
+     * @param _state State saved by saveState
+     */
+    virtual void restoreState(std::vector<int> const &_state) = 0;
+};
+
+
+
+/**
+ * Checkpoint/resume of a Threshold Accepting search (moTA and its variants with
+ * a moSimpleCoolingSchedule).
+ *
+ * Installed as the continuator of the local search (moLocalSearch::setContinuator),
+ * it snapshots every _interval iterations the full search state: current solution,
+ * best solution, threshold q, cooling schedule step and t, random number generator,
+ * # evaluations and the optional moCheckpointState (FastTA exam fixing state).
+ * The snapshot is copied into one of two buffers on the search thread, which costs
+ * O(# exams); a writer thread writes it to disk while the search goes on. If the
+ * writer is still busy when the next snapshot is due, the pending buffer is
+ * overwritten, so the search never waits for the disk. Files are written under a
+ * temporary name and then renamed, so a checkpoint file is always complete.
+ *
+ * resume() restores a checkpoint before the search is run. The current solution is
+ * rebuilt with its period exam lists in the same order, so the resumed search is
+ * bit-identical to an uninterrupted one. setStopIteration() stops the search early,
+ * e.g. to run a long search in several jobs: the last checkpoint is then not final
+ * and the next run resumes from it.
+ *
+ * File layout: Header, then int32 arrays in this order
+ *  periodStart         numPeriods+1     start of each period in periodExams/periodRooms
+ *  periodExams         numExams         current solution, in period exam list order
+ *  periodRooms         numExams
+ *  bestPeriods         numExams         best solution, by exam
+ *  bestRooms           numExams
+ *  state               stateSize        moCheckpointState
+ * and the random number generator state (rngStateSize chars, as printed by eoRng::printOn).
+ */
+template <class Neighbor>
+class moTACheckpoint : public moContinuator<Neighbor>
+{
+public:
+    typedef typename Neighbor::EOT EOT;
+
+    /**
+     * Constructor
+     * @param _filename checkpoint file
+     * @param _interval number of iterations between checkpoints
+     * @param _timetableProblemData problem data, used to rebuild solutions
+     * @param _coolSchedule cooling schedule of the search
+     * @param _numEvalsCounter # evaluations counter
+     * @param _gen random number generator used by the search
+     */
+    moTACheckpoint(std::string const &_filename, unsigned long _interval,
+                   TimetableProblemData const *_timetableProblemData,
+                   moSimpleCoolingSchedule<EOT> &_coolSchedule,
+                   eoNumberEvalsCounter &_numEvalsCounter, eoRng &_gen = rng);
+
+    /**
+     * Destructor. Waits for the pending checkpoint to be written
+     */
+    ~moTACheckpoint();
+
+    moTACheckpoint(moTACheckpoint const &) = delete;
+    moTACheckpoint &operator=(moTACheckpoint const &) = delete;
+
+    /**
+     * @brief setState Also save and restore _state
+     * @param _state
+     */
+    void setState(moCheckpointState *_state);
+
+    /**
+     * @brief setStopIteration Stop the search once _iteration iterations are done in
+     * total, counting those of the resumed runs. 0, the default, lets the cooling
+     * schedule stop it.
+     * @param _iteration
+     */
+    void setStopIteration(uint64_t _iteration);
+
+    /**
+     * @brief resume Restore the checkpoint file, if it exists. Throws std::runtime_error
+     * if the file is corrupt or belongs to another instance.
+     * @param _sol Restored current solution
+     * @return false if there is no checkpoint file
+     */
+    bool resume(EOT &_sol);
+
+    /**
+     * @brief isFinished
+     * @return true if the restored checkpoint was written at the end of the search
+     */
+    bool isFinished() const;
+
+    /**
+     * @brief getBestSolution Rebuild the best solution found so far
+     * @param _best
+     */
+    void getBestSolution(EOT &_best) const;
+
+    /**
+     * @brief flush Wait until the pending checkpoint is written
+     */
+    void flush();
+
+    /**
+     * @brief init Called at the start of the search
+     * @param _sol
+     */
+    virtual void init(EOT &_sol);
+
+    /**
+     * @brief operator () Called after each iteration
+     * @param _sol
+     * @return false once the stop iteration is reached, true otherwise
+     */
+    virtual bool operator()(EOT &_sol);
+
+    /**
+     * @brief lastCall Write the last checkpoint, final unless the search was stopped
+     * before the end of the cooling schedule
+     * @param _sol
+     */
+    virtual void lastCall(EOT &_sol);
+
+protected:
+    // Checkpoint format version. Increment whenever the layout changes.
+    static const uint32_t VERSION = 1;
+
+    /**
+     * @brief The Header struct
+     */
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        int32_t numExams;
+        int32_t numPeriods;
+        uint32_t finished;
+        uint32_t step;
+        int32_t t;
+        uint32_t stateSize;
+        uint64_t rngStateSize;
+        uint64_t iteration;
+        int64_t totalNumEvals;
+        int64_t currentCost;
+        int64_t bestCost;
+        double q;
+        double currentFitness;
+        double bestFitness;
+    };
+
+    /**
+     * @brief The Snapshot struct. One checkpoint
+     */
+    struct Snapshot {
+        Header header;
+        std::vector<int32_t> periodStart;
+        std::vector<int32_t> periodExams;
+        std::vector<int32_t> periodRooms;
+        std::vector<int32_t> bestPeriods;
+        std::vector<int32_t> bestRooms;
+        std::vector<int> state;
+        std::string rngState;
+    };
+
+    /**
+     * @brief takeSnapshot Copy the search state into a free buffer and hand it to the writer
+     * @param _sol
+     * @param _finished
+     */
+    void takeSnapshot(EOT const &_sol, bool _finished);
+
+    /**
+     * @brief updateBest
+     * @param _sol
+     */
+    void updateBest(EOT const &_sol);
+
+    /**
+     * @brief rebuild Schedule the exams of period lists [_periodStart, _exams, _rooms] into _sol
+     */
+    void rebuild(EOT &_sol, std::vector<int32_t> const &_periodStart, std::vector<int32_t> const &_exams,
+                 std::vector<int32_t> const &_rooms) const;
+
+    /**
+     * @brief getThreshold
+     * @return Current threshold, as set by moSimpleCoolingSchedule
+     */
+    double getThreshold() const;
+
+    /**
+     * @brief writerLoop Body of the writer thread
+     */
+    void writerLoop();
+
+    /**
+     * @brief write Write _snapshot to the checkpoint file
+     * @param _snapshot
+     * @return false if the file couldn't be written
+     */
+    bool write(Snapshot const &_snapshot) const;
+
+    //
+    // Fields
+    //
+    // Checkpoint file
+    std::string filename;
+    // # iterations between checkpoints
+    unsigned long interval;
+    // Problem data
+    TimetableProblemData const *timetableProblemData;
+    // Cooling schedule
+    moSimpleCoolingSchedule<EOT> &coolSchedule;
+    // # evaluations counter
+    eoNumberEvalsCounter &numEvalsCounter;
+    // Random number generator
+    eoRng &gen;
+    // Optional extra state
+    moCheckpointState *state;
+    // # iterations done
+    uint64_t iteration;
+    // # iterations after which the search is stopped, or 0
+    uint64_t stopIteration;
+    // true if the search state was restored by resume
+    bool resumed;
+    // true if the restored checkpoint was the final one
+    bool finished;
+    // Best solution, by exam
+    std::vector<int32_t> bestPeriods;
+    std::vector<int32_t> bestRooms;
+    double bestFitness;
+    long bestCost;
+    // Double buffer: the search thread fills the buffer the writer is not using
+    Snapshot buffers[2];
+    // Buffer being written, or -1
+    int writing;
+    // Buffer waiting for the writer, or -1
+    int pending;
+    // Set to stop the writer thread
+    bool stop;
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::thread writer;
+};
+
+
+
+/////////////////////////////////////////////////////////////////
+//
+// Public members
+//
+/////////////////////////////////////////////////////////////////
+
+
+
+template <class Neighbor>
+moTACheckpoint<Neighbor>::moTACheckpoint(std::string const &_filename, unsigned long _interval,
+                                         TimetableProblemData const *_timetableProblemData,
+                                         moSimpleCoolingSchedule<EOT> &_coolSchedule,
+                                         eoNumberEvalsCounter &_numEvalsCounter, eoRng &_gen)
+    : filename(_filename), interval(_interval), timetableProblemData(_timetableProblemData),
+      coolSchedule(_coolSchedule), numEvalsCounter(_numEvalsCounter), gen(_gen), state(nullptr),
+      iteration(0), stopIteration(0), resumed(false), finished(false),
+      bestFitness(std::numeric_limits<double>::max()), bestCost(0),
+      writing(-1), pending(-1), stop(false)
+{
+    if (_interval == 0)
+        throw std::runtime_error("moTACheckpoint: checkpoint interval must be positive");
+    writer = std::thread(&moTACheckpoint<Neighbor>::writerLoop, this);
+}
+
+
+
+template <class Neighbor>
+moTACheckpoint<Neighbor>::~moTACheckpoint() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    cond.notify_all();
+    writer.join();
+}
+
+
+
+template <class Neighbor>
+void moTACheckpoint<Neighbor>::setState(moCheckpointState *_state) {
+    state = _state;
+}
+
+
+
+template <class Neighbor>
+void moTACheckpoint<Neighbor>::setStopIteration(uint64_t _iteration) {
+    stopIteration = _iteration;
+}
+
+
+
+template <class Neighbor>
+bool moTACheckpoint<Neighbor>::resume(EOT &_sol) {
+    if (access(filename.c_str(), R_OK) != 0)
+        return false;
+    MappedFile file(filename);
+    Header header;
+    if (file.size() < sizeof(Header))
+        throw std::runtime_error("moTACheckpoint: truncated checkpoint file " + filename);
+    std::memcpy(&header, file.begin(), sizeof(Header));
+    if (std::memcmp(header.magic, "FTATACK", 8) != 0 || header.version != VERSION
+            || header.headerSize != sizeof(Header))
+        throw std::runtime_error("moTACheckpoint: not a checkpoint file, or another version: " + filename);
+    if (header.numExams != timetableProblemData->getNumExams()
+            || header.numPeriods != timetableProblemData->getNumPeriods())
+        throw std::runtime_error("moTACheckpoint: checkpoint of another instance: " + filename);
+    uint64_t numInts = (header.numPeriods+1) + 4*(uint64_t)header.numExams + header.stateSize;
+    if (file.size() != sizeof(Header) + numInts*sizeof(int32_t) + header.rngStateSize)
+        throw std::runtime_error("moTACheckpoint: corrupt checkpoint file " + filename);
+
+    int numExams = header.numExams;
+    char const *p = file.begin() + sizeof(Header);
+    auto readInts = [&p](std::vector<int32_t> &_values, std::size_t _size) {
+        _values.resize(_size);
+        if (_size > 0)
+            std::memcpy(_values.data(), p, _size*sizeof(int32_t));
+        p += _size*sizeof(int32_t);
+    };
+    std::vector<int32_t> periodStart, periodExams, periodRooms, savedState;
+    readInts(periodStart, header.numPeriods+1);
+    readInts(periodExams, numExams);
+    readInts(periodRooms, numExams);
+    readInts(bestPeriods, numExams);
+    readInts(bestRooms, numExams);
+    readInts(savedState, header.stateSize);
+    std::string rngState(p, header.rngStateSize);
+
+    if (periodStart[0] != 0 || periodStart[header.numPeriods] != numExams)
+        throw std::runtime_error("moTACheckpoint: corrupt checkpoint file " + filename);
+    for (int pi = 0; pi < header.numPeriods; ++pi) {
+        if (periodStart[pi] > periodStart[pi+1])
+            throw std::runtime_error("moTACheckpoint: corrupt checkpoint file " + filename);
+    }
+
+    // Current solution
+    rebuild(_sol, periodStart, periodExams, periodRooms);
+    _sol.setSolutionCost(header.currentCost);
+    _sol.fitness(header.currentFitness);
+    // Best solution
+    bestFitness = header.bestFitness;
+    bestCost = header.bestCost;
+    // Cooling schedule: the next init() continues at (step, t)
+    coolSchedule.resume(header.step, header.t);
+    // Random number generator
+    std::istringstream is(rngState);
+    gen.readFrom(is);
+    // # evaluations
+    numEvalsCounter.setTotalNumEvals(header.totalNumEvals);
+    // Extra state
+    if (state != nullptr)
+        state->restoreState(std::vector<int>(savedState.begin(), savedState.end()));
+    iteration = header.iteration;
+    finished = (header.finished != 0);
+    resumed = true;
+
+#ifdef MOTACHECKPOINT_DEBUG
+    std::cout << "moTACheckpoint: resumed " << filename << " at iteration " << iteration
+              << ", q = " << header.q << ", fitness = " << header.currentFitness << std::endl;
+#endif
+    return true;
+}
+
+
+
+template <class Neighbor>
+bool moTACheckpoint<Neighbor>::isFinished() const {
+    return finished;
+}
+
+
+
+template <class Neighbor>
+void moTACheckpoint<Neighbor>::getBestSolution(EOT &_best) const {
+    int numExams = bestPeriods.size();
+    int numPeriods = timetableProblemData->getNumPeriods();
+    // Build period lists in exam order
+    std::vector<int32_t> periodStart(numPeriods+1, 0), exams(numExams), rooms(numExams);
+    for (int ei = 0; ei < numExams; ++ei)
+        ++periodStart[bestPeriods[ei]+1];
+    for (int pi = 0; pi < numPeriods; ++pi)
+        periodStart[pi+1] += periodStart[pi];
+    std::vector<int32_t> next(periodStart.begin(), periodStart.end()-1);
+    for (int ei = 0; ei < numExams; ++ei) {
+        int k = next[bestPeriods[ei]]++;
+        exams[k] = ei;
+        rooms[k] = bestRooms[ei];
+    }
+    rebuild(_best, periodStart, exams, rooms);
+    _best.setSolutionCost(bestCost);
+    _best.fitness(bestFitness);
+}
+
+
+
+template <class Neighbor>
+void moTACheckpoint<Neighbor>::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    cond.wait(lock, [this] { return pending == -1 && writing == -1; });
+}
+
+
+
+template <class Neighbor>
+void moTACheckpoint<Neighbor>::init(EOT &_sol) {
+    // A resumed search keeps the restored iteration count and best solution
+    if (resumed) {
+        resumed = false;
+        return;
+    }
+    iteration = 0;
+    bestFitness = std::numeric_limits<double>::max();
+    updateBest(_sol);
+}
+
+
+
+template <class Neighbor>
+bool moTACheckpoint<Neighbor>::operator()(EOT &_sol) {
+    ++iteration;
+    if (_sol.fitness() < bestFitness)
+        updateBest(_sol);
+    // No periodic checkpoint when the search is about to stop: lastCall writes the final one
+    if (iteration % interval == 0 && coolSchedule(getThreshold()))
+        takeSnapshot(_sol, false);
+    return stopIteration == 0 || iteration < stopIteration;
+}
+
+
+
+template <class Neighbor>
+void moTACheckpoint<Neighbor>::lastCall(EOT &_sol) {
+    // A search stopped at the stop iteration goes on when resumed, unless the cooling
+    // schedule would have stopped it there too
+    bool stopped = stopIteration != 0 && iteration >= stopIteration;
+    takeSnapshot(_sol, !stopped || !coolSchedule(getThreshold()));
+    flush();
+}
+
+
+
+/////////////////////////////////////////////////////////////////
+//
+// Protected members
+//
+/////////////////////////////////////////////////////////////////
+
+
+
+template <class Neighbor>
+void moTACheckpoint<Neighbor>::takeSnapshot(EOT const &_sol, bool _finished) {
+    std::unique_lock<std::mutex> lock(mutex);
+    // Fill the buffer the writer is not using. A pending snapshot the writer
+    // didn't get to yet is replaced by this one.
+    int free = (writing == 0) ? 1 : 0;
+    Snapshot &snapshot = buffers[free];
+    Header &header = snapshot.header;
+    std::memset(&header, 0, sizeof(Header));
+    std::memcpy(header.magic, "FTATACK", 8);
+    header.version = VERSION;
+    header.headerSize = sizeof(Header);
+    header.numExams = _sol.getNumExams();
+    header.numPeriods = _sol.getNumPeriods();
+    header.finished = _finished;
+    header.step = coolSchedule.step;
+    header.t = coolSchedule.t;
+    header.iteration = iteration;
+    header.totalNumEvals = numEvalsCounter.getTotalNumEvals();
+    header.currentCost = _sol.getSolutionCost();
+    header.bestCost = bestCost;
+    header.q = getThreshold();
+    header.currentFitness = _sol.fitness();
+    header.bestFitness = bestFitness;
+
+    // Current solution, in period exam list order
+    TimetableContainer const &timetableCont = _sol.getTimetableContainer();
+    snapshot.periodStart.resize(header.numPeriods+1);
+    snapshot.periodExams.clear();
+    snapshot.periodRooms.clear();
+    snapshot.periodStart[0] = 0;
+    for (int pi = 0; pi < header.numPeriods; ++pi) {
+        for (auto const &examRoom : timetableCont.getPeriodExams(pi)) {
+            snapshot.periodExams.push_back(std::get<0>(examRoom));
+            snapshot.periodRooms.push_back(std::get<1>(examRoom));
+        }
+        snapshot.periodStart[pi+1] = snapshot.periodExams.size();
+    }
+    snapshot.bestPeriods = bestPeriods;
+    snapshot.bestRooms = bestRooms;
+    snapshot.state.clear();
+    if (state != nullptr)
+        state->saveState(snapshot.state);
+    header.stateSize = snapshot.state.size();
+    std::ostringstream os;
+    gen.printOn(os);
+    snapshot.rngState = os.str();
+    header.rngStateSize = snapshot.rngState.size();
+
+    pending = free;
+    lock.unlock();
+    cond.notify_all();
+}
+
+
+
+template <class Neighbor>
+void moTACheckpoint<Neighbor>::updateBest(EOT const &_sol) {
+    auto const &scheduledExamsVector = _sol.getScheduledExamsVector();
+    int numExams = scheduledExamsVector.size();
+    bestPeriods.resize(numExams);
+    bestRooms.resize(numExams);
+    for (int ei = 0; ei < numExams; ++ei) {
+        bestPeriods[ei] = scheduledExamsVector[ei].getPeriod();
+        bestRooms[ei] = scheduledExamsVector[ei].getRoom();
+    }
+    bestFitness = _sol.fitness();
+    bestCost = _sol.getSolutionCost();
+}
+
+
+
+template <class Neighbor>
+void moTACheckpoint<Neighbor>::rebuild(EOT &_sol, std::vector<int32_t> const &_periodStart,
+                                       std::vector<int32_t> const &_exams,
+                                       std::vector<int32_t> const &_rooms) const {
+    int numExams = timetableProblemData->getNumExams();
+    int numPeriods = timetableProblemData->getNumPeriods();
+    int numRooms = timetableProblemData->getNumRooms();
+    // Create an empty timetable
+    _sol.setTimetableProblemData(timetableProblemData);
+    TimetableContainer &timetableCont = _sol.getTimetableContainer();
+    std::vector<bool> scheduled(numExams, false);
+    for (int pi = 0; pi < numPeriods; ++pi) {
+        for (int k = _periodStart[pi]; k < _periodStart[pi+1]; ++k) {
+            int ei = _exams[k], rk = _rooms[k];
+            if (ei < 0 || ei >= numExams || scheduled[ei] || rk < 0 || rk >= numRooms)
+                throw std::runtime_error("moTACheckpoint: corrupt checkpoint file " + filename);
+            scheduled[ei] = true;
+            timetableCont.scheduleExam(ei, pi, rk);
+        }
+    }
+    // Checkpoints only hold feasible solutions
+    _sol.setFeasible(true);
+}
+
+
+
+template <class Neighbor>
+double moTACheckpoint<Neighbor>::getThreshold() const {
+    // moSimpleCoolingSchedule sets q = initT, then q = Temp(t, initT, alpha) each time t is incremented
+    return coolSchedule.t == 0 ? coolSchedule.initT : coolSchedule.Temp(coolSchedule.t, coolSchedule.initT, coolSchedule.alpha);
+}
+
+
+
+template <class Neighbor>
+void moTACheckpoint<Neighbor>::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        cond.wait(lock, [this] { return pending != -1 || stop; });
+        if (pending == -1)
+            break;
+        writing = pending;
+        pending = -1;
+        lock.unlock();
+        write(buffers[writing]);
+        lock.lock();
+        writing = -1;
+        cond.notify_all();
+    }
+}
+
+
+
+template <class Neighbor>
+bool moTACheckpoint<Neighbor>::write(Snapshot const &_snapshot) const {
+    auto writeInts = [](std::ostream &_os, std::vector<int32_t> const &_values) {
+        if (!_values.empty())
+            _os.write(reinterpret_cast<char const *>(_values.data()), _values.size()*sizeof(int32_t));
+    };
+    std::string tmpFilename = filename + ".tmp." + std::to_string(getpid());
+    {
+        std::ofstream os(tmpFilename.c_str(), std::ios::binary | std::ios::trunc);
+        if (!os.is_open()) {
+            std::cerr << "Couldn't write checkpoint: " << filename << std::endl;
+            return false;
+        }
+        os.write(reinterpret_cast<char const *>(&_snapshot.header), sizeof(Header));
+        writeInts(os, _snapshot.periodStart);
+        writeInts(os, _snapshot.periodExams);
+        writeInts(os, _snapshot.periodRooms);
+        writeInts(os, _snapshot.bestPeriods);
+        writeInts(os, _snapshot.bestRooms);
+        writeInts(os, std::vector<int32_t>(_snapshot.state.begin(), _snapshot.state.end()));
+        os.write(_snapshot.rngState.data(), _snapshot.rngState.size());
+        if (!os) {
+            std::remove(tmpFilename.c_str());
+            std::cerr << "Couldn't write checkpoint: " << filename << std::endl;
+            return false;
+        }
+    }
+    if (std::rename(tmpFilename.c_str(), filename.c_str()) != 0) {
+        std::remove(tmpFilename.c_str());
+        std::cerr << "Couldn't write checkpoint: " << filename << std::endl;
+        return false;
+    }
+#ifdef MOTACHECKPOINT_DEBUG
+    std::cout << "moTACheckpoint: iteration " << _snapshot.header.iteration << " written to " << filename << std::endl;
+#endif
+    return true;
+}
+
+
+
+#endif // MOTACHECKPOINT_H
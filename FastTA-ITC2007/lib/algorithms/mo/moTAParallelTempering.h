@@ -0,0 +1,329 @@
+#ifndef MOTAPARALLELTEMPERING_H
+#define MOTAPARALLELTEMPERING_H
+
+#include <eoFunctor.h>
+#include <utils/eoRNG.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <vector>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+#include "algorithms/mo/moTA.h"
+#include "algorithms/mo/moSimpleCoolingSchedule.h"
+#include "algorithms/mo/moFixedThresholdSchedule.h"
+#include "kempeChain/ETTPKempeChainHeuristic.h"
+#include "neighbourhood/ETTPneighbor.h"
+#include "neighbourhood/ETTPneighborhood.h"
+#include "neighbourhood/statistics/ETTPneighborEvalNumEvalsCounter.h"
+#include "eval/eoETTPEvalNumberEvalsCounter.h"
+#include "eval/eoNumberEvalsCounter.h"
+#include "eval/eoShardedNumberEvalsCounter.h"
+#include "utils/WorkStealingPool.h"
+
+
+// For debugging purposes
+//#define MOTAPARALLELTEMPERING_DEBUG
+
+
+
+/**
+ * Replica-exchange (parallel tempering) Threshold Accepting algorithm.
+ *
+ * R replicas run concurrently on a pool of R workers, at fixed thresholds spread
+ * geometrically over the [finalT, initT] range of a moSimpleCoolingSchedule.
+ * After each round of _exchangeInterval iterations, adjacent replicas (i, i+1)
+ * exchange their solutions with probability
+ *   min(1, exp((f_i - f_{i+1}) * (1/q_i - 1/q_{i+1})))
+ * where q_i > q_{i+1}. Even and odd pairs are tried in alternate rounds.
+ * Solutions are exchanged by swapping their handles, no copy is made. The workers
+ * persist across rounds, so no thread is started in the exchange loop.
+ */
+template <typename EOT>
+class moTAParallelTempering : public eoUF<EOT&, bool>
+{
+public:
+    /**
+     * Constructor
+     * @param _coolSchedule cooling schedule from which the thresholds range is taken
+     * @param _numReplicas number of replicas (pool workers)
+     * @param _exchangeInterval number of iterations each replica performs between exchanges
+     * @param _maxNumEvals total number of neighbour evaluations, over all replicas
+     * @param _numEvalsCounter # evaluations counter
+     * @param _seed seed of the replicas' random number generators
+     */
+    moTAParallelTempering(moSimpleCoolingSchedule<EOT> const &_coolSchedule, unsigned _numReplicas,
+                          unsigned long _exchangeInterval, long _maxNumEvals,
+                          eoNumberEvalsCounter &_numEvalsCounter, uint32_t _seed);
+
+    /**
+     * @brief operator () Run the replicas starting from _sol. On return, _sol holds
+     * the best solution found
+     * @param _sol
+     * @return
+     */
+    virtual bool operator()(EOT &_sol);
+
+    /**
+     * @brief getThresholds
+     * @return Replicas thresholds, from the highest to the lowest
+     */
+    std::vector<double> const &getThresholds() const;
+
+    /**
+     * @brief printExchangeStatistics Print, for each adjacent pair, the
+     * exchange acceptance rate
+     * @param _os
+     */
+    void printExchangeStatistics(std::ostream &_os) const;
+
+protected:
+    /**
+     * @brief The Replica struct. Holds the solution handle and the search
+     * objects of one replica. Nothing is shared between replicas except the
+     * read-only problem data.
+     */
+    struct Replica {
+        Replica(double _threshold, unsigned long _exchangeInterval, uint32_t _seed,
+                eoNumberEvalsCounter &_numEvalsCounter)
+            : gen(_seed),
+              kempeChainHeuristic(new ETTPKempeChainHeuristic<EOT>(gen)),
+              neighborhood(kempeChainHeuristic),
+              fullEval(_numEvalsCounter),
+              neighEval(_numEvalsCounter),
+              coolSchedule(_threshold, _exchangeInterval),
+              ta(neighborhood, fullEval, neighEval, coolSchedule) { }
+
+        // Current solution
+        boost::shared_ptr<EOT> solution;
+        // Random number generator
+        eoRng gen;
+        // Kempe chain heuristic
+        boost::shared_ptr<ETTPKempeChainHeuristic<EOT> > kempeChainHeuristic;
+        // Neighbourhood
+        ETTPneighborhood<EOT> neighborhood;
+        // Full evaluation
+        eoETTPEvalNumberEvalsCounter<EOT> fullEval;
+        // Neighbour evaluation
+        ETTPneighborEvalNumEvalsCounter<EOT> neighEval;
+        // Fixed threshold schedule
+        moFixedThresholdSchedule<EOT> coolSchedule;
+        // Threshold Accepting algorithm
+        moTA<ETTPneighbor<EOT> > ta;
+    };
+
+    /**
+     * @brief exchange Try to exchange the solutions of adjacent replicas
+     * starting at replica _first
+     * @param _first
+     */
+    void exchange(unsigned _first);
+
+    //
+    // Fields
+    //
+    /**
+     * @brief thresholds Replicas thresholds, from the highest to the lowest
+     */
+    std::vector<double> thresholds;
+    /**
+     * @brief exchangeInterval Number of iterations between exchanges
+     */
+    unsigned long exchangeInterval;
+    /**
+     * @brief maxNumEvals Total number of evaluations
+     */
+    long maxNumEvals;
+    /**
+     * @brief numEvalsCounter # evaluations counter
+     */
+    eoNumberEvalsCounter &numEvalsCounter;
+    /**
+     * @brief seed
+     */
+    uint32_t seed;
+    /**
+     * @brief pool Workers running the replicas, one per replica
+     */
+    WorkStealingPool pool;
+    /**
+     * @brief exchangeGen Random number generator used in the exchanges
+     */
+    eoRng exchangeGen;
+    /**
+     * @brief replicaNumEvals # evaluations of the replicas
+     */
+    boost::shared_ptr<eoShardedNumberEvalsCounter> replicaNumEvals;
+    /**
+     * @brief replicas
+     */
+    std::vector<boost::shared_ptr<Replica> > replicas;
+    /**
+     * @brief numExchangeAttempts # exchange attempts per adjacent pair
+     */
+    std::vector<long> numExchangeAttempts;
+    /**
+     * @brief numExchangesAccepted # accepted exchanges per adjacent pair
+     */
+    std::vector<long> numExchangesAccepted;
+};
+
+
+
+/////////////////////////////////////////////////////////////////
+//
+// Public members
+//
+/////////////////////////////////////////////////////////////////
+
+
+
+/**
+ * @brief moTAParallelTempering Constructor
+ */
+template <typename EOT>
+moTAParallelTempering<EOT>::moTAParallelTempering(moSimpleCoolingSchedule<EOT> const &_coolSchedule,
+                                                  unsigned _numReplicas, unsigned long _exchangeInterval,
+                                                  long _maxNumEvals, eoNumberEvalsCounter &_numEvalsCounter,
+                                                  uint32_t _seed)
+    : exchangeInterval(_exchangeInterval), maxNumEvals(_maxNumEvals),
+      numEvalsCounter(_numEvalsCounter), seed(_seed), pool(_numReplicas), exchangeGen(_seed),
+      numExchangeAttempts(_numReplicas > 0 ? _numReplicas-1 : 0, 0),
+      numExchangesAccepted(_numReplicas > 0 ? _numReplicas-1 : 0, 0)
+{
+    if (_numReplicas < 2)
+        throw std::runtime_error("moTAParallelTempering: at least two replicas are required");
+    if (_coolSchedule.finalT <= 0 || _coolSchedule.initT <= _coolSchedule.finalT)
+        throw std::runtime_error("moTAParallelTempering: invalid cooling schedule thresholds range");
+    if (_exchangeInterval == 0)
+        throw std::runtime_error("moTAParallelTempering: exchange interval must be positive");
+    //
+    // Thresholds are spread geometrically between initT and finalT, matching
+    // the exponential decay of moSimpleCoolingSchedule
+    //
+    double ratio = _coolSchedule.finalT / _coolSchedule.initT;
+    for (unsigned i = 0; i < _numReplicas; ++i)
+        thresholds.push_back(_coolSchedule.initT * pow(ratio, (double)i / (_numReplicas-1)));
+}
+
+
+
+/**
+ * @brief operator () Run the replicas starting from _sol
+ */
+template <typename EOT>
+bool moTAParallelTempering<EOT>::operator()(EOT &_sol) {
+    unsigned numReplicas = thresholds.size();
+    // # evaluations, one shard per replica
+    replicaNumEvals = boost::make_shared<eoShardedNumberEvalsCounter>(numReplicas);
+    // Create replicas. Each replica starts from a copy of the initial solution.
+    replicas.clear();
+    for (unsigned i = 0; i < numReplicas; ++i) {
+        auto replica = boost::make_shared<Replica>(thresholds[i], exchangeInterval, seed+i+1,
+                                                   replicaNumEvals->getShard(i));
+        replica->solution = boost::make_shared<EOT>(_sol);
+        replicas.push_back(replica);
+    }
+    // Best solution found
+    boost::shared_ptr<EOT> bestSolution = boost::make_shared<EOT>(_sol);
+    // Number of exchange rounds
+    long numRounds = maxNumEvals / ((long)exchangeInterval*numReplicas);
+    if (numRounds < 1)
+        numRounds = 1;
+
+    std::cout << "moTAParallelTempering: " << numReplicas << " replicas, " << numRounds
+              << " rounds of " << exchangeInterval << " iterations" << std::endl;
+    std::cout << "Thresholds:";
+    for (double q : thresholds)
+        std::cout << " " << q;
+    std::cout << std::endl;
+
+    for (long round = 0; round < numRounds && !replicaNumEvals->isBudgetExhausted(maxNumEvals); ++round) {
+        // Run each replica at its threshold for exchangeInterval iterations
+        pool.parallelFor(numReplicas, [this](unsigned _i, unsigned) {
+            Replica *replica = replicas[_i].get();
+            replica->ta(*replica->solution);
+        });
+        // Record best solution
+        for (auto const &replica : replicas) {
+            if (replica->solution->fitness() < bestSolution->fitness()) {
+                *bestSolution = *replica->solution;
+#ifdef MOTAPARALLELTEMPERING_DEBUG
+                std::cout << "Round " << round << ": new best solution = " << bestSolution->fitness() << std::endl;
+#endif
+            }
+        }
+        // Exchange solutions between adjacent replicas. Even and odd pairs alternate.
+        exchange(round % 2);
+    }
+    // Collect # evaluations
+    auto snap = replicaNumEvals->snapshot();
+    std::cout << "moTAParallelTempering: " << snap.totalNumEvals << " evaluations, "
+              << eoShardedNumberEvalsCounter::evalsPerSecond(eoShardedNumberEvalsCounter::Snapshot(), snap)
+              << " evaluations/s" << std::endl;
+    numEvalsCounter.addNumEvalsToTotal(snap.totalNumEvals);
+    // Return best solution
+    _sol = *bestSolution;
+    return true;
+}
+
+
+
+/**
+ * @brief getThresholds
+ */
+template <typename EOT>
+std::vector<double> const &moTAParallelTempering<EOT>::getThresholds() const {
+    return thresholds;
+}
+
+
+
+/**
+ * @brief printExchangeStatistics
+ */
+template <typename EOT>
+void moTAParallelTempering<EOT>::printExchangeStatistics(std::ostream &_os) const {
+    _os << "Exchange acceptance rates:" << std::endl;
+    for (unsigned i = 0; i < numExchangeAttempts.size(); ++i) {
+        double rate = numExchangeAttempts[i] > 0 ? (double)numExchangesAccepted[i] / numExchangeAttempts[i] : 0;
+        _os << "q = " << thresholds[i] << " <-> q = " << thresholds[i+1] << ": "
+            << numExchangesAccepted[i] << "/" << numExchangeAttempts[i] << " (" << rate << ")" << std::endl;
+    }
+}
+
+
+
+/////////////////////////////////////////////////////////////////
+//
+// Protected members
+//
+/////////////////////////////////////////////////////////////////
+
+
+
+/**
+ * @brief exchange Try to exchange the solutions of adjacent replicas
+ * starting at replica _first
+ */
+template <typename EOT>
+void moTAParallelTempering<EOT>::exchange(unsigned _first) {
+    for (unsigned i = _first; i+1 < replicas.size(); i += 2) {
+        double fi = replicas[i]->solution->fitness();
+        double fj = replicas[i+1]->solution->fitness();
+        // Metropolis criterion: thresholds play the role of temperatures.
+        // A better solution at the higher threshold is always moved down.
+        double delta = (fi - fj) * (1.0/thresholds[i] - 1.0/thresholds[i+1]);
+        ++numExchangeAttempts[i];
+        if (delta >= 0 || exchangeGen.uniform() < exp(delta)) {
+            // Exchange handles
+            replicas[i]->solution.swap(replicas[i+1]->solution);
+            ++numExchangesAccepted[i];
+        }
+    }
+}
+
+
+
+#endif // MOTAPARALLELTEMPERING_H
@@ -0,0 +1,60 @@
+#ifndef MOTASPECULATIVE_H
+#define MOTASPECULATIVE_H
+
+#include <algo/moLocalSearch.h>
+#include "algorithms/mo/moTAexplorerSpeculative.h"
+#include <continuator/moTrueContinuator.h>
+#include <eoEvalFunc.h>
+#include "algorithms/mo/moSimpleCoolingSchedule.h"
+#include "neighbourhood/ETTPneighborhood.h"
+#include "neighbourhood/ETTPneighborEval.h"
+
+
+/**
+ * Threshold Accepting algorithm with speculative parallel neighbour evaluation.
+ * Follows a single trajectory, as moTA, but evaluates _numLanes candidate moves
+ * concurrently (see moTAexplorerSpeculative).
+ */
+template<class EOT>
+class moTASpeculative: public moLocalSearch<ETTPneighbor<EOT> >
+{
+public:
+
+    typedef ETTPneighbor<EOT> Neighbor;
+
+    /**
+     * Constructor
+     * @param _fullEval the full evaluation function
+     * @param _cool a cooling schedule
+     * @param _numEvalsCounter # evaluations counter
+     * @param _numLanes number of candidates evaluated concurrently
+     * @param _seed seed of the lanes' random number generators
+     */
+    moTASpeculative(eoEvalFunc<EOT>& _fullEval, moCoolingSchedule<EOT>& _cool,
+                    eoNumberEvalsCounter &_numEvalsCounter, unsigned _numLanes, uint32_t _seed):
+            moLocalSearch<Neighbor>(explorer, trueCont, _fullEval),
+            kempeChainHeuristic(new ETTPKempeChainHeuristic<EOT>()),
+            neighborhood(kempeChainHeuristic),
+            explorer(neighborhood, neighEval, defaultSolNeighborComp, _cool, _numEvalsCounter, _numLanes, _seed)
+    {}
+
+    /**
+     * @brief getNumDiscarded
+     * @return # candidates evaluated but discarded because another move was accepted
+     */
+    long getNumDiscarded() const {
+        return explorer.getNumDiscarded();
+    }
+
+private:
+    moTrueContinuator<Neighbor> trueCont;
+    moSolNeighborComparator<Neighbor> defaultSolNeighborComp;
+    boost::shared_ptr<ETTPKempeChainHeuristic<EOT> > kempeChainHeuristic;
+    ETTPneighborhood<EOT> neighborhood;
+    ETTPneighborEval<EOT> neighEval;
+    moTAexplorerSpeculative<EOT> explorer;
+};
+
+
+
+#endif // MOTASPECULATIVE_H
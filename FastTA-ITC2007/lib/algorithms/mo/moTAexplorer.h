@@ -11,6 +11,9 @@
 
 
 #include "neighbourhood/ETTPneighbor.h"
+#include "utils/TraceSink.h"
+#include "utils/SearchTelemetry.h"
+#include "utils/MoveLog.h"
 
 
 //#define MOTAEXPLORER_DEBUG
@@ -44,7 +47,8 @@ public:
   moTAexplorer(Neighborhood& _neighborhood, moEval<Neighbor>& _eval,
                moSolNeighborComparator<Neighbor>& _solNeighborComparator, moCoolingSchedule<EOT>& _coolingSchedule)
       : ETTPNeighborhoodExplorer<Neighbor>(_neighborhood, _eval),
-        solNeighborComparator(_solNeighborComparator), coolingSchedule(_coolingSchedule) {
+        solNeighborComparator(_solNeighborComparator), coolingSchedule(_coolingSchedule), telemetry(nullptr),
+        moveLog(nullptr) {
 
         isAccept = false;
 
@@ -68,6 +72,11 @@ public:
 
         isAccept = false;
 
+        if (tracer.isEnabled())
+            tracer.start(q, _solution.fitness());
+        ETTP_TELEMETRY_HOOK(telemetry, setThreshold(q));
+        ETTP_TELEMETRY_HOOK(telemetry, start());
+
         //        cout << "Initial solution: " << _solution.fitness() << endl;
     }
 
@@ -76,8 +85,23 @@ public:
      * @param _solution unused solution
      */
     virtual void updateParam(EOT & _solution) {
+        double previousQ = q;
         // q = g(q); // Threshold update
         coolingSchedule.update(q, this->moveApplied());
+        ETTP_TELEMETRY_HOOK(telemetry, moveDone(this->moveApplied()));
+        if (q != previousQ)
+            ETTP_TELEMETRY_HOOK(telemetry, setThreshold(q));
+        if (tracer.isEnabled()) {
+            tracer.iteration(_solution.fitness(), this->moveApplied());
+            if (q != previousQ)
+                tracer.thresholdChanged(q, _solution.fitness());
+        }
+        if (moveLog) {
+            // Downcast selectedNeighbor to ETTPneigbor
+            Neighbor *selectedNeighborPtr = &selectedNeighbor;
+            ETTPneighbor<EOT> *neighbourPtr = (ETTPneighbor<EOT> *)selectedNeighborPtr;
+            moveLog->move(MoveLog::makeRecord(*neighbourPtr, _solution, this->moveApplied()));
+        }
 
 
 ///
@@ -101,10 +125,41 @@ public:
     }
 
     /**
-     * terminate: NOTHING TO DO
-     * @param _solution unused solution
+     * terminate: trace the end of the search and finish the move log
+     * @param _solution the solution
      */
-    virtual void terminate(EOT & _solution) { }
+    virtual void terminate(EOT & _solution) {
+        if (tracer.isEnabled())
+            tracer.end(q, _solution.fitness());
+        ETTP_TELEMETRY_HOOK(telemetry, stop());
+        if (moveLog)
+            moveLog->finish();
+    }
+
+    /**
+     * Trace the search to _sink (nullptr disables tracing)
+     * @param _sink the trace sink
+     * @param _interval trace every _interval-th threshold change
+     */
+    void setTrace(TraceSink *_sink, unsigned long _interval = 1) {
+        tracer.setSink(_sink, _interval);
+    }
+
+    /**
+     * Count the moves in _telemetry (nullptr disables the counters)
+     * @param _telemetry the search telemetry counters
+     */
+    void setTelemetry(SearchTelemetry *_telemetry) {
+        telemetry = _telemetry;
+    }
+
+    /**
+     * Record the moves in _moveLog, or compare them with it (nullptr disables the log)
+     * @param _moveLog the move log
+     */
+    void setMoveLog(MoveLog *_moveLog) {
+        moveLog = _moveLog;
+    }
 
     /**
      * Explore one random solution in the neighborhood
@@ -171,6 +226,7 @@ public:
             ETTPneighbor<EOT> *neighbourPtr = (ETTPneighbor<EOT> *)selectedNeighborPtr;
             if (neighbourPtr != nullptr && !neighbourPtr->isFeasible()) {
                 isAccept = false;
+                ETTP_TELEMETRY_HOOK(telemetry, moveInfeasible());
 #ifdef MOTAEXPLORER_DEBUG
             std::cout << "In [moTAexplorer::accept(sol)] method:" << std::endl;
             std::cout << "Infeasible solution, it will not be accepted. Generating a new one..." << std::endl;
@@ -208,6 +264,12 @@ protected:
     // TA parameters
     double q; // Current threshold
     moCoolingSchedule<EOT> &coolingSchedule;
+    // Search trace
+    SearchTracer tracer;
+    // Search telemetry counters, if any
+    SearchTelemetry *telemetry;
+    // Move log being recorded or replayed, if any
+    MoveLog *moveLog;
 };
 
 
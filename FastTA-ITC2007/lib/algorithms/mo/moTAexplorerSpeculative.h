@@ -0,0 +1,232 @@
+#ifndef MOTAEXPLORERSPECULATIVE_H
+#define MOTAEXPLORERSPECULATIVE_H
+
+
+#include <utils/eoRNG.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "algorithms/mo/moTAexplorer.h"
+#include "kempeChain/ETTPKempeChainHeuristic.h"
+#include "neighbourhood/ETTPneighbor.h"
+#include "eval/eoNumberEvalsCounter.h"
+
+
+//#define MOTAEXPLORERSPECULATIVE_DEBUG
+
+
+/**
+ * Explorer for the Threshold Accepting algorithm with speculative parallel
+ * neighbour evaluation.
+ *
+ * Each of the K lanes (the calling thread plus K-1 worker threads) owns a
+ * Kempe chain heuristic, a random number generator and a mirror of the
+ * current solution. When no evaluated candidate is left, every lane builds
+ * and evaluates one candidate against its mirror, concurrently. The
+ * candidates are then consumed in lane order, one per iteration, with the
+ * usual TA threshold test. Because all candidates of a batch were evaluated
+ * against the same solution, their deltas stay exact until one of them is
+ * accepted. The accepted move is replayed on every mirror and the remaining
+ * candidates of the batch are discarded.
+ */
+template <class EOT>
+class moTAexplorerSpeculative : public moTAexplorer<ETTPneighbor<EOT> >
+{
+public:
+    typedef ETTPneighbor<EOT> Neighbor;
+    typedef moNeighborhood<Neighbor> Neighborhood;
+
+    using moNeighborhoodExplorer<Neighbor>::selectedNeighbor;
+
+    /**
+     * Constructor
+     * @param _neighborhood the neighborhood (not used to generate candidates)
+     * @param _eval the evaluation function (not used to evaluate candidates)
+     * @param _solNeighborComparator a solution vs neighbor comparator
+     * @param _coolingSchedule the cooling schedule
+     * @param _numEvalsCounter # evaluations counter
+     * @param _numLanes number of candidates evaluated concurrently
+     * @param _seed seed of the lanes' random number generators
+     */
+    moTAexplorerSpeculative(Neighborhood& _neighborhood, moEval<Neighbor>& _eval,
+                            moSolNeighborComparator<Neighbor>& _solNeighborComparator,
+                            moCoolingSchedule<EOT>& _coolingSchedule,
+                            eoNumberEvalsCounter &_numEvalsCounter, unsigned _numLanes, uint32_t _seed)
+        : moTAexplorer<Neighbor>(_neighborhood, _eval, _solNeighborComparator, _coolingSchedule),
+          numEvalsCounter(_numEvalsCounter), nextCandidate(0), currentCandidate(0),
+          batchNumber(0), numPending(0), stopWorkers(false), numDiscarded(0)
+    {
+        if (_numLanes == 0)
+            _numLanes = 1;
+        for (unsigned i = 0; i < _numLanes; ++i)
+            lanes.push_back(boost::make_shared<Lane>(_seed+i+1));
+        nextCandidate = lanes.size();
+        // Lane 0 runs on the calling thread
+        for (unsigned i = 1; i < lanes.size(); ++i)
+            workers.push_back(std::thread(&moTAexplorerSpeculative<EOT>::workerLoop, this, i));
+    }
+
+    /**
+     * Destructor. Stop worker threads
+     */
+    ~moTAexplorerSpeculative() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopWorkers = true;
+        }
+        startCond.notify_all();
+        for (auto &worker : workers)
+            worker.join();
+    }
+
+    /**
+     * Initialization of the threshold and of the lanes' mirrors
+     * @param _solution the solution
+     */
+    virtual void initParam(EOT & _solution) {
+        moTAexplorer<Neighbor>::initParam(_solution);
+        // Copy current solution into every mirror
+        for (auto &lane : lanes)
+            lane->mirror = _solution;
+        // No evaluated candidate
+        nextCandidate = lanes.size();
+    }
+
+    /**
+     * Select the next evaluated candidate. A new batch is evaluated if there is none left.
+     * @param _solution the solution
+     */
+    virtual void operator()(EOT & _solution) {
+        if (nextCandidate >= lanes.size()) {
+            evaluateBatch();
+            nextCandidate = 0;
+        }
+        currentCandidate = nextCandidate++;
+        selectedNeighbor = lanes[currentCandidate]->neighbor;
+    }
+
+    /**
+     * Move the solution to the accepted candidate and replay the move on the mirrors
+     * @param _solution the solution
+     */
+    virtual void move(EOT & _solution) {
+        moTAexplorer<Neighbor>::move(_solution);
+        // Replay move on every mirror. The Kempe chain of the accepted candidate
+        // holds the final contents of periods ti and tj.
+        auto &acceptedNeighbor = lanes[currentCandidate]->neighbor;
+        for (auto &lane : lanes) {
+            acceptedNeighbor.move(lane->mirror);
+            lane->mirror.setSolutionCost(_solution.getSolutionCost());
+            lane->mirror.fitness(_solution.fitness());
+        }
+        // Candidates evaluated against the previous solution are discarded
+        numDiscarded += lanes.size() - nextCandidate;
+        nextCandidate = lanes.size();
+    }
+
+    /**
+     * @brief getNumDiscarded
+     * @return # candidates evaluated but discarded because another move was accepted
+     */
+    long getNumDiscarded() const {
+        return numDiscarded;
+    }
+
+protected:
+    /**
+     * @brief The Lane struct. Search objects of one lane
+     */
+    struct Lane {
+        Lane(uint32_t _seed)
+            : gen(_seed), kempeChainHeuristic(new ETTPKempeChainHeuristic<EOT>(gen)) {
+            neighbor.setKempeChainHeuristic(kempeChainHeuristic);
+        }
+        // Random number generator
+        eoRng gen;
+        // Kempe chain heuristic
+        boost::shared_ptr<ETTPKempeChainHeuristic<EOT> > kempeChainHeuristic;
+        // Candidate neighbour
+        Neighbor neighbor;
+        // Mirror of the current solution
+        EOT mirror;
+    };
+
+    /**
+     * @brief evaluateLane Build and evaluate the candidate of lane _i
+     * @param _i
+     */
+    void evaluateLane(unsigned _i) {
+        Lane &lane = *lanes[_i];
+        lane.neighbor.build(lane.mirror);
+        lane.neighbor.evaluateMove(lane.mirror);
+    }
+
+    /**
+     * @brief evaluateBatch Evaluate one candidate per lane, concurrently
+     */
+    void evaluateBatch() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            numPending = workers.size();
+            ++batchNumber;
+        }
+        startCond.notify_all();
+        // Lane 0 is evaluated on this thread
+        evaluateLane(0);
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            doneCond.wait(lock, [this]() { return numPending == 0; });
+        }
+        numEvalsCounter.addNumEvalsToTotal(lanes.size());
+    }
+
+    /**
+     * @brief workerLoop Worker thread body
+     * @param _i lane index
+     */
+    void workerLoop(unsigned _i) {
+        unsigned long lastBatch = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                startCond.wait(lock, [this, lastBatch]() { return stopWorkers || batchNumber != lastBatch; });
+                if (stopWorkers)
+                    return;
+                lastBatch = batchNumber;
+            }
+            evaluateLane(_i);
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                if (--numPending == 0)
+                    doneCond.notify_one();
+            }
+        }
+    }
+
+    // # evaluations counter
+    eoNumberEvalsCounter &numEvalsCounter;
+    // Lanes
+    std::vector<boost::shared_ptr<Lane> > lanes;
+    // Index of the next candidate to consume
+    unsigned nextCandidate;
+    // Index of the selected candidate
+    unsigned currentCandidate;
+    // Worker threads
+    std::vector<std::thread> workers;
+    // Synchronisation
+    std::mutex mtx;
+    std::condition_variable startCond;
+    std::condition_variable doneCond;
+    unsigned long batchNumber;
+    unsigned numPending;
+    bool stopWorkers;
+    // # discarded candidates
+    long numDiscarded;
+};
+
+
+#endif // MOTAEXPLORERSPECULATIVE_H
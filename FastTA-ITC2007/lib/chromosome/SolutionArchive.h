@@ -0,0 +1,470 @@
+#ifndef SOLUTIONARCHIVE_H
+#define SOLUTIONARCHIVE_H
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "chromosome/eoChromosome.h"
+#include "data/TimetableProblemData.hpp"
+#include "utils/MappedFile.h"
+
+
+/**
+ * @brief The SolutionArchive class. Binary archive of the solutions of one instance,
+ * e.g. all the runs of one algorithm variant on one dataset.
+ *
+ * The archive is a Header followed by fixed size records. Each record holds the run
+ * metadata (seed, cost and its breakdown by soft constraint, runtime, # evaluations)
+ * and the solution: the period of every exam, then the room of every exam, packed
+ * in one byte each when the instance has at most 256 periods and rooms, in two bytes
+ * otherwise. Records are padded to 8 bytes, so record i is at a fixed offset and the
+ * archive is read by mapping it.
+ *
+ * The header stores the instance hash (see TimetableProblemData::getInstanceHash), so
+ * a solution is never loaded into a different instance. Integers are in native byte
+ * order.
+ */
+class SolutionArchive {
+
+public:
+    /**
+     * @brief The Record struct. Run metadata stored ahead of each solution
+     */
+    struct Record {
+        // Random generator seed of the run, 0 if unknown (e.g. a run resumed from a checkpoint)
+        uint64_t seed;
+        // # evaluations performed
+        uint64_t numEvals;
+        // Solution cost
+        int64_t cost;
+        // Runtime in seconds
+        double runtime;
+        // Cost breakdown: two in a row, two in a day, period spread, mixed durations,
+        // front load, room penalty, period penalty
+        int32_t costBreakdown[7];
+        int32_t padding;
+    };
+
+    /**
+     * @brief getExtension
+     * @return File extension of solution archives
+     */
+    static std::string getExtension() { return ".slnb"; }
+
+protected:
+    // Archive format version. Increment whenever the layout changes.
+    static const uint32_t VERSION = 1;
+
+    /**
+     * @brief The Header struct
+     */
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        uint32_t recordSize;
+        int32_t numExams;
+        int32_t numPeriods;
+        int32_t numRooms;
+        // Bytes per packed period or room: 1 or 2
+        uint32_t fieldSize;
+        uint32_t padding;
+        uint64_t instanceHash;
+        // Algorithm (variant) name, zero terminated
+        char algorithm[16];
+    };
+
+    /**
+     * @brief makeHeader
+     * @param _timetableProblemData
+     * @param _algorithm
+     * @return Header of the archive of instance _timetableProblemData
+     */
+    inline static Header makeHeader(TimetableProblemData const *_timetableProblemData, std::string const &_algorithm);
+
+    /**
+     * @brief isCompatible
+     * @param _h1
+     * @param _h2
+     * @return true if records of _h1 and _h2 belong to the same archive
+     */
+    inline static bool isCompatible(Header const &_h1, Header const &_h2);
+};
+
+
+
+/**
+ * @brief The SolutionArchiveWriter class. Appends solutions to an archive, creating it
+ * if needed. Each record is appended with a single write() under an exclusive file lock,
+ * so several processes may add their runs to the same archive. A partial record left at
+ * the end by a writer killed mid-write is truncated before appending, so the following
+ * records stay at their fixed offsets (readers ignore a partial trailing record).
+ */
+class SolutionArchiveWriter : public SolutionArchive {
+
+public:
+    /**
+     * @brief SolutionArchiveWriter Open archive _filename. Throws std::runtime_error if it
+     * can't be opened, or if it holds solutions of another instance or algorithm.
+     * @param _filename
+     * @param _timetableProblemData
+     * @param _algorithm Algorithm name, at most 15 characters are kept
+     */
+    inline SolutionArchiveWriter(std::string const &_filename, TimetableProblemData const *_timetableProblemData,
+                                 std::string const &_algorithm);
+
+    inline ~SolutionArchiveWriter();
+
+    SolutionArchiveWriter(SolutionArchiveWriter const &) = delete;
+    SolutionArchiveWriter &operator=(SolutionArchiveWriter const &) = delete;
+
+    /**
+     * @brief append Append solution _chrom. Its cost breakdown is computed here.
+     * @param _chrom Complete solution
+     * @param _seed
+     * @param _runtime Seconds
+     * @param _numEvals
+     */
+    inline void append(eoChromosome const &_chrom, uint64_t _seed, double _runtime, uint64_t _numEvals);
+
+protected:
+    /**
+     * @brief truncatePartialRecord Truncate the archive to a whole number of records.
+     * Called with the file lock held.
+     * @return false if the file couldn't be stat'ed or truncated
+     */
+    inline bool truncatePartialRecord();
+
+    // Archive file name
+    std::string filename;
+    // Archive file descriptor
+    int fd;
+    // Archive header
+    Header header;
+    // Record buffer
+    std::vector<char> buffer;
+};
+
+
+
+/**
+ * @brief The SolutionArchiveReader class. Maps an archive and decodes its records.
+ * Decoding widens the packed periods and rooms to int in tight loops over contiguous
+ * bytes, which the compiler vectorises; loading thousands of solutions is bound by
+ * the memory bandwidth.
+ *
+ * A partial record at the end of the archive (a writer killed mid-write) is ignored.
+ */
+class SolutionArchiveReader : public SolutionArchive {
+
+public:
+    /**
+     * @brief SolutionArchiveReader Map archive _filename. Throws std::runtime_error if the
+     * file can't be mapped or isn't a solution archive.
+     * @param _filename
+     */
+    inline explicit SolutionArchiveReader(std::string const &_filename);
+
+    /**
+     * @brief getFilename
+     * @return
+     */
+    std::string const &getFilename() const { return filename; }
+    /**
+     * @brief getNumRecords
+     * @return
+     */
+    std::size_t getNumRecords() const { return numRecords; }
+    /**
+     * @brief getNumExams
+     * @return
+     */
+    int getNumExams() const { return header.numExams; }
+    int getNumPeriods() const { return header.numPeriods; }
+    int getNumRooms() const { return header.numRooms; }
+    /**
+     * @brief getInstanceHash
+     * @return
+     */
+    uint64_t getInstanceHash() const { return header.instanceHash; }
+    /**
+     * @brief getAlgorithm
+     * @return
+     */
+    std::string getAlgorithm() const { return std::string(header.algorithm); }
+
+    /**
+     * @brief getRecord
+     * @param _i
+     * @return Metadata of record _i
+     */
+    inline Record const &getRecord(std::size_t _i) const;
+    /**
+     * @brief getBestRecord
+     * @return Index of the lowest cost record. Pre-condition: the archive isn't empty.
+     */
+    inline std::size_t getBestRecord() const;
+    /**
+     * @brief getSolution Decode the solution of record _i
+     * @param _i
+     * @param _periods getNumExams() periods
+     * @param _rooms getNumExams() rooms
+     */
+    inline void getSolution(std::size_t _i, int *_periods, int *_rooms) const;
+    /**
+     * @brief getSolutions Decode all solutions. Exam ei of record i is at index
+     * i*getNumExams()+ei of _periods and _rooms.
+     * @param _periods
+     * @param _rooms
+     */
+    inline void getSolutions(std::vector<int> &_periods, std::vector<int> &_rooms) const;
+    /**
+     * @brief getCosts
+     * @param _costs Cost of each record
+     */
+    inline void getCosts(std::vector<long> &_costs) const;
+
+protected:
+    /**
+     * @brief getRecordData
+     * @param _i
+     * @return Pointer to the first byte of record _i
+     */
+    char const *getRecordData(std::size_t _i) const {
+        return file.begin() + header.headerSize + _i*header.recordSize;
+    }
+
+    template <typename T>
+    static void unpack(T const *_packed, int _n, int *_values) {
+        for (int i = 0; i < _n; ++i)
+            _values[i] = _packed[i];
+    }
+
+    // Archive file name
+    std::string filename;
+    // Mapped archive
+    MappedFile file;
+    // Archive header
+    Header header;
+    // Number of complete records
+    std::size_t numRecords;
+};
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// SolutionArchive
+////////////////////////////////////////////////////////////////////////////////
+
+SolutionArchive::Header SolutionArchive::makeHeader(TimetableProblemData const *_timetableProblemData,
+                                                    std::string const &_algorithm) {
+    Header header;
+    std::memset(&header, 0, sizeof(Header));
+    std::memcpy(header.magic, "FTASLNA", 8);
+    header.version = VERSION;
+    header.headerSize = sizeof(Header);
+    header.numExams = _timetableProblemData->getNumExams();
+    header.numPeriods = _timetableProblemData->getNumPeriods();
+    header.numRooms = _timetableProblemData->getNumRooms();
+    header.fieldSize = (header.numPeriods <= 256 && header.numRooms <= 256) ? 1 : 2;
+    uint32_t solutionSize = 2 * header.numExams * header.fieldSize;
+    header.recordSize = sizeof(Record) + ((solutionSize + 7) & ~7u);
+    header.instanceHash = _timetableProblemData->getInstanceHash();
+    std::strncpy(header.algorithm, _algorithm.c_str(), sizeof(header.algorithm)-1);
+    return header;
+}
+
+
+bool SolutionArchive::isCompatible(Header const &_h1, Header const &_h2) {
+    return std::memcmp(_h1.magic, _h2.magic, 8) == 0 && _h1.version == _h2.version
+            && _h1.headerSize == _h2.headerSize && _h1.recordSize == _h2.recordSize
+            && _h1.numExams == _h2.numExams && _h1.numPeriods == _h2.numPeriods
+            && _h1.numRooms == _h2.numRooms && _h1.fieldSize == _h2.fieldSize
+            && _h1.instanceHash == _h2.instanceHash
+            && std::strncmp(_h1.algorithm, _h2.algorithm, sizeof(_h1.algorithm)) == 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// SolutionArchiveWriter
+////////////////////////////////////////////////////////////////////////////////
+
+SolutionArchiveWriter::SolutionArchiveWriter(std::string const &_filename,
+                                             TimetableProblemData const *_timetableProblemData,
+                                             std::string const &_algorithm)
+    : filename(_filename), fd(-1), header(makeHeader(_timetableProblemData, _algorithm)),
+      buffer(header.recordSize, 0) {
+    fd = open(filename.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (fd < 0)
+        throw std::runtime_error("Couldn't open solution archive: " + filename);
+    // Write the header of a new archive, or check the header of an existing one
+    flock(fd, LOCK_EX);
+    struct stat st;
+    std::string error;
+    if (fstat(fd, &st) != 0)
+        error = "couldn't stat the file";
+    else if (st.st_size == 0) {
+        if (write(fd, &header, sizeof(Header)) != (ssize_t)sizeof(Header))
+            error = "couldn't write the header";
+    }
+    else {
+        Header fileHeader;
+        if (pread(fd, &fileHeader, sizeof(Header), 0) != (ssize_t)sizeof(Header))
+            error = "not a solution archive";
+        else if (!isCompatible(header, fileHeader))
+            error = "holds solutions of another instance, algorithm or archive version";
+        else if (!truncatePartialRecord())
+            error = "couldn't truncate a partial trailing record";
+    }
+    flock(fd, LOCK_UN);
+    if (!error.empty()) {
+        close(fd);
+        throw std::runtime_error(filename + ": " + error);
+    }
+}
+
+
+SolutionArchiveWriter::~SolutionArchiveWriter() {
+    if (fd >= 0)
+        close(fd);
+}
+
+
+void SolutionArchiveWriter::append(eoChromosome const &_chrom, uint64_t _seed, double _runtime, uint64_t _numEvals) {
+    // Compute the cost breakdown on a copy, the solution is left untouched
+    eoChromosome chrom(_chrom);
+    eoChromosome::CostBreakdown costBreakdown;
+    chrom.computeCost(costBreakdown);
+
+    Record record;
+    std::memset(&record, 0, sizeof(Record));
+    record.seed = _seed;
+    record.numEvals = _numEvals;
+    record.cost = costBreakdown.getTotal();
+    record.runtime = _runtime;
+    int32_t values[] = { costBreakdown.twoInARow, costBreakdown.twoInADay, costBreakdown.periodSpread,
+                         costBreakdown.mixedDurations, costBreakdown.frontLoad, costBreakdown.roomPenalty,
+                         costBreakdown.periodPenalty };
+    std::memcpy(record.costBreakdown, values, sizeof(values));
+    std::memcpy(buffer.data(), &record, sizeof(Record));
+
+    // Pack periods, then rooms
+    auto const &scheduledExamsVector = chrom.getScheduledExamsVector();
+    int numExams = header.numExams;
+    char *solution = buffer.data() + sizeof(Record);
+    if (header.fieldSize == 1) {
+        uint8_t *periods = reinterpret_cast<uint8_t *>(solution), *rooms = periods + numExams;
+        for (int ei = 0; ei < numExams; ++ei) {
+            periods[ei] = scheduledExamsVector[ei].getPeriod();
+            rooms[ei] = scheduledExamsVector[ei].getRoom();
+        }
+    }
+    else {
+        uint16_t *periods = reinterpret_cast<uint16_t *>(solution), *rooms = periods + numExams;
+        for (int ei = 0; ei < numExams; ++ei) {
+            periods[ei] = scheduledExamsVector[ei].getPeriod();
+            rooms[ei] = scheduledExamsVector[ei].getRoom();
+        }
+    }
+
+    // Another writer may have been killed mid-record since the archive was opened
+    flock(fd, LOCK_EX);
+    ssize_t n = -1;
+    if (truncatePartialRecord())
+        n = write(fd, buffer.data(), buffer.size());
+    flock(fd, LOCK_UN);
+    if (n != (ssize_t)buffer.size())
+        throw std::runtime_error("Couldn't append to solution archive: " + filename);
+}
+
+
+bool SolutionArchiveWriter::truncatePartialRecord() {
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+        return false;
+    uint64_t size = st.st_size;
+    uint64_t partial = (size - header.headerSize) % header.recordSize;
+    return partial == 0 || ftruncate(fd, size - partial) == 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// SolutionArchiveReader
+////////////////////////////////////////////////////////////////////////////////
+
+SolutionArchiveReader::SolutionArchiveReader(std::string const &_filename)
+    : filename(_filename), file(_filename), numRecords(0) {
+    if (file.size() < sizeof(Header))
+        throw std::runtime_error(filename + ": not a solution archive");
+    std::memcpy(&header, file.begin(), sizeof(Header));
+    if (std::memcmp(header.magic, "FTASLNA", 8) != 0 || header.headerSize != sizeof(Header))
+        throw std::runtime_error(filename + ": not a solution archive");
+    if (header.version != VERSION)
+        throw std::runtime_error(filename + ": unsupported solution archive version "
+                                 + std::to_string(header.version));
+    if (header.numExams < 0 || (header.fieldSize != 1 && header.fieldSize != 2)
+            || header.recordSize < sizeof(Record) + 2*(uint64_t)header.numExams*header.fieldSize
+            || header.recordSize % 8 != 0)
+        throw std::runtime_error(filename + ": corrupt solution archive header");
+    header.algorithm[sizeof(header.algorithm)-1] = '\0';
+    numRecords = (file.size() - sizeof(Header)) / header.recordSize;
+}
+
+
+SolutionArchive::Record const &SolutionArchiveReader::getRecord(std::size_t _i) const {
+    // Records are 8-byte aligned: the mapping is page aligned and the header and
+    // record sizes are multiples of 8
+    return *reinterpret_cast<Record const *>(getRecordData(_i));
+}
+
+
+std::size_t SolutionArchiveReader::getBestRecord() const {
+    std::size_t best = 0;
+    for (std::size_t i = 1; i < numRecords; ++i) {
+        if (getRecord(i).cost < getRecord(best).cost)
+            best = i;
+    }
+    return best;
+}
+
+
+void SolutionArchiveReader::getSolution(std::size_t _i, int *_periods, int *_rooms) const {
+    char const *solution = getRecordData(_i) + sizeof(Record);
+    int numExams = header.numExams;
+    if (header.fieldSize == 1) {
+        uint8_t const *periods = reinterpret_cast<uint8_t const *>(solution);
+        unpack(periods, numExams, _periods);
+        unpack(periods + numExams, numExams, _rooms);
+    }
+    else {
+        uint16_t const *periods = reinterpret_cast<uint16_t const *>(solution);
+        unpack(periods, numExams, _periods);
+        unpack(periods + numExams, numExams, _rooms);
+    }
+}
+
+
+void SolutionArchiveReader::getSolutions(std::vector<int> &_periods, std::vector<int> &_rooms) const {
+    std::size_t numExams = header.numExams;
+    _periods.resize(numRecords*numExams);
+    _rooms.resize(numRecords*numExams);
+    for (std::size_t i = 0; i < numRecords; ++i)
+        getSolution(i, _periods.data() + i*numExams, _rooms.data() + i*numExams);
+}
+
+
+void SolutionArchiveReader::getCosts(std::vector<long> &_costs) const {
+    _costs.resize(numRecords);
+    for (std::size_t i = 0; i < numRecords; ++i)
+        _costs[i] = getRecord(i).cost;
+}
+
+
+#endif // SOLUTIONARCHIVE_H
@@ -491,6 +491,16 @@ void eoChromosome::computeFitness() {
  * @brief computeCost
  */
 void eoChromosome::computeCost() {
+    CostBreakdown costBreakdown;
+    computeCost(costBreakdown);
+}
+
+
+/**
+ * @brief computeCost Compute the solution cost and its breakdown by soft constraint
+ * @param _costBreakdown
+ */
+void eoChromosome::computeCost(CostBreakdown &_costBreakdown) {
     int two_exams_in_a_row = 0;
     int two_exams_in_a_day = 0;
     int period_spread = 0;
@@ -819,8 +829,14 @@ void eoChromosome::computeCost() {
     cout << "Room penalty: " << room_penalty << endl;
     cout << "Period penalty: " << period_penalty << endl;
 #endif
-    solutionCost = two_exams_in_a_row + two_exams_in_a_day + period_spread + mixed_durations
-            + front_load + room_penalty + period_penalty;
+    _costBreakdown.twoInARow = two_exams_in_a_row;
+    _costBreakdown.twoInADay = two_exams_in_a_day;
+    _costBreakdown.periodSpread = period_spread;
+    _costBreakdown.mixedDurations = mixed_durations;
+    _costBreakdown.frontLoad = front_load;
+    _costBreakdown.roomPenalty = room_penalty;
+    _costBreakdown.periodPenalty = period_penalty;
+    solutionCost = _costBreakdown.getTotal();
 }
 
 #endif
@@ -1639,7 +1655,7 @@ long eoChromosome::getExamProximityConflicts(int _ei, int _pi) {
     int period_penalty = 0;
 
     // Get exam graph reference
-    AdjacencyList const &examGraph = this->getExamGraph();
+    CompactGraph const &examGraph = this->getCompactExamGraph();
     // Timetable container
     TimetableContainer const &timetableCont = getTimetableContainer();
     // Conflict matrix
@@ -1651,17 +1667,8 @@ long eoChromosome::getExamProximityConflicts(int _ei, int _pi) {
 
     int pj;
 
-/// TODO: USE GRAPH OR VECTOR INDEXING??
-///
-///
-
     // Get ei adjacent vertices
-    boost::property_map<AdjacencyList, boost::vertex_index_t>::type index_map = get(boost::vertex_index, examGraph);
-    boost::graph_traits<AdjacencyList>::adjacency_iterator ai, a_end;
-    boost::tie(ai, a_end) = adjacent_vertices(_ei, examGraph);
-    for (; ai != a_end; ++ai) {
-        // Get adjacent exam
-        int ej = get(index_map, *ai);
+    for (int ej : examGraph.adjacent(_ei)) {
         //
         // Period spread
         //
@@ -2278,7 +2285,7 @@ void eoChromosome::validate() const {
  * @param _rk Feasible room. _rk is set by reference.
  */
 //bool eoChromosome::getFeasiblePeriodRoom(int _ei, int _tj, int &_rk) const
-bool eoChromosome::getFeasiblePeriodRoom(int _ei, int _tj, int &_rk) {
+bool eoChromosome::getFeasiblePeriodRoom(int _ei, int _tj, int &_rk, eoRng &_gen) {
     //===
     //
     // ITC2007 Hard constraints
@@ -2327,7 +2334,7 @@ bool eoChromosome::getFeasiblePeriodRoom(int _ei, int _tj, int &_rk) {
     // Verify Room-Occupancy constraint and Room-Related constraint
     // and get a random feasible room
     //-
-    if (!getFeasibleRoom(_ei, _tj, _rk))
+    if (!getFeasibleRoom(_ei, _tj, _rk, _gen))
         return false; // Period-Related constraint was violated
 
 
@@ -2763,9 +2770,10 @@ bool eoChromosome::verifyRoomOccupancyConstraint(int _ei, int _tj, int _rk) cons
 * @param _ei
 * @param _tj
 * @param _rk
+* @param _gen
 * @return
 */
-bool eoChromosome::getFeasibleRoom(int _ei, int _tj, int &_rk) {
+bool eoChromosome::getFeasibleRoom(int _ei, int _tj, int &_rk, eoRng &_gen) {
     //
     // A set containing the feasible rooms is formed, and a random room is selected.
     //
@@ -2806,7 +2814,7 @@ bool eoChromosome::getFeasibleRoom(int _ei, int _tj, int &_rk) {
     //
     // Otherwise, a feasible room exists
     // Generate random room index
-    int idx = rng.uniform(feasibleRooms.size());
+    int idx = _gen.uniform(feasibleRooms.size());
     _rk = feasibleRooms[idx];
 
 #ifdef EOCHROMOSOME_DEBUG_ROOM
@@ -3,6 +3,7 @@
 
 
 #include <EO.h>
+#include <utils/eoRNG.h>
 
 #include "containers/Matrix.h"
 #include "containers/TimetableContainer.h"
@@ -17,6 +18,8 @@
 #include "kempeChain/ETTPKempeChain.h"
 #include "data/ScheduledExam.h"
 #include "data/ScheduledRoom.h"
+#include "utils/PerfCounters.h"
+#include "utils/MemoryAccounting.h"
 
 
 
@@ -82,8 +85,10 @@ public:
           feasible(_chrom.isFeasible()),
           solutionCost(_chrom.solutionCost) {
 
+        ETTP_PERF_SCOPE(Copy);
         // Copy timetable data
         copyTimetableData(_chrom);
+        timetableContainer->updateMemoryAccounting();
 
         // Set fitness
         fitness(_chrom.fitness());
@@ -107,6 +112,7 @@ public:
 #endif
 
         if (&_chrom != this) {
+            ETTP_PERF_SCOPE(Copy);
             timetableContainer = boost::make_shared<TimetableContainerMatrix>(
                         _chrom.getNumExams(), _chrom.getNumPeriods(), _chrom.getNumRooms(),
                         _chrom.getTimetableProblemData());
@@ -115,6 +121,7 @@ public:
             solutionCost = _chrom.solutionCost;
             // Copy timetable data
             copyTimetableData(_chrom);
+            timetableContainer->updateMemoryAccounting();
             // Set fitness
             fitness(_chrom.fitness());
         }
@@ -182,6 +189,11 @@ public:
      * @return The exam graph
      */
     inline AdjacencyList const &getExamGraph();
+    /**
+     * @brief getCompactExamGraph
+     * @return The exam graph as adjacency arrays
+     */
+    inline CompactGraph const &getCompactExamGraph() const;
     /**
      * @brief getNumEnrolments
      * @return The number of enrolments
@@ -236,14 +248,46 @@ public:
      * @return
      */
     inline TimetableContainer const &getTimetableContainer() const;
+    /**
+     * @brief getMemoryFootprint Add the bytes of the timetable container to _footprint
+     * @param _footprint
+     */
+    inline void getMemoryFootprint(MemoryAccounting::Footprint &_footprint) const;
+    /**
+     * @brief updateMemoryAccounting Register the current footprint of the timetable container
+     * in the memory accounting
+     */
+    inline void updateMemoryAccounting();
 
 
     ////////// Chromosome cost and feasibility manipulation methods //////////////////////////////
 
+    /**
+     * @brief The CostBreakdown struct. Solution cost by soft constraint
+     */
+    struct CostBreakdown {
+        int twoInARow;
+        int twoInADay;
+        int periodSpread;
+        int mixedDurations;
+        int frontLoad;
+        int roomPenalty;
+        int periodPenalty;
+
+        long getTotal() const {
+            return (long)twoInARow + twoInADay + periodSpread + mixedDurations + frontLoad + roomPenalty + periodPenalty;
+        }
+    };
+
     /**
      * @brief computeCost
      */
     void computeCost();
+    /**
+     * @brief computeCost Compute the solution cost and its breakdown by soft constraint
+     * @param _costBreakdown
+     */
+    void computeCost(CostBreakdown &_costBreakdown);
     /**
      * @brief getSolutionCost
      * @return
@@ -370,8 +414,9 @@ public:
      * @param _ei
      * @param _tj
      * @param _rk
+     * @param _gen Random number generator used to pick among the feasible rooms
      */
-    bool getFeasiblePeriodRoom(int _ei, int _tj, int& _rk);
+    bool getFeasiblePeriodRoom(int _ei, int _tj, int& _rk, eoRng &_gen = rng);
     /**
      * @brief removeConflictingExams  Remove ei conflicting exams located in period tj and room rk
      * @param _ei
@@ -433,9 +478,10 @@ public:
      * @param _ei
      * @param _tj
      * @param _rk
+     * @param _gen Random number generator used to pick among the feasible rooms
      * @return
      */
-    bool getFeasibleRoom(int _ei, int _tj, int &_rk);
+    bool getFeasibleRoom(int _ei, int _tj, int &_rk, eoRng &_gen = rng);
 
     /**
      * @brief verifyRoomCapacityConstraint Verify Room capacity constraint
@@ -590,6 +636,13 @@ std::vector<std::pair<int,int>> const &eoChromosome::getSortedCourseClassSize()
 AdjacencyList const &eoChromosome::getExamGraph() {
     return timetableProblemData->getExamGraph();
 }
+/**
+ * @brief getCompactExamGraph
+ * @return The exam graph as adjacency arrays
+ */
+CompactGraph const &eoChromosome::getCompactExamGraph() const {
+    return timetableProblemData->getCompactExamGraph();
+}
 /**
  * @brief getNumEnrolments
  * @return The number of enrolments
@@ -668,6 +721,21 @@ TimetableContainer &eoChromosome::getTimetableContainer() {
 TimetableContainer const &eoChromosome::getTimetableContainer() const {
     return *timetableContainer.get();
 }
+/**
+ * @brief getMemoryFootprint Add the bytes of the timetable container to _footprint
+ * @param _footprint
+ */
+void eoChromosome::getMemoryFootprint(MemoryAccounting::Footprint &_footprint) const {
+    if (timetableContainer.get() != nullptr)
+        timetableContainer->getMemoryFootprint(_footprint);
+}
+/**
+ * @brief updateMemoryAccounting Register the current footprint of the timetable container
+ */
+void eoChromosome::updateMemoryAccounting() {
+    if (timetableContainer.get() != nullptr)
+        timetableContainer->updateMemoryAccounting();
+}
 
 
 
@@ -44,6 +44,11 @@ public:
      * @param _colVector
      */
     void setColumn(int _ti, std::vector<T> const &_colVector);
+    /**
+     * @brief getMemoryUsage
+     * @return Bytes allocated for the columns
+     */
+    std::size_t getMemoryUsage() const;
 
     // refers to a full specialization for this particular T
     friend std::ostream& operator<< <> (std::ostream& _os, const ColumnMatrix& _columnMatrix);
@@ -147,6 +152,18 @@ void ColumnMatrix<T>::setColumn(int _ti, std::vector<T> const &_colVector) {
     vec[_ti] = _colVector;
 }
 
+/**
+ * @brief getMemoryUsage
+ * @return Bytes allocated for the columns
+ */
+template <typename T>
+std::size_t ColumnMatrix<T>::getMemoryUsage() const {
+    std::size_t bytes = vec.capacity() * sizeof(std::vector<T>);
+    for (auto const &column : vec)
+        bytes += column.capacity() * sizeof(T);
+    return bytes;
+}
+
 
 template <typename T>
 std::ostream& operator<<(std::ostream& _os, const ColumnMatrix<T>& _columnMatrix) {
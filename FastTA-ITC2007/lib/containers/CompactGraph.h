@@ -0,0 +1,116 @@
+#ifndef COMPACTGRAPH_H
+#define COMPACTGRAPH_H
+
+#include <vector>
+#include "containers/SparseIntMatrix.h"
+
+
+/**
+ * @brief The CompactGraph class. Undirected graph stored as adjacency arrays in
+ * compressed sparse row form. The neighbours of each vertex are contiguous and
+ * sorted, so visiting them is a linear scan of one array, instead of chasing the
+ * per-vertex edge lists of a boost::adjacency_list.
+ *
+ * Built from a symmetric sparse matrix, e.g. the conflict matrix: there is an
+ * edge (i, j), i != j, for each non-zero entry.
+ */
+class CompactGraph {
+
+public:
+    /**
+     * @brief The Range struct. Neighbours of a vertex, usable in range-based for loops.
+     */
+    struct Range {
+        int const *first;
+        int const *last;
+        int const *begin() const { return first; }
+        int const *end() const   { return last;  }
+    };
+
+    // Constructors
+    inline CompactGraph();
+    /**
+     * @brief CompactGraph Build the graph of the off-diagonal non-zero entries of _matrix
+     * @param _matrix Symmetric sparse matrix
+     */
+    inline explicit CompactGraph(SparseIntMatrix const &_matrix);
+
+    // Public interface
+    /**
+     * @brief getNumVertices
+     * @return
+     */
+    inline int getNumVertices() const;
+    /**
+     * @brief getNumEdges
+     * @return Number of undirected edges
+     */
+    inline int getNumEdges() const;
+    /**
+     * @brief degree
+     * @param _v
+     * @return Number of neighbours of vertex _v
+     */
+    inline int degree(int _v) const;
+    /**
+     * @brief adjacent
+     * @param _v
+     * @return Neighbours of vertex _v, in increasing order
+     */
+    inline Range adjacent(int _v) const;
+    /**
+     * @brief getMemoryUsage
+     * @return Bytes allocated for the adjacency arrays
+     */
+    std::size_t getMemoryUsage() const { return (start.capacity() + adj.capacity()) * sizeof(int); }
+
+protected:
+    // Number of vertices
+    int numVertices;
+    // Start of the neighbours of each vertex in adj
+    std::vector<int> start;
+    // Neighbours
+    std::vector<int> adj;
+};
+
+
+
+CompactGraph::CompactGraph()
+    : numVertices(0), start(1, 0) { }
+
+
+CompactGraph::CompactGraph(SparseIntMatrix const &_matrix)
+    : numVertices(_matrix.getNumLines()), start(_matrix.getNumLines()+1, 0) {
+    adj.reserve(_matrix.getNumNonZeros());
+    for (int i = 0; i < numVertices; ++i) {
+        for (int k = _matrix.getRowBegin(i); k < _matrix.getRowEnd(i); ++k) {
+            if (_matrix.getCol(k) != i)
+                adj.push_back(_matrix.getCol(k));
+        }
+        start[i+1] = adj.size();
+    }
+}
+
+
+int CompactGraph::getNumVertices() const {
+    return numVertices;
+}
+
+
+int CompactGraph::getNumEdges() const {
+    return adj.size() / 2;
+}
+
+
+int CompactGraph::degree(int _v) const {
+    return start[_v+1] - start[_v];
+}
+
+
+CompactGraph::Range CompactGraph::adjacent(int _v) const {
+    Range range = { adj.data() + start[_v], adj.data() + start[_v+1] };
+    return range;
+}
+
+
+#endif // COMPACTGRAPH_H
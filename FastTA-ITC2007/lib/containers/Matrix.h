@@ -32,6 +32,11 @@ public:
     void setVal(int i, int j, T const& value);
     int getNumLines() const;
     int getNumCols() const;
+    /**
+     * @brief getMemoryUsage
+     * @return Bytes allocated for the matrix cells
+     */
+    std::size_t getMemoryUsage() const;
 
     // refers to a full specialization for this particular T
     friend std::ostream& operator<< <> (std::ostream& os, const Matrix& matrix);
@@ -108,6 +113,13 @@ int Matrix<T>::getNumLines() const { return nlines; }
 template <typename T>
 int Matrix<T>::getNumCols() const { return ncols; }
 
+/**
+ * @brief Matrix::getMemoryUsage
+ * @return Bytes allocated for the matrix cells
+ */
+template <typename T>
+std::size_t Matrix<T>::getMemoryUsage() const { return vec.capacity() * sizeof(T); }
+
 
 template <typename T>
 std::ostream& operator<<(std::ostream& os, const Matrix<T>& matrix) {
@@ -0,0 +1,149 @@
+#ifndef SPARSEINTMATRIX_H
+#define SPARSEINTMATRIX_H
+
+#include <vector>
+#include <algorithm>
+
+
+/**
+ * @brief The SparseIntMatrix class. Square integer matrix in compressed sparse
+ * row (CSR) form: the non-zero entries of line i are (getCol(k), getVal(k)) for
+ * k in [getRowBegin(i), getRowEnd(i)), sorted by column.
+ *
+ * Used for the conflict structure, which is symmetric and very sparse on the
+ * ITC2007 instances.
+ */
+class SparseIntMatrix {
+
+public:
+    // Constructors
+    inline SparseIntMatrix();
+    /**
+     * @brief SparseIntMatrix
+     * @param _numLines
+     * @param _rowStart Size _numLines+1
+     * @param _cols Column of each non-zero entry, sorted within each line
+     * @param _vals Value of each non-zero entry
+     */
+    inline SparseIntMatrix(int _numLines, std::vector<int> &&_rowStart,
+                           std::vector<int> &&_cols, std::vector<int> &&_vals);
+
+    // Public interface
+    /**
+     * @brief getNumLines
+     * @return
+     */
+    inline int getNumLines() const;
+    /**
+     * @brief getNumNonZeros
+     * @return Number of non-zero entries
+     */
+    inline int getNumNonZeros() const;
+    /**
+     * @brief getRowBegin
+     * @param _i
+     * @return Index of the first non-zero entry of line _i
+     */
+    inline int getRowBegin(int _i) const;
+    /**
+     * @brief getRowEnd
+     * @param _i
+     * @return Index past the last non-zero entry of line _i
+     */
+    inline int getRowEnd(int _i) const;
+    /**
+     * @brief getCol
+     * @param _k
+     * @return Column of non-zero entry _k
+     */
+    inline int getCol(int _k) const;
+    /**
+     * @brief getVal
+     * @param _k
+     * @return Value of non-zero entry _k
+     */
+    inline int getVal(int _k) const;
+    /**
+     * @brief getVal Binary search of cell (i, j) in line _i
+     * @param _i
+     * @param _j
+     * @return The cell value, zero if absent
+     */
+    inline int getVal(int _i, int _j) const;
+
+    /**
+     * @brief getRowStart
+     * @return Index of the first non-zero entry of each line, plus the number of non-zeros
+     */
+    std::vector<int> const &getRowStart() const { return rowStart; }
+    std::vector<int> const &getCols() const     { return cols;     }
+    std::vector<int> const &getVals() const     { return vals;     }
+
+    /**
+     * @brief getMemoryUsage
+     * @return Bytes allocated for the line starts and the non-zero entries
+     */
+    std::size_t getMemoryUsage() const {
+        return (rowStart.capacity() + cols.capacity() + vals.capacity()) * sizeof(int);
+    }
+
+protected:
+    // Number of lines (and columns)
+    int numLines;
+    // Start of each line in cols and vals
+    std::vector<int> rowStart;
+    // Columns of the non-zero entries
+    std::vector<int> cols;
+    // Values of the non-zero entries
+    std::vector<int> vals;
+};
+
+
+
+SparseIntMatrix::SparseIntMatrix()
+    : numLines(0), rowStart(1, 0) { }
+
+
+SparseIntMatrix::SparseIntMatrix(int _numLines, std::vector<int> &&_rowStart,
+                                 std::vector<int> &&_cols, std::vector<int> &&_vals)
+    : numLines(_numLines), rowStart(std::move(_rowStart)), cols(std::move(_cols)), vals(std::move(_vals)) { }
+
+
+int SparseIntMatrix::getNumLines() const {
+    return numLines;
+}
+
+
+int SparseIntMatrix::getNumNonZeros() const {
+    return cols.size();
+}
+
+
+int SparseIntMatrix::getRowBegin(int _i) const {
+    return rowStart[_i];
+}
+
+
+int SparseIntMatrix::getRowEnd(int _i) const {
+    return rowStart[_i+1];
+}
+
+
+int SparseIntMatrix::getCol(int _k) const {
+    return cols[_k];
+}
+
+
+int SparseIntMatrix::getVal(int _k) const {
+    return vals[_k];
+}
+
+
+int SparseIntMatrix::getVal(int _i, int _j) const {
+    auto first = cols.begin() + rowStart[_i], last = cols.begin() + rowStart[_i+1];
+    auto it = std::lower_bound(first, last, _j);
+    return (it != last && *it == _j) ? vals[it - cols.begin()] : 0;
+}
+
+
+#endif // SPARSEINTMATRIX_H
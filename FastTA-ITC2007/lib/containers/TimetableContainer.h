@@ -6,6 +6,7 @@
 #include "data/ScheduledExam.h"
 #include "data/ScheduledRoom.h"
 #include "data/TimetableProblemData.hpp"
+#include "utils/MemoryAccounting.h"
 #include <tuple>
 
 // Exam-Room tuple definition
@@ -151,6 +152,16 @@ public:
      */
     virtual void removeExamFromRoom(int _ei, int _tj, int _rk)  = 0;
 
+    /**
+     * @brief getMemoryFootprint Add the bytes of the container structures to _footprint
+     * @param _footprint
+     */
+    virtual void getMemoryFootprint(MemoryAccounting::Footprint &_footprint) const = 0;
+    /**
+     * @brief updateMemoryAccounting Register the current footprint in the memory accounting
+     */
+    virtual void updateMemoryAccounting() = 0;
+
 };
 
 #endif // TIMETABLECONTAINER_H
@@ -186,6 +186,18 @@ public:
      */
     virtual void removeExamFromRoom(int _ei, int _tj, int _rk) override;
 
+    /**
+     * @brief getMemoryFootprint Add the bytes of the container structures to _footprint
+     * @param _footprint
+     */
+    inline virtual void getMemoryFootprint(MemoryAccounting::Footprint &_footprint) const override;
+
+    /**
+     * @brief updateMemoryAccounting Register the current footprint in the memory accounting.
+     * Called at construction; the owner calls it again after filling or copying the container.
+     */
+    inline virtual void updateMemoryAccounting() override;
+
 protected:
     /**
      * @brief init
@@ -222,6 +234,10 @@ protected:
      * @brief timetableProblemData The problem data
      */
     TimetableProblemData const *timetableProblemData;
+    /**
+     * @brief memoryAccount Footprint registered in the memory accounting
+     */
+    MemoryAccounting::Account memoryAccount;
 };
 
 
@@ -276,6 +292,8 @@ TimetableContainerMatrix::TimetableContainerMatrix(int _numExams, int _numPeriod
 #endif
     // Initialise container and aux vectors
     init();
+    // Register the footprint of the allocated structures
+    updateMemoryAccounting();
 }
 
 // Protected methods
@@ -445,6 +463,32 @@ void TimetableContainerMatrix::removeExam(int _ei, int _tj) {
     periodsExams[_tj].erase(it);
 }
 
+/**
+ * @brief getMemoryFootprint Add the bytes of the container structures to _footprint
+ * @param _footprint
+ */
+void TimetableContainerMatrix::getMemoryFootprint(MemoryAccounting::Footprint &_footprint) const {
+    _footprint.bytes[MemoryAccounting::TimetableMatrix] += timetableContainer.getMemoryUsage();
+    _footprint.bytes[MemoryAccounting::PeriodsExams] += MemoryAccounting::nestedVectorBytes(periodsExams);
+    _footprint.bytes[MemoryAccounting::PeriodsSizes] += MemoryAccounting::vectorBytes(periodsSizes);
+    _footprint.bytes[MemoryAccounting::ScheduledExams] += MemoryAccounting::vectorBytes(scheduledExamsVector);
+    std::size_t &scheduledRoomsBytes = _footprint.bytes[MemoryAccounting::ScheduledRooms];
+    scheduledRoomsBytes += MemoryAccounting::vectorBytes(scheduledRoomsVector);
+    for (auto const &room : scheduledRoomsVector)
+        scheduledRoomsBytes += room.getMemoryUsage();
+}
+
+/**
+ * @brief updateMemoryAccounting Register the current footprint in the memory accounting
+ */
+void TimetableContainerMatrix::updateMemoryAccounting() {
+    if (MemoryAccounting::isEnabled()) {
+        MemoryAccounting::Footprint footprint;
+        getMemoryFootprint(footprint);
+        memoryAccount.update(footprint);
+    }
+}
+
 #endif // TIMETABLECONTAINERMATRIX_H
 
 
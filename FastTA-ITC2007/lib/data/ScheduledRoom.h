@@ -73,6 +73,11 @@ public:
      */
     inline void setNumPeriods(int _numPeriods);
 
+    /**
+     * @brief getMemoryUsage
+     * @return Bytes allocated for the periods vector
+     */
+    std::size_t getMemoryUsage() const { return periods.capacity() * sizeof(PeriodRoom); }
 
 private:
     // Private fields
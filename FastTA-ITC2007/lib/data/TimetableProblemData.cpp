@@ -25,5 +25,44 @@ ostream& operator<<(ostream& _os, const TimetableProblemData& _timetableProblemD
 }
 
 
+void TimetableProblemData::getMemoryFootprint(MemoryAccounting::Footprint &_footprint) const {
+    // Conflict matrices
+    std::size_t &conflictMatrixBytes = _footprint.bytes[MemoryAccounting::ConflictMatrix];
+    if (conflictMatrix)
+        conflictMatrixBytes += conflictMatrix->getMemoryUsage();
+    if (sparseConflictMatrix)
+        conflictMatrixBytes += sparseConflictMatrix->getMemoryUsage();
+    // Exam graphs. The boost adjacency list stores a vertex vector, an out-edge vector per
+    // vertex and a std::list of the edges, whose nodes hold two links.
+    std::size_t &examGraphBytes = _footprint.bytes[MemoryAccounting::ExamGraph];
+    if (examGraph) {
+        examGraphBytes += MemoryAccounting::vectorBytes(examGraph->m_vertices);
+        for (auto const &vertex : examGraph->m_vertices)
+            examGraphBytes += MemoryAccounting::vectorBytes(vertex.m_out_edges);
+        examGraphBytes += examGraph->m_edges.size() * (sizeof(*examGraph->m_edges.begin()) + 2 * sizeof(void *));
+    }
+    if (compactExamGraph)
+        examGraphBytes += compactExamGraph->getMemoryUsage();
+    // Problem entities. Constraint objects are not counted, only their handles.
+    std::size_t &entitiesBytes = _footprint.bytes[MemoryAccounting::ProblemEntities];
+    if (examVector) {
+        entitiesBytes += MemoryAccounting::sharedVectorBytes(*examVector);
+        for (auto const &exam : *examVector) {
+            entitiesBytes += MemoryAccounting::vectorBytes(exam->getPeriodRelatedHardConstraints())
+                           + MemoryAccounting::vectorBytes(exam->getRoomRelatedHardConstraints());
+        }
+    }
+    if (roomVector)
+        entitiesBytes += MemoryAccounting::sharedVectorBytes(*roomVector);
+    if (periodVector)
+        entitiesBytes += MemoryAccounting::sharedVectorBytes(*periodVector);
+    if (courseClassSize)
+        entitiesBytes += MemoryAccounting::vectorBytes(*courseClassSize);
+    if (sortedCourseClassSize)
+        entitiesBytes += MemoryAccounting::vectorBytes(*sortedCourseClassSize);
+    entitiesBytes += MemoryAccounting::vectorBytes(hardConstraints) + MemoryAccounting::vectorBytes(softConstraints);
+}
+
+
 
 
@@ -2,12 +2,16 @@
 #define TIMETABLEPROBLEMDATA_H
 
 #include <vector>
+#include <cstdint>
 #include <iostream>
 #include "containers/IntMatrix.h"
+#include "containers/SparseIntMatrix.h"
+#include "containers/CompactGraph.h"
 #include <map>
 #include <boost/shared_ptr.hpp>
 #include <boost/unordered_map.hpp>
 #include "utils/Common.h"
+#include "utils/MemoryAccounting.h"
 #include "data/Exam.h"
 #include "data/Room.h"
 #include "data/Period.h"
@@ -19,7 +23,7 @@ class TimetableProblemData {
 
 public:
     // Constructors
-    TimetableProblemData() { }
+    TimetableProblemData() : instanceHash(0) { }
 
     TimetableProblemData(int _numPeriods, int _numStudents, int _numExams, int _numEnrolments,
                          boost::shared_ptr<IntMatrix> _conflictMatrix,
@@ -28,7 +32,7 @@ public:
         : numPeriods(_numPeriods), numStudents(_numStudents), numExams(_numExams),
           numEnrolments(_numEnrolments),
           conflictMatrix(_conflictMatrix),
-          examGraph(_examGraph)
+          examGraph(_examGraph), instanceHash(0)
     {
         // Compute conflict matrix density
         computeConflictMatrixDensity();
@@ -53,15 +57,29 @@ public:
     int getNumEnrolments() const;
     void setNumEnrolments(int value);
 
+    // FNV-1a hash of the instance file, which identifies the instance in solution archives
+    uint64_t getInstanceHash() const;
+    void setInstanceHash(uint64_t value);
+
     double getConflictMatrixDensity() const;
     void setConflictMatrixDensity(double value);
 
     const IntMatrix &getConflictMatrix() const;
     void setConflictMatrix(const boost::shared_ptr<IntMatrix > &value);
+    // Set conflict matrix with an already known density (e.g. read from an instance cache)
+    void setConflictMatrix(const boost::shared_ptr<IntMatrix > &value, double _conflictMatrixDensity);
+
+    // Conflict matrix in compressed sparse row form. Null if it wasn't built.
+    boost::shared_ptr<SparseIntMatrix> const &getSparseConflictMatrix() const;
+    void setSparseConflictMatrix(const boost::shared_ptr<SparseIntMatrix> &value);
 
     const AdjacencyList &getExamGraph() const;
     void setExamGraph(const boost::shared_ptr<AdjacencyList> &value);
 
+    // Exam graph as adjacency arrays. Same vertices, edges and neighbour order as getExamGraph().
+    const CompactGraph &getCompactExamGraph() const;
+    void setCompactExamGraph(const boost::shared_ptr<CompactGraph> &value);
+
     // Get/set course class sizes
     const std::vector<int> &getCourseClassSize() const;
     void setCourseClassSize(const boost::shared_ptr<std::vector<int> > &_courseClassSize);
@@ -94,6 +112,11 @@ public:
     void setHardConstraints(const std::vector<boost::shared_ptr<Constraint> > &value);
 //    void setSoftConstraints(const std::vector<boost::shared_ptr<Constraint> > &value);
 
+    // Add the bytes of the conflict matrices, the exam graphs and the problem entities to _footprint
+    void getMemoryFootprint(MemoryAccounting::Footprint &_footprint) const;
+    // Register the current footprint in the memory accounting. Called once the data is loaded.
+    void updateMemoryAccounting();
+
 private:
 
     //--
@@ -136,8 +159,14 @@ private:
     double conflictMatrixDensity;
     // Conflict matrix
     boost::shared_ptr<IntMatrix > conflictMatrix;
+    // Conflict matrix in compressed sparse row form
+    boost::shared_ptr<SparseIntMatrix> sparseConflictMatrix;
     // Graph
     boost::shared_ptr<AdjacencyList> examGraph;
+    // Hash of the instance file
+    uint64_t instanceHash;
+    // Graph as adjacency arrays
+    boost::shared_ptr<CompactGraph> compactExamGraph;
     // Vector to keep course total students. Exams indexed from [0..numExams-1].
     boost::shared_ptr<std::vector<int> > courseClassSize;
     // Sorted vector containing exams sorted by class size and by earliest index.
@@ -157,6 +186,8 @@ private:
     // Hard and Soft constraints
     std::vector<boost::shared_ptr<Constraint> > hardConstraints;
     std::vector<boost::shared_ptr<Constraint> > softConstraints;
+    // Footprint registered in the memory accounting
+    MemoryAccounting::Account memoryAccount;
 };
 
 
@@ -205,6 +236,15 @@ inline void TimetableProblemData::setNumEnrolments(int value)
     numEnrolments = value;
 }
 
+inline uint64_t TimetableProblemData::getInstanceHash() const
+{
+    return instanceHash;
+}
+inline void TimetableProblemData::setInstanceHash(uint64_t value)
+{
+    instanceHash = value;
+}
+
 inline double TimetableProblemData::getConflictMatrixDensity() const
 {
     return conflictMatrixDensity;
@@ -224,6 +264,21 @@ inline void TimetableProblemData::setConflictMatrix(const boost::shared_ptr<IntM
     // Compute conflict matrix density
     computeConflictMatrixDensity();
 }
+inline void TimetableProblemData::setConflictMatrix(const boost::shared_ptr<IntMatrix> &value,
+                                                   double _conflictMatrixDensity)
+{
+    conflictMatrix = value;
+    conflictMatrixDensity = _conflictMatrixDensity;
+}
+
+inline boost::shared_ptr<SparseIntMatrix> const& TimetableProblemData::getSparseConflictMatrix() const
+{
+    return sparseConflictMatrix;
+}
+inline void TimetableProblemData::setSparseConflictMatrix(const boost::shared_ptr<SparseIntMatrix> &value)
+{
+    sparseConflictMatrix = value;
+}
 
 inline AdjacencyList const& TimetableProblemData::getExamGraph() const
 {
@@ -234,6 +289,15 @@ inline void TimetableProblemData::setExamGraph(const boost::shared_ptr<Adjacency
     examGraph = value;
 }
 
+inline CompactGraph const& TimetableProblemData::getCompactExamGraph() const
+{
+    return *compactExamGraph.get();
+}
+inline void TimetableProblemData::setCompactExamGraph(const boost::shared_ptr<CompactGraph> &value)
+{
+    compactExamGraph = value;
+}
+
 // Get/set course class sizes
 inline std::vector<int> const& TimetableProblemData::getCourseClassSize() const
 {
@@ -318,6 +382,15 @@ inline void TimetableProblemData::setHardConstraints(const std::vector<boost::sh
 //    return softConstraints;
 //}
 
+inline void TimetableProblemData::updateMemoryAccounting()
+{
+    if (MemoryAccounting::isEnabled()) {
+        MemoryAccounting::Footprint footprint;
+        getMemoryFootprint(footprint);
+        memoryAccount.update(footprint);
+    }
+}
+
 //inline void TimetableProblemData::setSoftConstraints(const std::vector<boost::shared_ptr<Constraint> > &value)
 //{
 //    softConstraints = value;
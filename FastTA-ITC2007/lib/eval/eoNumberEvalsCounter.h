@@ -1,7 +1,17 @@
 #ifndef EONUMBEREVALSCOUNTER_H
 #define EONUMBEREVALSCOUNTER_H
 
+#include <atomic>
 
+
+/**
+ * # evaluations counter.
+ *
+ * A counter has a single writer thread. The totals are relaxed atomics, so
+ * they can be read from other threads at any time (see
+ * eoShardedNumberEvalsCounter) while the writer updates them with plain
+ * loads and stores, i.e. with no locked instruction.
+ */
 class eoNumberEvalsCounter {
 
 public:
@@ -20,43 +30,43 @@ protected:
     /**
      * @brief totalNumEvals Total # number of evaluations done
      */
-    long totalNumEvals;
+    std::atomic<long> totalNumEvals;
     /**
      * @brief generationNumEvals # number of evaluations done
      * in one generation of the genetic algorithm
      */
-    long generationNumEvals;
+    std::atomic<long> generationNumEvals;
 };
 
 
 long eoNumberEvalsCounter::getTotalNumEvals() const
 {
-    return totalNumEvals;
+    return totalNumEvals.load(std::memory_order_relaxed);
 }
 
 void eoNumberEvalsCounter::setTotalNumEvals(long _value)
 {
-    totalNumEvals = _value;
+    totalNumEvals.store(_value, std::memory_order_relaxed);
 }
 
 long eoNumberEvalsCounter::getGenerationNumEvals() const
 {
-    return generationNumEvals;
+    return generationNumEvals.load(std::memory_order_relaxed);
 }
 
 void eoNumberEvalsCounter::setGenerationNumEvals(long _value)
 {
-    generationNumEvals = _value;
+    generationNumEvals.store(_value, std::memory_order_relaxed);
 }
 
 void eoNumberEvalsCounter::addNumEvalsToTotal(long _value) {
-    // Add _value to the total # evals
-    totalNumEvals += _value;
+    // Add _value to the total # evals. Single writer: no read-modify-write needed
+    totalNumEvals.store(totalNumEvals.load(std::memory_order_relaxed) + _value, std::memory_order_relaxed);
 }
 
 void eoNumberEvalsCounter::addNumEvalsToGenerationTotal(long _value) {
-    // Add _value to the generation # evals
-    generationNumEvals += _value;
+    // Add _value to the generation # evals. Single writer: no read-modify-write needed
+    generationNumEvals.store(generationNumEvals.load(std::memory_order_relaxed) + _value, std::memory_order_relaxed);
 }
 
 #endif // EONUMBEREVALSCOUNTER_H
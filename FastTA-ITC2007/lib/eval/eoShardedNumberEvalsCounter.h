@@ -0,0 +1,155 @@
+#ifndef EOSHARDEDNUMBEREVALSCOUNTER_H
+#define EOSHARDEDNUMBEREVALSCOUNTER_H
+
+#include <vector>
+#include <chrono>
+#include "eval/eoNumberEvalsCounter.h"
+
+
+/**
+ * # evaluations counter shared by several threads.
+ *
+ * Each thread counts into its own shard, an eoNumberEvalsCounter which is
+ * passed to the usual evaluation functions (eoETTPEvalNumberEvalsCounter,
+ * ETTPneighborEvalNumEvalsCounter, ...). Shards are padded to separate cache
+ * lines, so counting costs the same as with an unshared counter. Any thread
+ * can take a snapshot of the total, e.g. to enforce a global evaluation
+ * budget or to report the evaluation rate. A snapshot taken while the
+ * workers are running may lag behind by the evaluations in flight.
+ */
+class eoShardedNumberEvalsCounter {
+
+public:
+    /**
+     * @brief The Snapshot struct
+     */
+    struct Snapshot {
+        // Total # evaluations over all shards
+        long totalNumEvals;
+        // Seconds elapsed since the counter was created or reset
+        double seconds;
+    };
+
+    /**
+     * @brief eoShardedNumberEvalsCounter Constructor
+     * @param _numShards Number of shards, one per writer thread
+     */
+    inline eoShardedNumberEvalsCounter(unsigned _numShards);
+
+    /**
+     * @brief getNumShards
+     * @return Number of shards
+     */
+    inline unsigned getNumShards() const;
+
+    /**
+     * @brief getShard
+     * @param _i
+     * @return Shard _i. It must only be updated by one thread at a time.
+     */
+    inline eoNumberEvalsCounter &getShard(unsigned _i);
+
+    /**
+     * @brief getTotalNumEvals
+     * @return Total # evaluations over all shards
+     */
+    inline long getTotalNumEvals() const;
+
+    /**
+     * @brief snapshot
+     * @return Total # evaluations and elapsed time
+     */
+    inline Snapshot snapshot() const;
+
+    /**
+     * @brief evalsPerSecond
+     * @param _from
+     * @param _to
+     * @return Evaluation rate between two snapshots
+     */
+    inline static double evalsPerSecond(Snapshot const &_from, Snapshot const &_to);
+
+    /**
+     * @brief isBudgetExhausted
+     * @param _maxNumEvals
+     * @return true if at least _maxNumEvals evaluations were counted
+     */
+    inline bool isBudgetExhausted(long _maxNumEvals) const;
+
+    /**
+     * @brief reset Set every shard to zero and restart the clock.
+     * Must not run concurrently with the shard writers.
+     */
+    inline void reset();
+
+protected:
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * @brief The PaddedShard struct. The padding keeps consecutive shards
+     * on different cache lines.
+     */
+    struct PaddedShard {
+        eoNumberEvalsCounter counter;
+        char padding[64];
+    };
+
+    // Shards
+    std::vector<PaddedShard> shards;
+    // Creation or reset time
+    Clock::time_point startTime;
+};
+
+
+
+eoShardedNumberEvalsCounter::eoShardedNumberEvalsCounter(unsigned _numShards)
+    : shards(_numShards > 0 ? _numShards : 1), startTime(Clock::now()) { }
+
+
+unsigned eoShardedNumberEvalsCounter::getNumShards() const {
+    return shards.size();
+}
+
+
+eoNumberEvalsCounter &eoShardedNumberEvalsCounter::getShard(unsigned _i) {
+    return shards[_i].counter;
+}
+
+
+long eoShardedNumberEvalsCounter::getTotalNumEvals() const {
+    long total = 0;
+    for (auto const &shard : shards)
+        total += shard.counter.getTotalNumEvals();
+    return total;
+}
+
+
+eoShardedNumberEvalsCounter::Snapshot eoShardedNumberEvalsCounter::snapshot() const {
+    Snapshot snap;
+    snap.totalNumEvals = getTotalNumEvals();
+    snap.seconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+    return snap;
+}
+
+
+double eoShardedNumberEvalsCounter::evalsPerSecond(Snapshot const &_from, Snapshot const &_to) {
+    double seconds = _to.seconds - _from.seconds;
+    return seconds > 0 ? (_to.totalNumEvals - _from.totalNumEvals) / seconds : 0;
+}
+
+
+bool eoShardedNumberEvalsCounter::isBudgetExhausted(long _maxNumEvals) const {
+    return getTotalNumEvals() >= _maxNumEvals;
+}
+
+
+void eoShardedNumberEvalsCounter::reset() {
+    for (auto &shard : shards) {
+        shard.counter.setTotalNumEvals(0);
+        shard.counter.setGenerationNumEvals(0);
+    }
+    startTime = Clock::now();
+}
+
+
+#endif // EOSHARDEDNUMBEREVALSCOUNTER_H
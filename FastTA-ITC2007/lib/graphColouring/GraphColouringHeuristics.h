@@ -78,11 +78,20 @@ public:
 
 public:
     /**
-     * @brief saturationDegree
+     * @brief saturationDegree Reseeds the global random generator with the current time
      * @param _timetableProblemData
      * @param _chrom
      */
     static void saturationDegree(TimetableProblemData const *_timetableProblemData, EOT &_chrom);
+    /**
+     * @brief saturationDegree Uses random generator _gen, which is not reseeded.
+     * The working state of the heuristic is thread-local, so solutions may be built
+     * concurrently, each thread using its own generator.
+     * @param _timetableProblemData
+     * @param _chrom
+     * @param _gen
+     */
+    static void saturationDegree(TimetableProblemData const *_timetableProblemData, EOT &_chrom, eoRng &_gen);
 
 private:
 
@@ -244,27 +253,32 @@ private:
     static void buildRoomRelatedConflicts(EOT &_chrom, int _ei, int _tj, int _rk, std::vector<VariableValueTuple> &_variables);
 
     //--
-    // Fields
+    // Fields. Thread-local, as they hold the state of the solution being built.
     //--
 
     /**
      * @brief numExams the number of vertices
      */
-    static int numExams;
+    static thread_local int numExams;
     /**
      * @brief numPeriods Number of periods
      */
-    static int numPeriods;
+    static thread_local int numPeriods;
 
     /**
      * @brief timetableProblemData - TimetableProblemData is const
      */
-    static TimetableProblemData const *timetableProblemData;
+    static thread_local TimetableProblemData const *timetableProblemData;
 
     /**
      * @brief CBS Conflict-Based Statistics
      */
-    static boost::unordered_map<i6tuple, int> CBS;
+    static thread_local boost::unordered_map<i6tuple, int> CBS;
+
+    /**
+     * @brief gen Random number generator used by the solution being built
+     */
+    static thread_local eoRng *gen;
 };
 
 
@@ -274,19 +288,23 @@ private:
 
 
 template <typename EOT>
-int GCHeuristics<EOT>::numExams = 0;
+thread_local int GCHeuristics<EOT>::numExams = 0;
 
 
 template <typename EOT>
-int GCHeuristics<EOT>::numPeriods = 0;
+thread_local int GCHeuristics<EOT>::numPeriods = 0;
 
 
 template <typename EOT>
-TimetableProblemData const *GCHeuristics<EOT>::timetableProblemData = nullptr;
+thread_local TimetableProblemData const *GCHeuristics<EOT>::timetableProblemData = nullptr;
 
 
 template <typename EOT>
-boost::unordered_map<typename GCHeuristics<EOT>::i6tuple, int> GCHeuristics<EOT>::CBS;
+thread_local boost::unordered_map<typename GCHeuristics<EOT>::i6tuple, int> GCHeuristics<EOT>::CBS;
+
+
+template <typename EOT>
+thread_local eoRng *GCHeuristics<EOT>::gen = &rng;
 
 
 
@@ -780,6 +798,18 @@ boost::unordered_map<typename GCHeuristics<EOT>::i6tuple, int> GCHeuristics<EOT>
  */
 template <typename EOT>
 void GCHeuristics<EOT>::saturationDegree(TimetableProblemData const *_timetableProblemData, EOT &_chrom) {
+    //
+    // We use the ParadisEO random generator eoRng which is reseed on initialization.
+    //
+    // Initialise EO random generator
+    rng.reseed(static_cast<uint32_t>(time(0)));
+    saturationDegree(_timetableProblemData, _chrom, rng);
+}
+
+
+
+template <typename EOT>
+void GCHeuristics<EOT>::saturationDegree(TimetableProblemData const *_timetableProblemData, EOT &_chrom, eoRng &_gen) {
     //===
     // SD (Saturation Degree) graph colouring heuristic for ITC2007:
     //
@@ -848,6 +878,8 @@ void GCHeuristics<EOT>::saturationDegree(TimetableProblemData const *_timetableP
 #endif
 
     // Init fields
+    // Register random number generator
+    gen = &_gen;
     init(_timetableProblemData, _chrom);
     // Create exam priority queue
     VertexPriorityQueue pq(numExams);
@@ -1331,10 +1363,10 @@ bool GCHeuristics<EOT>::getFeasiblePeriodRoom(EOT &_chrom, int _ei, int &_tj, in
 
     do {
         // Select a random period 'tj' (with no conficts) for scheduling exam 'ei'.
-        int idx = rng.uniform(numAvailablePeriods);
+        int idx = gen->uniform(numAvailablePeriods);
         _tj = _availablePeriodsList[idx];
         // Get a feasible period-room pair. 'tj' and 'rk' are out parameters.
-        feasiblePeriodFound = _chrom.getFeasiblePeriodRoom(_ei, _tj, _rk);
+        feasiblePeriodFound = _chrom.getFeasiblePeriodRoom(_ei, _tj, _rk, *gen);
 #ifdef GRAPH_COLOURING_HEURISTIC_DEBUG
         if (!feasiblePeriodFound) {
             cout << "Period " << _tj << " is not feasible. Try another one..."  << endl;
@@ -1912,11 +1944,6 @@ void GCHeuristics<EOT>::init(const TimetableProblemData *_timetableProblemData,
 
 //    // Register timetable problem data
 //    timetableProblemData = &_timetableProblemData;
-    //
-    // We use the ParadisEO random generator eoRng which is reseed on initialization.
-    //
-    // Initialise EO random generator
-    rng.reseed(static_cast<uint32_t>(time(0)));
 #ifdef GRAPH_COLOURING_HEURISTIC_DEBUG
     cout << "numExams = " << numExams << endl;
     cout << "numPeriods = " << numPeriods << endl;
@@ -1951,7 +1978,8 @@ void GCHeuristics<EOT>::initialiseVertexPriorityQueue(VertexPriorityQueue &_pq,
 /// USING RANDOM SEED GENERATE THE SAME SOLUTION FOR ALL INDIVIDUALS OF THE POPULATION
 ///
 //    std::srand(std::time(0)); // Seed random generator used in random_shuffle
-    std::random_shuffle(exams.begin(), exams.end());
+    // Draw from gen, not std::rand, so that the solution only depends on its generator
+    std::random_shuffle(exams.begin(), exams.end(), [](int _n) { return (int)gen->random(_n); });
 
 #ifdef GRAPH_COLOURING_HEURISTIC_DEBUG
     cout << "Random exams to insert into the priority queue: " << endl;
@@ -2146,7 +2174,7 @@ typename GCHeuristics<EOT>::i2tuple GCHeuristics<EOT>::selectValue(EOT &_chrom,
     //   end for
     }
     //   a = randomly selected a value from bestValues;
-    int idx = rng.uniform(bestValues.size());
+    int idx = gen->uniform(bestValues.size());
     i2tuple a = bestValues[idx];
     //   for each B/b ∈ conflicts(σ, A, a) do
     //     CBS[A=a -> B≠b]++;
@@ -2339,12 +2367,7 @@ void GCHeuristics<EOT>::updatePeriodAvailability(EOT &_chrom, int _ei, int _tj,
            "////////////////////////////////////////////////////////////////////////////////////////" << endl;
 #endif
    // Get adjacent vertices
-   property_map<AdjacencyList, vertex_index_t>::type index_map = get(vertex_index, _chrom.getExamGraph());
-   graph_traits<AdjacencyList>::adjacency_iterator ai, a_end;
-   boost::tie(ai, a_end) = adjacent_vertices(_ei, _chrom.getExamGraph());
-   for (; ai != a_end; ++ai) {
-       // Get adjacent exam
-       int ej = get(index_map, *ai);
+   for (int ej : _chrom.getCompactExamGraph().adjacent(_ei)) {
 
 #ifdef GRAPH_COLOURING_HEURISTIC_DEBUG_GRAPH
        cout << "Adjacent vertex ej = " << ej << endl;
@@ -0,0 +1,131 @@
+#ifndef ETTPBATCHINIT_H
+#define ETTPBATCHINIT_H
+
+#include <eoPop.h>
+#include <utils/eoRNG.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <iostream>
+#include "graphColouring/GraphColouringHeuristics.h"
+#include "utils/WorkStealingPool.h"
+
+
+/**
+ * Builds a batch of feasible solutions concurrently. Each solution is built by
+ * the saturation degree graph colouring heuristic (as in ETTPInit) on a worker
+ * of a thread pool, with its own random number generator. The timetable problem
+ * data is shared read-only by the workers.
+ *
+ * The seed of each solution is drawn serially from a master generator, so the
+ * batch does not depend on the number of threads nor on the scheduling.
+ */
+template <typename EOT>
+class ETTPBatchInit {
+
+public:
+    /**
+     * @brief ETTPBatchInit Constructor
+     * @param _timetableProblemData
+     * @param _numThreads Number of threads, including the calling thread
+     * @param _seed Seed of the master random number generator
+     */
+    ETTPBatchInit(TimetableProblemData const *_timetableProblemData, unsigned _numThreads, uint32_t _seed)
+        : timetableProblemData(_timetableProblemData), seedGen(_seed), pool(_numThreads), wallTime(0) { }
+
+    /**
+     * @brief operator () Initialise every solution of _pop
+     * @param _pop
+     */
+    void operator()(eoPop<EOT> &_pop) {
+        build(_pop.size(), [&_pop](unsigned _i) -> EOT& { return _pop[_i]; });
+    }
+
+    /**
+     * @brief operator () Replace the contents of _pop by _popSize new solutions
+     * @param _pop
+     * @param _popSize
+     */
+    void operator()(std::vector<boost::shared_ptr<EOT> > &_pop, unsigned _popSize) {
+        _pop.clear();
+        for (unsigned i = 0; i < _popSize; ++i)
+            _pop.push_back(boost::make_shared<EOT>());
+        build(_popSize, [&_pop](unsigned _i) -> EOT& { return *_pop[_i]; });
+    }
+
+    /**
+     * @brief getConstructionTimes
+     * @return Construction time (seconds) of each solution of the last batch
+     */
+    std::vector<double> const &getConstructionTimes() const {
+        return constructionTimes;
+    }
+
+    /**
+     * @brief getWallTime
+     * @return Elapsed time (seconds) of the last batch
+     */
+    double getWallTime() const {
+        return wallTime;
+    }
+
+    /**
+     * @brief printConstructionTimes Print construction time statistics of the last batch
+     * @param _os
+     */
+    void printConstructionTimes(std::ostream &_os) const {
+        if (constructionTimes.empty())
+            return;
+        double total = 0;
+        for (double t : constructionTimes)
+            total += t;
+        _os << "Solutions built: " << constructionTimes.size() << ", threads: " << pool.getNumThreads() << std::endl
+            << "Construction time (s): min = " << *std::min_element(constructionTimes.begin(), constructionTimes.end())
+            << ", mean = " << total / constructionTimes.size()
+            << ", max = " << *std::max_element(constructionTimes.begin(), constructionTimes.end())
+            << ", sum = " << total << ", wall = " << wallTime << std::endl;
+    }
+
+protected:
+    /**
+     * @brief build Build _popSize solutions concurrently
+     * @param _popSize
+     * @param _solution Returns the i-th solution
+     */
+    void build(unsigned _popSize, std::function<EOT&(unsigned)> const &_solution) {
+        typedef std::chrono::steady_clock Clock;
+        // Draw seeds serially
+        std::vector<uint32_t> seeds(_popSize);
+        for (auto &seed : seeds)
+            seed = seedGen.rand();
+        constructionTimes.assign(_popSize, 0);
+        auto batchStart = Clock::now();
+        pool.parallelFor(_popSize, [&](unsigned _i, unsigned) {
+            auto start = Clock::now();
+            eoRng gen(seeds[_i]);
+            EOT &chrom = _solution(_i);
+            chrom.setTimetableProblemData(timetableProblemData);
+            GCHeuristics<EOT>::saturationDegree(timetableProblemData, chrom, gen);
+            constructionTimes[_i] = std::chrono::duration<double>(Clock::now() - start).count();
+        });
+        wallTime = std::chrono::duration<double>(Clock::now() - batchStart).count();
+    }
+
+    // Instance fields
+    TimetableProblemData const *timetableProblemData;
+    // Master random number generator, draws the seed of each solution
+    eoRng seedGen;
+    // Thread pool
+    WorkStealingPool pool;
+    // Construction time of each solution of the last batch
+    std::vector<double> constructionTimes;
+    // Elapsed time of the last batch
+    double wallTime;
+};
+
+
+
+#endif // ETTPBATCHINIT_H
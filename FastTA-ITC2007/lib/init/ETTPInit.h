@@ -17,8 +17,20 @@ template <typename EOT>
 class ETTPInit : public eoInit<EOT> {
 
 public:
+    /**
+     * @brief ETTPInit The graph colouring heuristic reseeds the global generator with the current time
+     * @param _timetableProblemData
+     */
     ETTPInit(TimetableProblemData const *_timetableProblemData)
-        : timetableProblemData(_timetableProblemData) { }
+        : timetableProblemData(_timetableProblemData), gen(nullptr) { }
+    /**
+     * @brief ETTPInit The graph colouring heuristic draws from _gen, which is not reseeded,
+     * so that a run seeded by the caller is reproducible from its seed
+     * @param _timetableProblemData
+     * @param _gen
+     */
+    ETTPInit(TimetableProblemData const *_timetableProblemData, eoRng &_gen)
+        : timetableProblemData(_timetableProblemData), gen(&_gen) { }
 
 
     virtual void operator()(EOT &_chrom) {
@@ -39,7 +51,10 @@ public:
             // When it is not possible to schedule an exam without violating any of
             // the hard constraints, the chromosome is set to be infeasible and the
             // method returns to the caller.
-            GCHeuristics<EOT>::saturationDegree(timetableProblemData, _chrom);
+            if (gen)
+                GCHeuristics<EOT>::saturationDegree(timetableProblemData, _chrom, *gen);
+            else
+                GCHeuristics<EOT>::saturationDegree(timetableProblemData, _chrom);
 
             // Compute solution fitness
 //            _chrom.computeFitness();
@@ -60,6 +75,8 @@ private:
 
     // Instance fields
     TimetableProblemData const *timetableProblemData;
+    // Random generator of the graph colouring heuristic, null to reseed the global one
+    eoRng *gen;
 };
 
 
@@ -0,0 +1,213 @@
+#ifndef ETTPSOLUTIONINIT_H
+#define ETTPSOLUTIONINIT_H
+
+#include <eoInit.h>
+#include <string>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include "data/TimetableProblemData.hpp"
+#include "containers/TimetableContainer.h"
+#include "containers/CompactGraph.h"
+#include "testset/ITC2007Parser.h"
+#include "utils/MappedFile.h"
+#include "chromosome/SolutionArchive.h"
+
+
+// For debugging purposes
+//#define ETTPSOLUTIONINIT_DEBUG
+
+
+
+/**
+ * @brief The ETTPSolutionInit class. Warm start: initialise the chromosome from an
+ * ITC2007 solution file (.sln), as written by operator<<(ostream&, const eoChromosome&),
+ * instead of building a new one with the graph colouring heuristics.
+ *
+ * The file has one "period, room" line per exam, in the order of the instance file.
+ * It is parsed once, on construction; each call to operator() then only reschedules
+ * the exams, checks the hard constraints and computes the solution cost.
+ * A malformed file, or a solution violating any hard constraint, throws
+ * std::runtime_error.
+ *
+ * The solution may also be taken from a record of a binary solution archive
+ * (see SolutionArchive).
+ *
+ * To re-optimise the solution with moTA, pass a cooling schedule whose initial
+ * threshold (initT) is the chosen starting threshold. It is usually much lower than
+ * the one used from a constructed solution, so that the search does not first
+ * walk away from the good region it starts in.
+ */
+template <typename EOT>
+class ETTPSolutionInit : public eoInit<EOT> {
+
+public:
+    /**
+     * @brief ETTPSolutionInit Constructor. Reads the solution file
+     * @param _timetableProblemData
+     * @param _solutionFilename
+     */
+    ETTPSolutionInit(TimetableProblemData const *_timetableProblemData, std::string const &_solutionFilename)
+        : timetableProblemData(_timetableProblemData), solutionFilename(_solutionFilename) {
+        read();
+    }
+
+    /**
+     * @brief ETTPSolutionInit Constructor. Reads record _record of a solution archive.
+     * Throws std::runtime_error if the archive belongs to another instance.
+     * @param _timetableProblemData
+     * @param _archive
+     * @param _record
+     */
+    ETTPSolutionInit(TimetableProblemData const *_timetableProblemData, SolutionArchiveReader const &_archive,
+                     std::size_t _record)
+        : timetableProblemData(_timetableProblemData),
+          solutionFilename(_archive.getFilename() + "#" + std::to_string(_record)) {
+        read(_archive, _record);
+    }
+
+
+    virtual void operator()(EOT &_chrom) {
+
+#ifdef ETTPSOLUTIONINIT_DEBUG
+        std::cout << "ETTPSolutionInit::operator()" << std::endl;
+#endif
+        // Create an empty timetable
+        _chrom.setTimetableProblemData(timetableProblemData);
+        // Schedule each exam in its period and room. The timetable container keeps
+        // the room occupancy up to date.
+        TimetableContainer &timetableCont = _chrom.getTimetableContainer();
+        for (int ei = 0; ei < (int)assignment.size(); ++ei)
+            timetableCont.scheduleExam(ei, assignment[ei].first, assignment[ei].second);
+        // Verify hard constraints
+        verifyHardConstraints(_chrom);
+        _chrom.setFeasible(true);
+        // Compute solution cost
+        _chrom.computeCost();
+
+#ifdef ETTPSOLUTIONINIT_DEBUG
+        std::cout << "Solution read from " << solutionFilename << ", cost = " << _chrom.getSolutionCost() << std::endl;
+#endif
+    }
+
+
+    /**
+     * @brief getSolutionFilename
+     * @return
+     */
+    std::string const &getSolutionFilename() const { return solutionFilename; }
+
+private:
+
+    /**
+     * @brief read Parse the solution file into assignment
+     */
+    void read() {
+        int numExams = timetableProblemData->getNumExams();
+        int numPeriods = timetableProblemData->getNumPeriods();
+        int numRooms = timetableProblemData->getNumRooms();
+        assignment.reserve(numExams);
+        MappedFile file(solutionFilename);
+        ITC2007Parser parser(file.begin(), file.end());
+        try {
+            while (!parser.atEnd()) {
+                if ((int)assignment.size() == numExams)
+                    parser.error("more lines than the " + std::to_string(numExams) + " exams of the instance");
+                int tj = parser.readInt();
+                parser.expect(',');
+                int rk = parser.readInt();
+                parser.nextLine();
+                if (tj < 0 || tj >= numPeriods)
+                    parser.error("period " + std::to_string(tj) + " out of range");
+                if (rk < 0 || rk >= numRooms)
+                    parser.error("room " + std::to_string(rk) + " out of range");
+                assignment.push_back(std::make_pair(tj, rk));
+            }
+        }
+        catch (std::runtime_error const &e) {
+            throw std::runtime_error(solutionFilename + ": " + e.what());
+        }
+        if ((int)assignment.size() != numExams)
+            throw std::runtime_error(solutionFilename + ": " + std::to_string(assignment.size()) +
+                                     " exams scheduled, the instance has " + std::to_string(numExams));
+    }
+
+
+    /**
+     * @brief read Copy record _record of _archive into assignment
+     */
+    void read(SolutionArchiveReader const &_archive, std::size_t _record) {
+        int numExams = timetableProblemData->getNumExams();
+        if (_record >= _archive.getNumRecords())
+            throw std::runtime_error(solutionFilename + ": no such record, the archive has "
+                                     + std::to_string(_archive.getNumRecords()));
+        if (_archive.getNumExams() != numExams || _archive.getInstanceHash() != timetableProblemData->getInstanceHash())
+            throw std::runtime_error(solutionFilename + ": the archive holds solutions of another instance");
+        std::vector<int> periods(numExams), rooms(numExams);
+        _archive.getSolution(_record, periods.data(), rooms.data());
+        assignment.reserve(numExams);
+        for (int ei = 0; ei < numExams; ++ei) {
+            if (periods[ei] >= timetableProblemData->getNumPeriods() || rooms[ei] >= timetableProblemData->getNumRooms())
+                throw std::runtime_error(solutionFilename + ": exam " + std::to_string(ei) + " out of range");
+            assignment.push_back(std::make_pair(periods[ei], rooms[ei]));
+        }
+    }
+
+
+    /**
+     * @brief verifyHardConstraints Throw std::runtime_error on the first hard constraint violation.
+     * Pre-condition: all exams are scheduled.
+     * @param _chrom
+     */
+    void verifyHardConstraints(EOT const &_chrom) const {
+        auto const &examVector = _chrom.getExamVector();
+        auto const &roomVector = _chrom.getRoomVector();
+        auto const &scheduledRoomsVector = _chrom.getScheduledRoomsVector();
+        CompactGraph const &examGraph = _chrom.getCompactExamGraph();
+
+        for (int ei = 0; ei < (int)assignment.size(); ++ei) {
+            int tj = assignment[ei].first;
+            int rk = assignment[ei].second;
+            // Conflicts: no student sits two exams in the same period
+            for (int ej : examGraph.adjacent(ei)) {
+                if (ej > ei && assignment[ej].first == tj)
+                    violation("exams " + std::to_string(ei) + " and " + std::to_string(ej) +
+                              " share students and are both in period " + std::to_string(tj));
+            }
+            // Period-Utilisation
+            if (!_chrom.verifyPeriodUtilisationConstraint(ei, tj))
+                violation("exam " + std::to_string(ei) + " is longer than period " + std::to_string(tj));
+            // Period-Related
+            if (!_chrom.verifyPeriodRelatedConstraintsScheduled(ei, tj))
+                violation("exam " + std::to_string(ei) + " violates a period related constraint");
+            // Room-Related (ROOM_EXCLUSIVE)
+            if (!examVector[ei]->getRoomRelatedHardConstraints().empty() &&
+                    scheduledRoomsVector[rk].getNumExamsScheduled(tj) > 1)
+                violation("exam " + std::to_string(ei) + " is not alone in room " + std::to_string(rk));
+        }
+        // Room-Occupancy
+        for (int tj = 0; tj < _chrom.getNumPeriods(); ++tj) {
+            for (int rk = 0; rk < _chrom.getNumRooms(); ++rk) {
+                if (scheduledRoomsVector[rk].getNumOccupiedSeats(tj) > roomVector[rk]->getCapacity())
+                    violation("room " + std::to_string(rk) + " over capacity in period " + std::to_string(tj));
+            }
+        }
+    }
+
+
+    void violation(std::string const &_message) const {
+        throw std::runtime_error(solutionFilename + ": infeasible solution, " + _message);
+    }
+
+
+    // Instance fields
+    TimetableProblemData const *timetableProblemData;
+    // Solution file
+    std::string solutionFilename;
+    // (period, room) of each exam
+    std::vector<std::pair<int, int>> assignment;
+};
+
+
+
+#endif // ETTPSOLUTIONINIT_H
@@ -11,6 +11,8 @@
 #include <vector>
 #include <stdexcept>
 #include "containers/TimetableContainerMatrix.h" /// BECAUSE OF REMOVE_EXAM
+#include "utils/SearchTelemetry.h"
+#include "utils/PerfCounters.h"
 
 
 
@@ -63,8 +65,10 @@ private:
 public:
     /**
      * @brief ETTPKempeChainHeuristic Constructor
+     * @param _gen Random number generator used to build moves. Threads running
+     * concurrent searches must each supply their own generator.
      */
-    ETTPKempeChainHeuristic();
+    ETTPKempeChainHeuristic(eoRng &_gen = rng);
 
     /**
      * @brief build Create a Kempe chain for a random move
@@ -126,6 +130,11 @@ public:
      * @param _sol
      */
     void undoSolutionMove(EOT &_sol);
+    /**
+     * @brief setTelemetry Count the moves in _telemetry (nullptr disables the counters)
+     * @param _telemetry
+     */
+    void setTelemetry(SearchTelemetry *_telemetry);
 
 protected:
     /**
@@ -151,7 +160,7 @@ protected:
      * @param _roomDest
      * @param _conflictingExamsTdest
      */
-    void getSourceExamHardConflictsDestPeriod(int _examSource, AdjacencyList const &_examGraph,
+    void getSourceExamHardConflictsDestPeriod(int _examSource, CompactGraph const &_examGraph,
                                           int _tDest, int _roomDest,
                                           std::vector<typename GCHeuristics<EOT>::VariableValueTuple> &_conflictingExamsTdest) const;
 
@@ -263,6 +272,14 @@ protected:
      * @brief feasibleNeighbour
      */
     bool feasibleNeighbour;
+    /**
+     * @brief randGen Random number generator
+     */
+    eoRng &randGen;
+    /**
+     * @brief telemetry Search telemetry counters, if any
+     */
+    SearchTelemetry *telemetry;
 };
 
 
@@ -277,10 +294,11 @@ protected:
 
 /**
  * @brief ETTPKempeChainHeuristic Constructor
+ * @param _gen Random number generator used to build moves
  */
 template <typename EOT>
-ETTPKempeChainHeuristic<EOT>::ETTPKempeChainHeuristic()
-    : neighborFitness(0), neighborSolutionCost(0), feasibleNeighbour(false)
+ETTPKempeChainHeuristic<EOT>::ETTPKempeChainHeuristic(eoRng &_gen)
+    : neighborFitness(0), neighborSolutionCost(0), feasibleNeighbour(false), randGen(_gen), telemetry(nullptr)
 { }
 
 
@@ -312,17 +330,20 @@ void ETTPKempeChainHeuristic<EOT>::build(EOT &_sol)
     // 4. Slot move - Here two randomly chosen timeslots are interchanged
     // including all their exams and rooms.
     //
+    ETTP_TELEMETRY_TIMER(telemetry, Build);
+    ETTP_PERF_SCOPE(Build);
 
-
-    if (rng.flip() < 0.5) {
+    if (randGen.flip() < 0.5) {
          // Apply operator 2. Shift move - Here a random exam is moved into different
          // (randomly chosen) timeslot and room.
         shiftMove(_sol);
+        ETTP_TELEMETRY_HOOK(telemetry, moveBuilt(SearchTelemetry::ShiftMove));
     }
     else {
         // Apply operator 1. Room move - Here a random exam is just moved into a different
         // (randomly chosen) room within the same timeslot.
         roomMove(_sol);
+        ETTP_TELEMETRY_HOOK(telemetry, moveBuilt(SearchTelemetry::RoomMove));
 //        shiftMoveIfFeasible(_sol);
     }
 
@@ -349,6 +370,8 @@ void ETTPKempeChainHeuristic<EOT>::build(EOT &_sol)
  */
 template <typename EOT>
 void ETTPKempeChainHeuristic<EOT>::evaluateSolutionMove(EOT &_sol) {
+    ETTP_TELEMETRY_TIMER(telemetry, Evaluate);
+    ETTP_PERF_SCOPE(Evaluate);
 
 #ifdef DEBUG_MODE
     cout << "In [evaluateSolutionMove] method" << endl;
@@ -578,6 +601,8 @@ void ETTPKempeChainHeuristic<EOT>::operator()(EOT &_sol) {
     // ej, ek, ..., to time slot ti. This process is repeated until all the
     // exams that have students in common are assigned to different time slots.
     //
+    ETTP_TELEMETRY_TIMER(telemetry, Apply);
+    ETTP_PERF_SCOPE(Apply);
     doSolutionMove(_sol);
 }
 
@@ -674,6 +699,18 @@ void ETTPKempeChainHeuristic<EOT>::undoSolutionMove(EOT &_sol) {
 
 
 
+/**
+ * @brief setTelemetry Count the moves in _telemetry (nullptr disables the counters)
+ * @param _telemetry
+ */
+template <typename EOT>
+void ETTPKempeChainHeuristic<EOT>::setTelemetry(SearchTelemetry *_telemetry) {
+    telemetry = _telemetry;
+}
+
+
+
+
 /////////////////////////////////////////////////////////////////
 //
 // Protected members
@@ -726,7 +763,7 @@ void ETTPKempeChainHeuristic<EOT>::doFeasibleExamMove(
     // Get solution reference
     EOT &sol = this->kempeChain.getSolution();
     // Get exam graph reference
-    AdjacencyList const &examGraph = sol.getExamGraph();
+    CompactGraph const &examGraph = sol.getCompactExamGraph();
     // Timetable container
     TimetableContainer &timetableCont = sol.getTimetableContainer();
 //    // Get scheduled rooms vector
@@ -773,7 +810,7 @@ void ETTPKempeChainHeuristic<EOT>::doFeasibleExamMove(
 #endif
 
             // Generate random room index
-            randomDestRoom = rng.uniform(sol.getNumRooms());
+            randomDestRoom = randGen.uniform(sol.getNumRooms());
 
             // Dest room capacity
             capacityDestRoom = roomVector[randomDestRoom]->getCapacity();
@@ -1112,6 +1149,10 @@ void ETTPKempeChainHeuristic<EOT>::doFeasibleExamMove(
     }
 
 
+    // Kempe chain length: exams moved between the two periods
+    if (currentOperator == Operator::ShiftMove)
+        ETTP_TELEMETRY_HOOK(telemetry, chainLength(finalExamsTsource.size() + finalExamsTdest.size()));
+
     // Insert exams in Ti
     while (!finalExamsTsource.empty()) {
         // Get source exam
@@ -1211,7 +1252,7 @@ void ETTPKempeChainHeuristic<EOT>::doFeasibleExamMove(
  */
 template <typename EOT>
 void ETTPKempeChainHeuristic<EOT>
-    ::getSourceExamHardConflictsDestPeriod(int _examSource, AdjacencyList const &_examGraph,
+    ::getSourceExamHardConflictsDestPeriod(int _examSource, CompactGraph const &_examGraph,
                                        int _tDest, int _roomDest,
                                        std::vector<typename GCHeuristics<EOT>::VariableValueTuple> &_conflictingExamsTdest) const {
 
@@ -1388,7 +1429,7 @@ void ETTPKempeChainHeuristic<EOT>::selectRandomExam(TimetableContainer const &_t
     // Get period exams
     auto &periodExams = _timetableCont.getPeriodExams(_ti);
     // Generate random exam ei index
-    int randIdx = rng.random(periodExams.size());
+    int randIdx = randGen.random(periodExams.size());
     // Selected exam id to move
     auto &examRoomTuple = periodExams[randIdx];
     // Get exam
@@ -1441,7 +1482,7 @@ bool ETTPKempeChainHeuristic<EOT>::selectRandomRoomWithCapacity(EOT &_sol, int _
 //    // A feasible room was found
 //    return true;
 
-    return _sol.getFeasibleRoom(_ei, _tj, _rk);
+    return _sol.getFeasibleRoom(_ei, _tj, _rk, randGen);
 }
 
 
@@ -1460,9 +1501,9 @@ void ETTPKempeChainHeuristic<EOT>::selectRandomTimeslots(TimetableContainer cons
                                                          int &_ti, int &_tj) const {
     // Select randomly two time slots, ti and tj.
     do {
-        _ti = rng.random(_numPeriods);
+        _ti = randGen.random(_numPeriods);
         do {
-            _tj = rng.random(_numPeriods);
+            _tj = randGen.random(_numPeriods);
         }
         while (_ti == _tj);
     }
@@ -1486,7 +1527,7 @@ void ETTPKempeChainHeuristic<EOT>::selectRandomTimeslot(TimetableContainer const
                                                          int &_ti) const {
     // Select randomly a time slots, ti.
     do {
-        _ti = rng.random(_numPeriods);
+        _ti = randGen.random(_numPeriods);
     }
     // Repeat until we found a non-empty time slot ti
     while (_timetableCont.getPeriodSize(_ti) == 0);
@@ -42,7 +42,7 @@ class ETTPKempeChainHeuristicWithStatistics : public ETTPKempeChainHeuristic<EOT
 public:
 
     // Ctor
-    ETTPKempeChainHeuristicWithStatistics() : ETTPKempeChainHeuristic<EOT>() {
+    ETTPKempeChainHeuristicWithStatistics(eoRng &_gen = rng) : ETTPKempeChainHeuristic<EOT>(_gen) {
 
 #ifdef ETTPKEMPECHAINHEURISTICWITHSTATISTICS_DEBUG
     std::cout << "In ETTPKempeChainHeuristicWithStatistics<EOT>::ctor()" << std::endl;
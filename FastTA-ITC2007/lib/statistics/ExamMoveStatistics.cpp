@@ -38,10 +38,15 @@ boost::shared_ptr<string> ExamMoveStatistics::generateFilename() {
     stringstream sstream;
     sstream << outputDir << "/ExamMoveStatistics_" << testSet.getName() << "_cool_"
             << coolSchedule.initT << "_" << coolSchedule.alpha << "_"
-            << coolSchedule.span << "_" << coolSchedule.finalT << ".txt";
+            << coolSchedule.span << "_" << coolSchedule.finalT;
+    if (memeplex >= 0)
+        sstream << "_memeplex_" << memeplex;
+    sstream << ".txt";
     boost::shared_ptr<string> filename(new string());
     sstream >> *filename.get();
-    cout << *filename.get() << endl;
+    // Memeplex workers run concurrently: don't interleave their output
+    if (memeplex < 0)
+        cout << *filename.get() << endl;
     return filename;
 }
 
@@ -49,9 +54,11 @@ boost::shared_ptr<string> ExamMoveStatistics::generateFilename() {
 // Ctor
 ExamMoveStatistics::ExamMoveStatistics(TestSet const& _testSet, string const& _outputDir,
                                        int _numBins,
-                                       moSimpleCoolingSchedule<eoChromosome> &_coolSchedule)
+                                       moSimpleCoolingSchedule<eoChromosome> &_coolSchedule,
+                                       int _memeplex)
     : testSet(_testSet),                                  // Test set
       outputDir(_outputDir),                              // Output directory
+      memeplex(_memeplex),                                // Memeplex index
       examInfoVector(testSet.getTimetableProblemData()->getNumExams()), // ExamInfo vector
       numBins(_numBins),
       coolSchedule(_coolSchedule),                        // Cooling schedule
@@ -97,29 +104,15 @@ void ExamMoveStatistics::determineExamsColorDegree()
     cout << "determineExamsColorDegree()" << endl;
 
     // Get exam graph
-    AdjacencyList const& graph = getInitialSolution().getExamGraph();
+    CompactGraph const& graph = getInitialSolution().getCompactExamGraph();
 
-//    AdjacencyList const &graph = ptrInitialSolution->getExamGraph();
-
-    AdjacencyList::vertex_iterator vertexIt, vertexEnd;
-    AdjacencyList::adjacency_iterator neighbourIt, neighbourEnd;
-    tie(vertexIt, vertexEnd) = vertices(graph);
-    int count = 0, vertexDegree;
-    int numVertices = num_vertices(graph);
+    int numVertices = graph.getNumVertices();
     cout << "numVertices = " << numVertices << endl;
-//    cin.get();
 
-    for (; vertexIt != vertexEnd; ++vertexIt)
+    for (int vertex = 0; vertex < numVertices; ++vertex)
     {
-//        cout << *vertexIt << " is connected with ";
-//        tie(neighbourIt, neighbourEnd) = adjacent_vertices(*vertexIt, g);
-//        for (; neighbourIt != neighbourEnd; ++neighbourIt)
-//        cout << *neighbourIt << " ";
-//        cout << "\n";
-        vertexDegree = degree(*vertexIt, graph);
-//        cout << "Degree of vertex " << *vertexIt << ": " << vertexDegree << endl;
         // Set exam degree
-        examInfoVector[*vertexIt]->setExamColorDegree(vertexDegree);
+        examInfoVector[vertex]->setExamColorDegree(graph.degree(vertex));
     }
 //    cin.get();
 }
@@ -30,10 +30,13 @@ public:
      * @brief ExamMoveStatistics
      * @param _numThresholds
      * @param _coolSchedule
+     * @param _memeplex Index of the memeplex whose worker collects the statistics, appended
+     *   to the output filename so that concurrent workers write distinct files; -1 otherwise
      * @return
      */
     ExamMoveStatistics(TestSet const& _testSet, std::string const& _outputDir,
-                       int _numBins, moSimpleCoolingSchedule<eoChromosome> & _coolSchedule);
+                       int _numBins, moSimpleCoolingSchedule<eoChromosome> & _coolSchedule,
+                       int _memeplex = -1);
 
     //
     // Public interface
@@ -86,6 +89,7 @@ private:
     eoChromosome optimizedSolution;             // Optimized solution
     TestSet const& testSet;                     // Test set
     std::string const& outputDir;                    // Output directory
+    int memeplex;                               // Memeplex index, -1 if not collected by a memeplex worker
 
 
 /// TODO
@@ -0,0 +1,309 @@
+#ifndef FRIEDMANTEST_H
+#define FRIEDMANTEST_H
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <cmath>
+
+
+/**
+ * @brief The FriedmanTest class. Friedman test of k algorithms over N instances,
+ * followed by Holm's post-hoc procedure against the best ranked (control) algorithm,
+ * as computed by the Rankings/multipleTest tool.
+ *
+ * Results are costs: on each instance the lowest result gets rank 1, and tied
+ * results share the average of their ranks.
+ */
+class FriedmanTest {
+
+public:
+    /**
+     * @brief The Comparison struct. Comparison of one algorithm with the control algorithm
+     */
+    struct Comparison {
+        // Algorithm index
+        int algorithm;
+        // z = (R_i - R_0) / SE
+        double z;
+        // Unadjusted p-value
+        double p;
+        // Holm's threshold alpha / (k - i)
+        double alpha;
+        // Holm's adjusted p-value
+        double adjustedP;
+        // true if Holm's procedure rejects the hypothesis of equivalence with the control
+        bool rejected;
+    };
+
+    /**
+     * @brief FriedmanTest
+     * @param _results _results[i][j] is the result of algorithm j on instance i
+     * @param _alpha Significance level of Holm's procedure
+     */
+    inline FriedmanTest(std::vector<std::vector<double> > const &_results, double _alpha = 0.05);
+
+    /**
+     * @brief getAverageRanks
+     * @return Average rank of each algorithm
+     */
+    std::vector<double> const &getAverageRanks() const { return averageRanks; }
+    /**
+     * @brief getStatistic
+     * @return Friedman statistic, distributed according to chi-square with k-1 degrees of freedom
+     */
+    double getStatistic() const { return statistic; }
+    /**
+     * @brief getPValue
+     * @return
+     */
+    double getPValue() const { return pValue; }
+    /**
+     * @brief getImanDavenportStatistic
+     * @return Iman-Davenport statistic, distributed according to F with k-1 and (k-1)(N-1) degrees of freedom
+     */
+    double getImanDavenportStatistic() const { return imanDavenport; }
+    /**
+     * @brief getImanDavenportPValue
+     * @return
+     */
+    double getImanDavenportPValue() const { return imanDavenportPValue; }
+    /**
+     * @brief getControl
+     * @return Index of the best ranked algorithm
+     */
+    int getControl() const { return control; }
+    /**
+     * @brief getComparisons
+     * @return Comparisons with the control algorithm, by increasing p-value
+     */
+    std::vector<Comparison> const &getComparisons() const { return comparisons; }
+
+    /**
+     * @brief rank Rank _values, lowest first, averaging the ranks of ties
+     * @param _values
+     * @param _ranks
+     */
+    inline static void rank(std::vector<double> const &_values, std::vector<double> &_ranks);
+
+protected:
+    /**
+     * @brief chiSquarePValue
+     * @param _x
+     * @param _df
+     * @return P(X >= _x) for X chi-square distributed with _df degrees of freedom
+     */
+    inline static double chiSquarePValue(double _x, double _df);
+    /**
+     * @brief fPValue
+     * @param _x
+     * @param _df1
+     * @param _df2
+     * @return P(X >= _x) for X F distributed with _df1 and _df2 degrees of freedom
+     */
+    inline static double fPValue(double _x, double _df1, double _df2);
+    /**
+     * @brief gammaQ Regularised upper incomplete gamma function Q(a, x)
+     */
+    inline static double gammaQ(double _a, double _x);
+    /**
+     * @brief betaI Regularised incomplete beta function I_x(a, b)
+     */
+    inline static double betaI(double _a, double _b, double _x);
+    /**
+     * @brief betaContinuedFraction Continued fraction of the incomplete beta function
+     */
+    inline static double betaContinuedFraction(double _a, double _b, double _x);
+
+    // Average rank of each algorithm
+    std::vector<double> averageRanks;
+    // Friedman statistic and p-value
+    double statistic;
+    double pValue;
+    // Iman-Davenport statistic and p-value
+    double imanDavenport;
+    double imanDavenportPValue;
+    // Best ranked algorithm
+    int control;
+    // Comparisons with the control algorithm
+    std::vector<Comparison> comparisons;
+};
+
+
+
+FriedmanTest::FriedmanTest(std::vector<std::vector<double> > const &_results, double _alpha)
+    : statistic(0), pValue(1), imanDavenport(0), imanDavenportPValue(1), control(0) {
+    if (_results.empty() || _results[0].size() < 2)
+        throw std::runtime_error("Friedman test: at least one instance and two algorithms are required");
+    double n = _results.size();
+    int numAlgorithms = _results[0].size();
+    double k = numAlgorithms;
+
+    // Average ranks
+    averageRanks.assign(numAlgorithms, 0.0);
+    std::vector<double> ranks;
+    for (auto const &instanceResults : _results) {
+        if ((int)instanceResults.size() != numAlgorithms)
+            throw std::runtime_error("Friedman test: every instance must have a result for each algorithm");
+        rank(instanceResults, ranks);
+        for (int j = 0; j < numAlgorithms; ++j)
+            averageRanks[j] += ranks[j] / n;
+    }
+    control = std::min_element(averageRanks.begin(), averageRanks.end()) - averageRanks.begin();
+
+    // Friedman and Iman-Davenport statistics
+    double sumSquares = 0;
+    for (double r : averageRanks)
+        sumSquares += r*r;
+    statistic = 12*n / (k*(k+1)) * (sumSquares - k*(k+1)*(k+1)/4);
+    pValue = chiSquarePValue(statistic, k-1);
+    double denominator = n*(k-1) - statistic;
+    if (n > 1 && denominator > 0) {
+        imanDavenport = (n-1)*statistic / denominator;
+        imanDavenportPValue = fPValue(imanDavenport, k-1, (k-1)*(n-1));
+    }
+    else {
+        // Identical rankings on every instance
+        imanDavenport = INFINITY;
+        imanDavenportPValue = 0;
+    }
+
+    // Holm's procedure against the control algorithm
+    double se = std::sqrt(k*(k+1) / (6*n));
+    for (int j = 0; j < numAlgorithms; ++j) {
+        if (j == control)
+            continue;
+        Comparison comparison;
+        comparison.algorithm = j;
+        comparison.z = (averageRanks[j] - averageRanks[control]) / se;
+        comparison.p = std::erfc(std::fabs(comparison.z) / std::sqrt(2.0));
+        comparisons.push_back(comparison);
+    }
+    std::stable_sort(comparisons.begin(), comparisons.end(),
+                     [](Comparison const &_c1, Comparison const &_c2) { return _c1.p < _c2.p; });
+    double maxAdjustedP = 0;
+    bool rejecting = true;
+    for (std::size_t i = 0; i < comparisons.size(); ++i) {
+        double m = comparisons.size() - i;
+        comparisons[i].alpha = _alpha / m;
+        maxAdjustedP = std::max(maxAdjustedP, std::min(1.0, m*comparisons[i].p));
+        comparisons[i].adjustedP = maxAdjustedP;
+        rejecting = rejecting && comparisons[i].p <= comparisons[i].alpha;
+        comparisons[i].rejected = rejecting;
+    }
+}
+
+
+void FriedmanTest::rank(std::vector<double> const &_values, std::vector<double> &_ranks) {
+    std::vector<int> order(_values.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&_values](int _i, int _j) { return _values[_i] < _values[_j]; });
+    _ranks.resize(_values.size());
+    for (std::size_t first = 0; first < order.size(); ) {
+        std::size_t last = first + 1;
+        while (last < order.size() && _values[order[last]] == _values[order[first]])
+            ++last;
+        // Positions first..last-1 hold tied values: ranks first+1..last
+        double averageRank = (first + 1 + last) / 2.0;
+        for (std::size_t i = first; i < last; ++i)
+            _ranks[order[i]] = averageRank;
+        first = last;
+    }
+}
+
+
+double FriedmanTest::chiSquarePValue(double _x, double _df) {
+    if (_x <= 0)
+        return 1;
+    return gammaQ(_df/2, _x/2);
+}
+
+
+double FriedmanTest::fPValue(double _x, double _df1, double _df2) {
+    if (_x <= 0)
+        return 1;
+    return betaI(_df2/2, _df1/2, _df2 / (_df2 + _df1*_x));
+}
+
+
+double FriedmanTest::gammaQ(double _a, double _x) {
+    const int maxIterations = 1000;
+    const double eps = 1e-15, tiny = 1e-300;
+    double logPrefix = -_x + _a*std::log(_x) - std::lgamma(_a);
+    if (_x < _a + 1) {
+        // Series of P(a, x)
+        double ap = _a, delta = 1/_a, sum = delta;
+        for (int i = 0; i < maxIterations && std::fabs(delta) > std::fabs(sum)*eps; ++i) {
+            ap += 1;
+            delta *= _x/ap;
+            sum += delta;
+        }
+        return 1 - sum*std::exp(logPrefix);
+    }
+    // Continued fraction of Q(a, x) (modified Lentz)
+    double b = _x + 1 - _a, c = 1/tiny, d = 1/b, h = d;
+    for (int i = 1; i <= maxIterations; ++i) {
+        double an = -i*(i - _a);
+        b += 2;
+        d = an*d + b;
+        if (std::fabs(d) < tiny) d = tiny;
+        c = b + an/c;
+        if (std::fabs(c) < tiny) c = tiny;
+        d = 1/d;
+        double delta = d*c;
+        h *= delta;
+        if (std::fabs(delta - 1) < eps)
+            break;
+    }
+    return std::exp(logPrefix)*h;
+}
+
+
+double FriedmanTest::betaI(double _a, double _b, double _x) {
+    if (_x <= 0)
+        return 0;
+    if (_x >= 1)
+        return 1;
+    double logPrefix = std::lgamma(_a+_b) - std::lgamma(_a) - std::lgamma(_b)
+            + _a*std::log(_x) + _b*std::log(1-_x);
+    if (_x < (_a+1) / (_a+_b+2))
+        return std::exp(logPrefix) * betaContinuedFraction(_a, _b, _x) / _a;
+    return 1 - std::exp(logPrefix) * betaContinuedFraction(_b, _a, 1-_x) / _b;
+}
+
+
+double FriedmanTest::betaContinuedFraction(double _a, double _b, double _x) {
+    const int maxIterations = 1000;
+    const double eps = 1e-15, tiny = 1e-300;
+    double qab = _a+_b, qap = _a+1, qam = _a-1;
+    double c = 1, d = 1 - qab*_x/qap;
+    if (std::fabs(d) < tiny) d = tiny;
+    d = 1/d;
+    double h = d;
+    for (int m = 1; m <= maxIterations; ++m) {
+        int m2 = 2*m;
+        double aa = m*(_b-m)*_x / ((qam+m2)*(_a+m2));
+        d = 1 + aa*d;
+        if (std::fabs(d) < tiny) d = tiny;
+        c = 1 + aa/c;
+        if (std::fabs(c) < tiny) c = tiny;
+        d = 1/d;
+        h *= d*c;
+        aa = -(_a+m)*(qab+m)*_x / ((_a+m2)*(qap+m2));
+        d = 1 + aa*d;
+        if (std::fabs(d) < tiny) d = tiny;
+        c = 1 + aa/c;
+        if (std::fabs(c) < tiny) c = tiny;
+        d = 1/d;
+        double delta = d*c;
+        h *= delta;
+        if (std::fabs(delta - 1) < eps)
+            break;
+    }
+    return h;
+}
+
+
+#endif // FRIEDMANTEST_H
@@ -24,11 +24,6 @@
 #include "algorithms/mo/moTA.h"
 
 
-#define HIGH_DEGREE_EXAM_INDEX_PERCENTAGE 0.80 // FastTA80
-//#define HIGH_DEGREE_EXAM_INDEX_PERCENTAGE 1  // FastTA100
-//#define HIGH_DEGREE_EXAM_INDEX_PERCENTAGE 0 // FastTA (not freezing any exam, equivalent to original but using threshold bin structure)
-
-
 //#define EXAMMOVESTATISTICS_DEBUG
 
 //#define EXAMMOVESTATISTICS_DEBUG1
@@ -71,7 +66,8 @@ void ExamMoveStatisticsOpt::generateInitialSolution() {
 // Ctor
 ExamMoveStatisticsOpt::ExamMoveStatisticsOpt(TestSet const& _testSet, string const& _outputDir,
                                        int _numBins,
-                                       moSimpleCoolingSchedule<eoChromosome> &_coolSchedule)
+                                       moSimpleCoolingSchedule<eoChromosome> &_coolSchedule,
+                                       double _highDegreeExamFraction)
     : testSet(_testSet),                                  // Test set
       outputDir(_outputDir),                              // Output directory
       numBins(_numBins),
@@ -85,8 +81,12 @@ ExamMoveStatisticsOpt::ExamMoveStatisticsOpt(TestSet const& _testSet, string con
       ptrPreviousCounts(nullptr),
       ptrCurrentCounts(&moveCountsCurrentThreshold),
       currentThresholdIndex(0),
+      highDegreeExamFraction(_highDegreeExamFraction),
       examDegree(testSet.getTimetableProblemData()->getNumExams()),
-      examIndexByColorDegree(testSet.getTimetableProblemData()->getNumExams())
+      examIndexByColorDegree(testSet.getTimetableProblemData()->getNumExams()),
+      checkpointInterval(0),
+      checkpointStopIteration(0),
+      resumed(false)
 { }
 
 
@@ -183,32 +183,6 @@ void ExamMoveStatisticsOpt::run() {
     // Determine exams color degree
     determineExamsColorDegree();
 
-    //
-    // Local search used: Threshold Accepting algorithm
-    //
-
-    //
-    // moTA with statistics
-    //
-    // moTA parameters
-    boost::shared_ptr<ETTPKempeChainHeuristicWithStatistics<eoChromosome> > kempeChainHeuristic(
-                new ETTPKempeChainHeuristicWithStatistics<eoChromosome>());
-    // eoEvalFunc used to evaluate the solutions
-//    eoETTPEval<eoChromosome> fullEval;
-    // # evaluations counter
-    eoNumberEvalsCounter numEvalsCounter;
-    // eoETTPEvalWithStatistics used to evaluate the solutions; receives as argument an
-    // eoNumberEvalsCounter for counting neigbour # evaluations
-    eoETTPEvalNumberEvalsCounter<eoChromosome> fullEval(numEvalsCounter);
-    /// CHANGED: RECEIVE PTR
-    ETTPNeighborhoodWithStatistics<eoChromosome>neighborhood(kempeChainHeuristic);
-//    ETTPneighborEvalWithStatistics<eoChromosome> neighEval; // LAST
-    // ETTPneighborEvalWithStatistics which receives as argument an
-    // eoNumberEvalsCounter for counting neigbour # evaluations
-    ETTPneighborEvalWithStatisticsNumberEvalsCounter<eoChromosome> neighEval(numEvalsCounter);
-
-    moTAWithStatisticsOpt<ETTPneighborWithStatistics<eoChromosome> > ta(*this, neighborhood, fullEval, neighEval, coolSchedule);
-
     /////// Write to output File ///////////////////////////////////////////
     cout << "Start Date/Time = " << currentDateTime() << endl;
     // Write Start time and algorithm parameters to file
@@ -230,7 +204,9 @@ void ExamMoveStatisticsOpt::run() {
     cout << "Before TA - initialSolution.fitness() = " << initialSolution.fitness() << endl;
 
     // Apply TA to the solution
-    ta(initialSolution);
+    long numEvals = search(initialSolution);
+    if (resumed)
+        outFile << "resumed from checkpoint: " << checkpointFilename << endl;
 
     // Validate solution
 //    initialSolution.validate();
@@ -243,8 +219,8 @@ void ExamMoveStatisticsOpt::run() {
     // Print solution fitness
     outFile << "Solution fitness = " << initialSolution.fitness() << endl;
     // Print real # evaluations performed
-    std::cout << "# evaluations performed = " << numEvalsCounter.getTotalNumEvals() << std::endl;
-    outFile << "# evaluations performed = " << numEvalsCounter.getTotalNumEvals() << endl;
+    std::cout << "# evaluations performed = " << numEvals << std::endl;
+    outFile << "# evaluations performed = " << numEvals << endl;
     // Print solution timetable to file
     outFile << initialSolution << endl;
     outFile << "==============================================================" << endl;
@@ -263,6 +239,82 @@ void ExamMoveStatisticsOpt::run() {
 }
 
 
+//
+// Apply FastTA to _solution: run TA with exam fixing. The thresholds and the exams color
+// degree must have been determined. Returns the # evaluations performed.
+// With a checkpoint (setCheckpoint), _solution is replaced by the checkpointed one when
+// resuming, and ends as the best solution found.
+//
+long ExamMoveStatisticsOpt::search(eoChromosome &_solution) {
+    //
+    // Local search used: Threshold Accepting algorithm
+    //
+
+    //
+    // moTA with statistics
+    //
+    // moTA parameters
+    boost::shared_ptr<ETTPKempeChainHeuristicWithStatistics<eoChromosome> > kempeChainHeuristic(
+                new ETTPKempeChainHeuristicWithStatistics<eoChromosome>());
+    // eoEvalFunc used to evaluate the solutions
+//    eoETTPEval<eoChromosome> fullEval;
+    // # evaluations counter
+    eoNumberEvalsCounter numEvalsCounter;
+    // eoETTPEvalWithStatistics used to evaluate the solutions; receives as argument an
+    // eoNumberEvalsCounter for counting neigbour # evaluations
+    eoETTPEvalNumberEvalsCounter<eoChromosome> fullEval(numEvalsCounter);
+    /// CHANGED: RECEIVE PTR
+    ETTPNeighborhoodWithStatistics<eoChromosome>neighborhood(kempeChainHeuristic);
+//    ETTPneighborEvalWithStatistics<eoChromosome> neighEval; // LAST
+    // ETTPneighborEvalWithStatistics which receives as argument an
+    // eoNumberEvalsCounter for counting neigbour # evaluations
+    ETTPneighborEvalWithStatisticsNumberEvalsCounter<eoChromosome> neighEval(numEvalsCounter);
+
+    moTAWithStatisticsOpt<ETTPneighborWithStatistics<eoChromosome> > ta(*this, neighborhood, fullEval, neighEval, coolSchedule);
+
+    // Checkpoint, saving the exam fixing state: restore the search state of an interrupted run, if any.
+    // The Kempe chain heuristic draws from rng.
+    boost::shared_ptr<moTACheckpoint<ETTPneighborWithStatistics<eoChromosome> > > checkpoint;
+    resumed = false;
+    if (!checkpointFilename.empty()) {
+        checkpoint = boost::make_shared<moTACheckpoint<ETTPneighborWithStatistics<eoChromosome> > >(
+                    checkpointFilename, checkpointInterval, testSet.getTimetableProblemData().get(),
+                    coolSchedule, numEvalsCounter, rng);
+        checkpoint->setState(this);
+        checkpoint->setStopIteration(checkpointStopIteration);
+        resumed = checkpoint->resume(_solution);
+        ta.setContinuator(*checkpoint);
+    }
+
+    // Apply TA to the solution, unless the checkpoint was taken at the end of the search
+    if (!(resumed && checkpoint->isFinished()))
+        ta(_solution);
+
+    // TA ends at its current solution: return the best one, kept by the checkpoint across resumes
+    if (checkpoint) {
+        eoChromosome bestSolution;
+        checkpoint->getBestSolution(bestSolution);
+        if (bestSolution.fitness() < _solution.fitness())
+            _solution = bestSolution;
+    }
+    return numEvalsCounter.getTotalNumEvals();
+}
+
+
+
+void ExamMoveStatisticsOpt::setCheckpoint(string const& _filename, unsigned long _interval, uint64_t _stopIteration) {
+    checkpointFilename = _filename;
+    checkpointInterval = _interval;
+    checkpointStopIteration = _stopIteration;
+}
+
+
+
+bool ExamMoveStatisticsOpt::isResumed() const {
+    return resumed;
+}
+
+
 //// Get index in the threshold array given a threshold
 //int ExamMoveStatisticsOpt::getThresholdIndex(double _threshold) const {
 //    // Threshold array is sorted in descending order. Example: [0.1, 0.01, 0.001, 0.0001, ..., 2e-5]
@@ -363,9 +415,40 @@ void ExamMoveStatisticsOpt::updateThreshold(double _threshold) {
 }
 
 
+// Save exam fixing state: current threshold index, whether previous counts
+// exist, then the previous and current move counts
+void ExamMoveStatisticsOpt::saveState(std::vector<int> &_state) const {
+    _state.clear();
+    _state.push_back(currentThresholdIndex);
+    _state.push_back(ptrPreviousCounts != nullptr);
+    if (ptrPreviousCounts != nullptr)
+        _state.insert(_state.end(), ptrPreviousCounts->begin(), ptrPreviousCounts->end());
+    _state.insert(_state.end(), ptrCurrentCounts->begin(), ptrCurrentCounts->end());
+}
+
+
+// Restore exam fixing state saved by saveState
+void ExamMoveStatisticsOpt::restoreState(std::vector<int> const &_state) {
+    int numExams = moveCountsCurrentThreshold.size();
+    if (_state.size() < 2 || _state.size() != 2 + (_state[1] ? 2 : 1)*(std::size_t)numExams)
+        throw std::runtime_error("ExamMoveStatisticsOpt: invalid checkpoint state");
+    currentThresholdIndex = _state[0];
+    auto it = _state.begin() + 2;
+    if (_state[1]) {
+        moveCountsPreviousThreshold.assign(it, it + numExams);
+        ptrPreviousCounts = &moveCountsPreviousThreshold;
+        it += numExams;
+    }
+    else
+        ptrPreviousCounts = nullptr;
+    moveCountsCurrentThreshold.assign(it, it + numExams);
+    ptrCurrentCounts = &moveCountsCurrentThreshold;
+}
+
+
 // Return true if it is a large degree exam
 bool ExamMoveStatisticsOpt::isLargestDegree(int _examToMove) {
-    return examIndexByColorDegree[_examToMove] < testSet.getTimetableProblemData()->getNumExams() * HIGH_DEGREE_EXAM_INDEX_PERCENTAGE;
+    return examIndexByColorDegree[_examToMove] < testSet.getTimetableProblemData()->getNumExams() * highDegreeExamFraction;
 }
 
 
@@ -375,7 +458,7 @@ void ExamMoveStatisticsOpt::determineExamsColorDegree() {
     cout << "determineExamsColorDegree()" << endl;
 
     // Get exam graph
-    AdjacencyList const& graph = getInitialSolution().getExamGraph();
+    AdjacencyList const& graph = testSet.getTimetableProblemData()->getExamGraph();
 
     AdjacencyList::vertex_iterator vertexIt, vertexEnd;
 //    AdjacencyList::adjacency_iterator neighbourIt, neighbourEnd;
@@ -398,6 +481,9 @@ void ExamMoveStatisticsOpt::determineExamsColorDegree() {
 
 
 
+// In an anonymous namespace: ExamMoveStatistics.cpp has its own Criterium
+namespace {
+
 class Criterium {
 public:
     bool operator()(const std::pair<int,int> &_left, const std::pair<int,int> &_right) const {
@@ -405,6 +491,8 @@ public:
     }
 };
 
+}
+
 
 
 // Sort ExamInfo array in descending order by exam conflict degree
@@ -17,20 +17,31 @@
 #include "statistics/optimised/ExamInfoOpt.h"
 #include "testset/TestSet.h"
 #include "eval/eoETTPEval.h"
+#include "algorithms/mo/moTACheckpoint.h"
 
 #include <boost/unordered_map.hpp>
 
-class ExamMoveStatisticsOpt {
+
+// Default fraction of the exams, by decreasing conflict degree, that can be fixed
+#define HIGH_DEGREE_EXAM_INDEX_PERCENTAGE 0.80 // FastTA80
+//#define HIGH_DEGREE_EXAM_INDEX_PERCENTAGE 1  // FastTA100
+//#define HIGH_DEGREE_EXAM_INDEX_PERCENTAGE 0 // FastTA (not freezing any exam, equivalent to original but using threshold bin structure)
+
+
+class ExamMoveStatisticsOpt : public moCheckpointState {
 
 public:
     /**
      * @brief ExamMoveStatisticsOpt
      * @param _numThresholds
      * @param _coolSchedule
+     * @param _highDegreeExamFraction Fraction of the exams, by decreasing conflict degree,
+     * that can be fixed: 0.8 for FastTA80, 1 for FastTA100
      * @return
      */
     ExamMoveStatisticsOpt(TestSet const &_testSet, std::string const& _outputDir,
-                       int _numBins, moSimpleCoolingSchedule<eoChromosome> & _coolSchedule);
+                       int _numBins, moSimpleCoolingSchedule<eoChromosome> & _coolSchedule,
+                       double _highDegreeExamFraction = HIGH_DEGREE_EXAM_INDEX_PERCENTAGE);
 
     //
     // Public interface
@@ -42,6 +53,16 @@ public:
     void generateThresholds();
 
     void run();
+    // Apply FastTA to _solution, already initialised and evaluated, without writing the
+    // solution to the output file. Call generateThresholds and determineExamsColorDegree
+    // first. Returns the # evaluations performed.
+    long search(eoChromosome &_solution);
+    // Checkpoint the search to _filename every _interval iterations, and resume from that
+    // file if it exists; _solution then ends as the best solution found. A nonzero
+    // _stopIteration stops the search at that iteration (see moTACheckpoint).
+    void setCheckpoint(std::string const& _filename, unsigned long _interval, uint64_t _stopIteration = 0);
+    // Return true if the last search resumed from the checkpoint
+    bool isResumed() const;
 
     // Get index in the threshold array given a threshold
     int getThresholdIndex(double _threshold) const;
@@ -58,6 +79,9 @@ public:
     void determineExamsColorDegree();
     // Sort
     void sort();
+    // Exam fixing state, saved in TA checkpoints (see moTACheckpoint)
+    virtual void saveState(std::vector<int> &_state) const override;
+    virtual void restoreState(std::vector<int> const &_state) override;
 
 private:
     boost::shared_ptr<std::string> generateFilename();
@@ -89,10 +113,18 @@ private:
     std::vector<int> *ptrCurrentCounts;
 
     int currentThresholdIndex;
+    // Fraction of the exams, by decreasing conflict degree, that can be fixed
+    double highDegreeExamFraction;
     // Exam color degree
     std::vector<std::pair<int,int>> examDegree;
     // Exam index sorted by color degree
     std::vector<int> examIndexByColorDegree;
+    // Checkpoint file, or empty, # iterations between checkpoints and stop iteration
+    std::string checkpointFilename;
+    unsigned long checkpointInterval;
+    uint64_t checkpointStopIteration;
+    // true if the last search resumed from the checkpoint
+    bool resumed;
 };
 
 
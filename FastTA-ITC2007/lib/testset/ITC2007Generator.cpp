@@ -0,0 +1,572 @@
+#include "testset/ITC2007Generator.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <unordered_set>
+#include <stdexcept>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+
+
+using namespace std;
+
+
+// ITC2007 files end their lines with a carriage return and a line feed
+static char const *EOL = "\r\n";
+
+
+namespace {
+
+int parseInt(string const &_name, string const &_value) {
+    char *end;
+    errno = 0;
+    long value = strtol(_value.c_str(), &end, 10);
+    if (_value.empty() || *end != '\0' || errno != 0 || value < INT32_MIN || value > INT32_MAX)
+        throw runtime_error(_name + ": not an integer: " + _value);
+    return (int)value;
+}
+
+
+double parseDouble(string const &_name, string const &_value) {
+    char *end;
+    errno = 0;
+    double value = strtod(_value.c_str(), &end);
+    if (_value.empty() || *end != '\0' || errno != 0)
+        throw runtime_error(_name + ": not a number: " + _value);
+    return value;
+}
+
+
+vector<int> parseIntList(string const &_name, string const &_value) {
+    vector<int> values;
+    stringstream sstream(_value);
+    string field;
+    while (getline(sstream, field, ','))
+        values.push_back(parseInt(_name, field));
+    return values;
+}
+
+
+/**
+ * @brief poisson Poisson distributed integer with mean _mean
+ */
+int poisson(eoRng &_gen, double _mean) {
+    if (_mean <= 0)
+        return 0;
+    if (_mean > 30)
+        return max(0, (int)lround(_mean + sqrt(_mean) * _gen.normal()));
+    // Knuth's method
+    double limit = exp(-_mean), product = _gen.uniform();
+    int k = 0;
+    while (product > limit) {
+        ++k;
+        product *= _gen.uniform();
+    }
+    return k;
+}
+
+
+/**
+ * @brief addDay Advance date _day/_month/_year by one day
+ */
+void addDay(int &_day, int &_month, int &_year) {
+    static const int daysPerMonth[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    bool leapYear = (_year % 4 == 0 && _year % 100 != 0) || _year % 400 == 0;
+    int numDays = daysPerMonth[_month-1] + ((_month == 2 && leapYear) ? 1 : 0);
+    if (++_day > numDays) {
+        _day = 1;
+        if (++_month > 12) {
+            _month = 1;
+            ++_year;
+        }
+    }
+}
+
+}
+
+
+
+ITC2007Generator::Parameters::Parameters()
+    : seed(1), numExams(607), numStudents(7891), meanExamsPerStudent(4.1), maxExamsPerStudent(12),
+      numProgrammes(0), programmeAffinity(0.97), popularitySigma(1.2), durations({ 60, 90, 120, 150, 180 }),
+      numDays(18), periodsPerDay(3), periodDuration(180), periodPenaltyRate(0.2), periodPenalty(10),
+      numRooms(7), minRoomCapacity(40), maxRoomCapacity(260), roomPenaltyRate(0.3), roomPenalty(10),
+      afterDensity(0.02), coincidenceDensity(0.005), exclusionDensity(0.002), roomExclusiveDensity(0.002),
+      twoInARow(7), twoInADay(5), periodSpread(5), nonMixedDurations(10), frontLoad{ 100, 30, 5 } {
+}
+
+
+void ITC2007Generator::Parameters::set(string const &_name, string const &_value) {
+    if (_name == "seed")
+        seed = (uint32_t)parseInt(_name, _value);
+    else if (_name == "exams")
+        numExams = parseInt(_name, _value);
+    else if (_name == "students")
+        numStudents = parseInt(_name, _value);
+    else if (_name == "examsPerStudent")
+        meanExamsPerStudent = parseDouble(_name, _value);
+    else if (_name == "maxExamsPerStudent")
+        maxExamsPerStudent = parseInt(_name, _value);
+    else if (_name == "programmes")
+        numProgrammes = parseInt(_name, _value);
+    else if (_name == "affinity")
+        programmeAffinity = parseDouble(_name, _value);
+    else if (_name == "popularitySigma")
+        popularitySigma = parseDouble(_name, _value);
+    else if (_name == "durations")
+        durations = parseIntList(_name, _value);
+    else if (_name == "days")
+        numDays = parseInt(_name, _value);
+    else if (_name == "periodsPerDay")
+        periodsPerDay = parseInt(_name, _value);
+    else if (_name == "periodDuration")
+        periodDuration = parseInt(_name, _value);
+    else if (_name == "periodPenaltyRate")
+        periodPenaltyRate = parseDouble(_name, _value);
+    else if (_name == "periodPenalty")
+        periodPenalty = parseInt(_name, _value);
+    else if (_name == "rooms")
+        numRooms = parseInt(_name, _value);
+    else if (_name == "minRoomCapacity")
+        minRoomCapacity = parseInt(_name, _value);
+    else if (_name == "maxRoomCapacity")
+        maxRoomCapacity = parseInt(_name, _value);
+    else if (_name == "roomPenaltyRate")
+        roomPenaltyRate = parseDouble(_name, _value);
+    else if (_name == "roomPenalty")
+        roomPenalty = parseInt(_name, _value);
+    else if (_name == "after")
+        afterDensity = parseDouble(_name, _value);
+    else if (_name == "coincidence")
+        coincidenceDensity = parseDouble(_name, _value);
+    else if (_name == "exclusion")
+        exclusionDensity = parseDouble(_name, _value);
+    else if (_name == "roomExclusive")
+        roomExclusiveDensity = parseDouble(_name, _value);
+    else if (_name == "twoInARow")
+        twoInARow = parseInt(_name, _value);
+    else if (_name == "twoInADay")
+        twoInADay = parseInt(_name, _value);
+    else if (_name == "periodSpread")
+        periodSpread = parseInt(_name, _value);
+    else if (_name == "nonMixedDurations")
+        nonMixedDurations = parseInt(_name, _value);
+    else if (_name == "frontLoad") {
+        vector<int> values = parseIntList(_name, _value);
+        if (values.size() != 3)
+            throw runtime_error(_name + ": expected # largest exams, # last periods, penalty: " + _value);
+        copy(values.begin(), values.end(), frontLoad);
+    }
+    else
+        throw runtime_error("unknown parameter: " + _name);
+}
+
+
+void ITC2007Generator::Parameters::print(ostream &_os) const {
+    _os << "seed=" << seed << endl
+        << "exams=" << numExams << endl
+        << "students=" << numStudents << endl
+        << "examsPerStudent=" << meanExamsPerStudent << endl
+        << "maxExamsPerStudent=" << maxExamsPerStudent << endl
+        << "programmes=" << numProgrammes << endl
+        << "affinity=" << programmeAffinity << endl
+        << "popularitySigma=" << popularitySigma << endl
+        << "durations=";
+    for (size_t i = 0; i < durations.size(); ++i)
+        _os << (i > 0 ? "," : "") << durations[i];
+    _os << endl
+        << "days=" << numDays << endl
+        << "periodsPerDay=" << periodsPerDay << endl
+        << "periodDuration=" << periodDuration << endl
+        << "periodPenaltyRate=" << periodPenaltyRate << endl
+        << "periodPenalty=" << periodPenalty << endl
+        << "rooms=" << numRooms << endl
+        << "minRoomCapacity=" << minRoomCapacity << endl
+        << "maxRoomCapacity=" << maxRoomCapacity << endl
+        << "roomPenaltyRate=" << roomPenaltyRate << endl
+        << "roomPenalty=" << roomPenalty << endl
+        << "after=" << afterDensity << endl
+        << "coincidence=" << coincidenceDensity << endl
+        << "exclusion=" << exclusionDensity << endl
+        << "roomExclusive=" << roomExclusiveDensity << endl
+        << "twoInARow=" << twoInARow << endl
+        << "twoInADay=" << twoInADay << endl
+        << "periodSpread=" << periodSpread << endl
+        << "nonMixedDurations=" << nonMixedDurations << endl
+        << "frontLoad=" << frontLoad[0] << "," << frontLoad[1] << "," << frontLoad[2] << endl;
+}
+
+
+void ITC2007Generator::Parameters::validate() const {
+    if (numExams < 1 || numStudents < 1)
+        throw runtime_error("there must be at least one exam and one student");
+    if (meanExamsPerStudent < 1 || maxExamsPerStudent < 1)
+        throw runtime_error("students take at least one exam");
+    if (numDays < 1 || periodsPerDay < 1 || periodDuration < 1)
+        throw runtime_error("there must be at least one period");
+    if (maxExamsPerStudent > numDays * periodsPerDay)
+        throw runtime_error("maxExamsPerStudent exceeds the # periods: the instance would be infeasible");
+    if (periodsPerDay * periodDuration > 24 * 60)
+        throw runtime_error("the periods of a day don't fit in 24 hours");
+    if (durations.empty())
+        throw runtime_error("no exam durations");
+    for (int duration : durations) {
+        if (duration < 1 || duration > periodDuration)
+            throw runtime_error("exam durations must be positive and fit in a period");
+    }
+    if (numRooms < 1 || minRoomCapacity < 1 || maxRoomCapacity < minRoomCapacity)
+        throw runtime_error("there must be at least one room, and 0 < minRoomCapacity <= maxRoomCapacity");
+    if (numProgrammes < 0 || programmeAffinity < 0 || programmeAffinity > 1 || popularitySigma < 0)
+        throw runtime_error("programmes must be >= 0, affinity in [0, 1] and popularitySigma >= 0");
+    if (periodPenaltyRate < 0 || periodPenaltyRate > 1 || roomPenaltyRate < 0 || roomPenaltyRate > 1 ||
+            periodPenalty < 0 || roomPenalty < 0)
+        throw runtime_error("penalty rates must be in [0, 1] and penalties >= 0");
+    if (afterDensity < 0 || coincidenceDensity < 0 || exclusionDensity < 0 || roomExclusiveDensity < 0 ||
+            roomExclusiveDensity > 1)
+        throw runtime_error("hard constraint densities must be >= 0 (and roomExclusive <= 1)");
+    if (twoInARow < 0 || twoInADay < 0 || periodSpread < 0 || nonMixedDurations < 0 ||
+            frontLoad[0] < 0 || frontLoad[1] < 0 || frontLoad[2] < 0)
+        throw runtime_error("institutional weightings must be >= 0");
+}
+
+
+
+ITC2007Generator::AliasTable::AliasTable(vector<double> const &_weights)
+    : probability(_weights.size()), alias(_weights.size(), 0) {
+    int n = _weights.size();
+    double sum = 0;
+    for (double weight : _weights)
+        sum += weight;
+    vector<int> small, large;
+    for (int i = 0; i < n; ++i) {
+        probability[i] = (sum > 0) ? _weights[i] * n / sum : 1.0;
+        (probability[i] < 1.0 ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+        int s = small.back(), l = large.back();
+        small.pop_back();
+        alias[s] = l;
+        probability[l] -= 1.0 - probability[s];
+        if (probability[l] < 1.0) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+    // Rounding leftovers
+    for (int i : small)
+        probability[i] = 1.0;
+    for (int i : large)
+        probability[i] = 1.0;
+}
+
+
+int ITC2007Generator::AliasTable::sample(eoRng &_gen) const {
+    int i = _gen.random(probability.size());
+    return (_gen.uniform() < probability[i]) ? i : alias[i];
+}
+
+
+
+ITC2007Generator::ITC2007Generator(Parameters const &_parameters)
+    : parameters(_parameters), gen(_parameters.seed), statistics() {
+    parameters.validate();
+}
+
+
+void ITC2007Generator::generate() {
+    gen.reseed(parameters.seed);
+    generateEnrolments();
+    computeConflicts();
+    generatePeriodsAndRooms();
+    generateHardConstraints();
+    computeStatistics();
+}
+
+
+void ITC2007Generator::generateEnrolments() {
+    int numExams = parameters.numExams, numStudents = parameters.numStudents;
+    int numProgrammes = (parameters.numProgrammes > 0) ? parameters.numProgrammes : max(1, numExams / 25);
+    numProgrammes = min(numProgrammes, numExams);
+    int maxExamsPerStudent = min(parameters.maxExamsPerStudent, numExams);
+
+    // Exam popularity and duration. Exam e belongs to programme e % numProgrammes.
+    vector<double> popularity(numExams);
+    examDurations.resize(numExams);
+    vector<vector<int> > programmeExams(numProgrammes);
+    vector<vector<double> > programmePopularity(numProgrammes);
+    vector<double> programmeWeights(numProgrammes, 0.0);
+    for (int e = 0; e < numExams; ++e) {
+        popularity[e] = exp(parameters.popularitySigma * gen.normal());
+        examDurations[e] = parameters.durations[gen.random(parameters.durations.size())];
+        int p = e % numProgrammes;
+        programmeExams[p].push_back(e);
+        programmePopularity[p].push_back(popularity[e]);
+        programmeWeights[p] += popularity[e];
+    }
+    AliasTable examTable(popularity), programmeTable(programmeWeights);
+    vector<AliasTable> programmeTables;
+    programmeTables.reserve(numProgrammes);
+    for (int p = 0; p < numProgrammes; ++p)
+        programmeTables.push_back(AliasTable(programmePopularity[p]));
+
+    // Exams of each student: mostly from the student's programme
+    examStudents.assign(numExams, vector<int>());
+    vector<int> studentNumExams(numStudents);
+    vector<int> chosen;
+    for (int s = 0; s < numStudents; ++s) {
+        int p = programmeTable.sample(gen);
+        int numChosen = min(1 + poisson(gen, parameters.meanExamsPerStudent - 1), maxExamsPerStudent);
+        chosen.clear();
+        // The programme may have fewer exams than the student takes: after a while,
+        // draw from all the exams
+        int numAttempts = 0;
+        while ((int)chosen.size() < numChosen) {
+            bool inProgramme = numAttempts++ < 20 * numChosen && gen.flip(parameters.programmeAffinity);
+            int e = inProgramme ? programmeExams[p][programmeTables[p].sample(gen)] : examTable.sample(gen);
+            if (find(chosen.begin(), chosen.end(), e) == chosen.end())
+                chosen.push_back(e);
+        }
+        for (int e : chosen)
+            examStudents[e].push_back(s);
+        studentNumExams[s] = numChosen;
+    }
+    // Every exam has at least one student
+    for (int e = 0; e < numExams; ++e) {
+        if (!examStudents[e].empty())
+            continue;
+        int s = gen.random(numStudents);
+        for (int i = 0; i < numStudents && studentNumExams[s] >= maxExamsPerStudent; ++i)
+            s = (s + 1) % numStudents;
+        examStudents[e].push_back(s);
+        ++studentNumExams[s];
+    }
+}
+
+
+void ITC2007Generator::computeConflicts() {
+    int numExams = parameters.numExams, numStudents = parameters.numStudents;
+    // Exams of each student, in compressed form
+    vector<long> studentStart(numStudents+1, 0);
+    for (auto const &students : examStudents) {
+        for (int s : students)
+            ++studentStart[s+1];
+    }
+    for (int s = 0; s < numStudents; ++s)
+        studentStart[s+1] += studentStart[s];
+    vector<int> studentExams(studentStart[numStudents]);
+    vector<long> position(studentStart.begin(), studentStart.end()-1);
+    for (int e = 0; e < numExams; ++e) {
+        for (int s : examStudents[e])
+            studentExams[position[s]++] = e;
+    }
+    // Pairs of exams of each student
+    conflicts.clear();
+    for (int s = 0; s < numStudents; ++s) {
+        for (long i = studentStart[s]; i < studentStart[s+1]; ++i) {
+            for (long j = i+1; j < studentStart[s+1]; ++j) {
+                uint64_t e1 = min(studentExams[i], studentExams[j]), e2 = max(studentExams[i], studentExams[j]);
+                conflicts.push_back((e1 << 32) | e2);
+            }
+        }
+    }
+    sort(conflicts.begin(), conflicts.end());
+    conflicts.erase(unique(conflicts.begin(), conflicts.end()), conflicts.end());
+}
+
+
+bool ITC2007Generator::hasConflict(int _e1, int _e2) const {
+    uint64_t e1 = min(_e1, _e2), e2 = max(_e1, _e2);
+    return binary_search(conflicts.begin(), conflicts.end(), (e1 << 32) | e2);
+}
+
+
+void ITC2007Generator::generatePeriodsAndRooms() {
+    // Periods start at 9:00, one hour apart at least, or at 0:00 and back to back if the
+    // day is too short
+    int step = ((parameters.periodDuration + 60 + 29) / 30) * 30, start = 9 * 60;
+    if (start + (parameters.periodsPerDay-1) * step + parameters.periodDuration > 24 * 60) {
+        step = parameters.periodDuration;
+        start = 0;
+    }
+    periodTimes.clear();
+    periodPenalties.clear();
+    int day = 1, month = 5, year = 2005;
+    char buffer[64];
+    for (int d = 0; d < parameters.numDays; ++d, addDay(day, month, year)) {
+        for (int p = 0; p < parameters.periodsPerDay; ++p) {
+            int minutes = start + p * step;
+            snprintf(buffer, sizeof(buffer), "%02d:%02d:%04d, %02d:%02d:00", day, month, year, minutes / 60, minutes % 60);
+            periodTimes.push_back(buffer);
+            periodPenalties.push_back(gen.flip(parameters.periodPenaltyRate) ? parameters.periodPenalty : 0);
+        }
+    }
+
+    roomCapacities.clear();
+    roomPenalties.clear();
+    for (int r = 0; r < parameters.numRooms; ++r) {
+        roomCapacities.push_back(parameters.minRoomCapacity +
+                                 gen.random(parameters.maxRoomCapacity - parameters.minRoomCapacity + 1));
+        roomPenalties.push_back(gen.flip(parameters.roomPenaltyRate) ? parameters.roomPenalty : 0);
+    }
+    // The largest exam fits in the largest room
+    int maxExamSize = 0;
+    for (auto const &students : examStudents)
+        maxExamSize = max(maxExamSize, (int)students.size());
+    auto largestRoom = max_element(roomCapacities.begin(), roomCapacities.end());
+    *largestRoom = max(*largestRoom, maxExamSize);
+}
+
+
+void ITC2007Generator::generateHardConstraints() {
+    int numExams = parameters.numExams;
+    periodHardConstraints.clear();
+    roomHardConstraints.clear();
+    if (numExams < 2)
+        return;
+    // Constrained pairs, so a pair has at most one constraint
+    unordered_set<uint64_t> pairs;
+    auto isNewPair = [&](int _e1, int _e2) {
+        uint64_t e1 = min(_e1, _e2), e2 = max(_e1, _e2), key = (e1 << 32) | e2;
+        return _e1 != _e2 && pairs.insert(key).second;
+    };
+    // Exams in AFTER or EXAM_COINCIDENCE constraints
+    vector<char> constrained(numExams, 0);
+    const int maxAttempts = 100;
+
+    // e1 AFTER e2 with e1 > e2: no cycles
+    int numAfter = (int)lround(parameters.afterDensity * numExams);
+    for (int i = 0, attempts = 0; i < numAfter && attempts < maxAttempts * numAfter; ++attempts) {
+        int e1 = gen.random(numExams), e2 = gen.random(numExams);
+        if (!isNewPair(e1, e2))
+            continue;
+        periodHardConstraints.push_back(to_string(max(e1, e2)) + ", AFTER, " + to_string(min(e1, e2)));
+        constrained[e1] = constrained[e2] = 1;
+        ++i;
+    }
+    // EXAM_COINCIDENCE between exams without students in common, outside of any other
+    // AFTER or EXAM_COINCIDENCE constraint, so the constraints are consistent
+    int numCoincidences = (int)lround(parameters.coincidenceDensity * numExams);
+    for (int i = 0, attempts = 0; i < numCoincidences && attempts < maxAttempts * numCoincidences; ++attempts) {
+        int e1 = gen.random(numExams), e2 = gen.random(numExams);
+        if (constrained[e1] || constrained[e2] || hasConflict(e1, e2) || !isNewPair(e1, e2))
+            continue;
+        periodHardConstraints.push_back(to_string(e1) + ", EXAM_COINCIDENCE, " + to_string(e2));
+        constrained[e1] = constrained[e2] = 1;
+        ++i;
+    }
+    int numExclusions = (int)lround(parameters.exclusionDensity * numExams);
+    for (int i = 0, attempts = 0; i < numExclusions && attempts < maxAttempts * numExclusions; ++attempts) {
+        int e1 = gen.random(numExams), e2 = gen.random(numExams);
+        if (!isNewPair(e1, e2))
+            continue;
+        periodHardConstraints.push_back(to_string(e1) + ", EXCLUSION, " + to_string(e2));
+        ++i;
+    }
+    // ROOM_EXCLUSIVE exams
+    int numRoomExclusive = (int)lround(parameters.roomExclusiveDensity * numExams);
+    vector<char> roomExclusive(numExams, 0);
+    for (int i = 0; i < numRoomExclusive; ) {
+        int e = gen.random(numExams);
+        if (roomExclusive[e])
+            continue;
+        roomExclusive[e] = 1;
+        roomHardConstraints.push_back(to_string(e) + ", ROOM_EXCLUSIVE");
+        ++i;
+    }
+}
+
+
+void ITC2007Generator::computeStatistics() {
+    Statistics &s = statistics;
+    s = Statistics();
+    s.numExams = parameters.numExams;
+    s.numStudents = parameters.numStudents;
+    s.numPeriods = periodTimes.size();
+    s.numRooms = roomCapacities.size();
+    vector<int> examSizes, studentNumExams(parameters.numStudents, 0);
+    for (auto const &students : examStudents) {
+        examSizes.push_back(students.size());
+        s.numEnrolments += students.size();
+        for (int student : students)
+            ++studentNumExams[student];
+    }
+    s.meanExamsPerStudent = (double)s.numEnrolments / s.numStudents;
+    s.maxExamsPerStudent = *max_element(studentNumExams.begin(), studentNumExams.end());
+    sort(examSizes.begin(), examSizes.end());
+    s.meanExamSize = (double)s.numEnrolments / s.numExams;
+    s.medianExamSize = examSizes[examSizes.size() / 2];
+    s.maxExamSize = examSizes.back();
+    vector<int> degrees(parameters.numExams, 0);
+    for (uint64_t pair : conflicts) {
+        ++degrees[pair >> 32];
+        ++degrees[pair & 0xffffffff];
+    }
+    s.numConflicts = conflicts.size();
+    s.conflictDensity = 2.0 * s.numConflicts / ((double)s.numExams * s.numExams);
+    s.meanDegree = 2.0 * s.numConflicts / s.numExams;
+    s.maxDegree = *max_element(degrees.begin(), degrees.end());
+    for (int capacity : roomCapacities)
+        s.totalSeats += capacity;
+    s.meanSeatsPerPeriod = (double)s.numEnrolments / s.numPeriods;
+    s.numPeriodHardConstraints = periodHardConstraints.size();
+    s.numRoomHardConstraints = roomHardConstraints.size();
+}
+
+
+void ITC2007Generator::printStatistics(ostream &_os) const {
+    Statistics const &s = statistics;
+    _os << "Exams: " << s.numExams << ", students: " << s.numStudents << ", enrolments: " << s.numEnrolments
+        << ", periods: " << s.numPeriods << ", rooms: " << s.numRooms << endl
+        << "Exams per student: mean " << s.meanExamsPerStudent << ", max " << s.maxExamsPerStudent << endl
+        << "Students per exam: mean " << s.meanExamSize << ", median " << s.medianExamSize
+        << ", max " << s.maxExamSize << endl
+        << "Conflicts: " << s.numConflicts << " pairs, density " << 100 * s.conflictDensity << "%, degree mean "
+        << s.meanDegree << ", max " << s.maxDegree << endl
+        << "Seats: " << s.totalSeats << " per period, " << s.meanSeatsPerPeriod << " needed on average" << endl
+        << "Hard constraints: " << s.numPeriodHardConstraints << " period related, " << s.numRoomHardConstraints
+        << " room related" << endl;
+    if (s.meanSeatsPerPeriod > s.totalSeats)
+        _os << "Warning: more seats are needed per period than available; the instance is infeasible" << endl;
+}
+
+
+void ITC2007Generator::write(ostream &_os) const {
+    _os << "[Exams:" << parameters.numExams << "]" << EOL;
+    for (int e = 0; e < parameters.numExams; ++e) {
+        _os << examDurations[e];
+        for (int s : examStudents[e])
+            _os << ", " << s;
+        _os << EOL;
+    }
+    _os << "[Periods:" << periodTimes.size() << "]" << EOL;
+    for (size_t p = 0; p < periodTimes.size(); ++p)
+        _os << periodTimes[p] << ", " << parameters.periodDuration << ", " << periodPenalties[p] << EOL;
+    _os << "[Rooms:" << roomCapacities.size() << "]" << EOL;
+    for (size_t r = 0; r < roomCapacities.size(); ++r)
+        _os << roomCapacities[r] << ", " << roomPenalties[r] << EOL;
+    _os << "[PeriodHardConstraints]" << EOL;
+    for (auto const &constraint : periodHardConstraints)
+        _os << constraint << EOL;
+    _os << "[RoomHardConstraints]" << EOL;
+    for (auto const &constraint : roomHardConstraints)
+        _os << constraint << EOL;
+    _os << "[InstitutionalWeightings]" << EOL
+        << "TWOINAROW, " << parameters.twoInARow << EOL
+        << "TWOINADAY, " << parameters.twoInADay << EOL
+        << "PERIODSPREAD, " << parameters.periodSpread << EOL
+        << "NONMIXEDDURATIONS, " << parameters.nonMixedDurations << EOL
+        << "FRONTLOAD, " << parameters.frontLoad[0] << ", " << parameters.frontLoad[1] << ", "
+        << parameters.frontLoad[2] << EOL;
+}
+
+
+void ITC2007Generator::write(string const &_filename) const {
+    ofstream file(_filename, ios::binary);
+    if (!file)
+        throw runtime_error("Couldn't create file: " + _filename);
+    write(file);
+    if (!file)
+        throw runtime_error("Couldn't write file: " + _filename);
+}
@@ -0,0 +1,242 @@
+#ifndef ITC2007GENERATOR_H
+#define ITC2007GENERATOR_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cstdint>
+#include <utils/eoRNG.h>
+
+
+/**
+ * @brief The ITC2007Generator class. Generator of synthetic ITC2007 examination track
+ * instances (.exam files), for scaling tests beyond the sizes of the competition sets.
+ *
+ * Enrolments follow the structure of the real instances: students belong to programmes
+ * (groups of exams) and take most of their exams within their programme, so the conflict
+ * graph is sparse and clustered; the popularity of the exams is log-normal, giving the
+ * heavy-tailed exam sizes of the competition sets (many small exams, a few very large
+ * ones); the # exams per student is 1 + Poisson. With the default parameters and the sizes
+ * of the competition sets, the conflict density and the degree and size distributions are
+ * in the range of sets 1 to 8. Generation is linear in the # enrolments, so 50k exams and
+ * 500k students take seconds.
+ *
+ * The generated instance is valid (it parses, every exam has students and fits in the
+ * largest room, AFTER constraints are acyclic and EXAM_COINCIDENCE constraints only relate
+ * exams without students in common) but isn't guaranteed to be feasible: getStatistics()
+ * helps choosing enough periods and seats.
+ */
+class ITC2007Generator {
+
+public:
+    /**
+     * @brief The Parameters struct. Generator parameters
+     */
+    struct Parameters {
+        // Random generator seed
+        uint32_t seed;
+        //
+        // Exams and enrolments
+        //
+        int numExams;
+        int numStudents;
+        // Mean and maximum # exams per student
+        double meanExamsPerStudent;
+        int maxExamsPerStudent;
+        // # programmes; 0 chooses one per 25 exams
+        int numProgrammes;
+        // Probability that an enrolment is in the programme of the student
+        double programmeAffinity;
+        // Standard deviation of the log of the exam popularity
+        double popularitySigma;
+        // Exam durations, drawn uniformly; must not exceed the period duration
+        std::vector<int> durations;
+        //
+        // Periods
+        //
+        int numDays;
+        int periodsPerDay;
+        int periodDuration;
+        // Fraction of periods with a penalty, and the penalty
+        double periodPenaltyRate;
+        int periodPenalty;
+        //
+        // Rooms
+        //
+        int numRooms;
+        int minRoomCapacity;
+        int maxRoomCapacity;
+        // Fraction of rooms with a penalty, and the penalty
+        double roomPenaltyRate;
+        int roomPenalty;
+        //
+        // Hard constraints, per exam
+        //
+        double afterDensity;
+        double coincidenceDensity;
+        double exclusionDensity;
+        double roomExclusiveDensity;
+        //
+        // Institutional weightings
+        //
+        int twoInARow;
+        int twoInADay;
+        int periodSpread;
+        int nonMixedDurations;
+        // FRONTLOAD: # largest exams, # last periods, penalty
+        int frontLoad[3];
+
+        /**
+         * @brief Parameters Defaults: an instance of the size of set 1
+         */
+        Parameters();
+
+        /**
+         * @brief set Set parameter _name from its text value, e.g. set("exams", "50000").
+         * Throws std::runtime_error if the parameter is unknown or the value malformed.
+         * @param _name
+         * @param _value
+         */
+        void set(std::string const &_name, std::string const &_value);
+
+        /**
+         * @brief print Print the parameters, one "name=value" per line
+         * @param _os
+         */
+        void print(std::ostream &_os) const;
+
+        /**
+         * @brief validate Throws std::runtime_error if the parameters are inconsistent
+         */
+        void validate() const;
+    };
+
+    /**
+     * @brief The Statistics struct. Statistics of a generated instance, comparable to
+     * those published for the competition sets
+     */
+    struct Statistics {
+        int numExams;
+        int numStudents;
+        long numEnrolments;
+        int numPeriods;
+        int numRooms;
+        // Exams per student
+        double meanExamsPerStudent;
+        int maxExamsPerStudent;
+        // Students per exam
+        double meanExamSize;
+        int medianExamSize;
+        int maxExamSize;
+        // Conflict graph: # pairs of exams with students in common, density
+        // (2 * # pairs / # exams^2), mean and maximum degree
+        long numConflicts;
+        double conflictDensity;
+        double meanDegree;
+        int maxDegree;
+        // Seats of all the rooms, and mean # seats needed per period
+        long totalSeats;
+        double meanSeatsPerPeriod;
+        // Hard constraints
+        int numPeriodHardConstraints;
+        int numRoomHardConstraints;
+    };
+
+    /**
+     * @brief ITC2007Generator Validate the parameters
+     * @param _parameters
+     */
+    explicit ITC2007Generator(Parameters const &_parameters);
+
+    /**
+     * @brief generate Generate the instance
+     */
+    void generate();
+
+    /**
+     * @brief write Write the generated instance in the ITC2007 format
+     * @param _os
+     */
+    void write(std::ostream &_os) const;
+    /**
+     * @brief write Write the generated instance to file _filename.
+     * Throws std::runtime_error if the file can't be written.
+     * @param _filename
+     */
+    void write(std::string const &_filename) const;
+
+    /**
+     * @brief getStatistics
+     * @return Statistics of the generated instance
+     */
+    Statistics const &getStatistics() const { return statistics; }
+    /**
+     * @brief printStatistics
+     * @param _os
+     */
+    void printStatistics(std::ostream &_os) const;
+
+protected:
+    /**
+     * @brief The AliasTable class. Walker's alias method: draws index i with probability
+     * proportional to weight i in constant time
+     */
+    class AliasTable {
+    public:
+        AliasTable() { }
+        explicit AliasTable(std::vector<double> const &_weights);
+        int sample(eoRng &_gen) const;
+    private:
+        std::vector<double> probability;
+        std::vector<int> alias;
+    };
+
+    /**
+     * @brief generateEnrolments Draw the exams of every student
+     */
+    void generateEnrolments();
+    /**
+     * @brief computeConflicts Compute the pairs of exams with students in common
+     */
+    void computeConflicts();
+    /**
+     * @brief generatePeriodsAndRooms
+     */
+    void generatePeriodsAndRooms();
+    /**
+     * @brief generateHardConstraints
+     */
+    void generateHardConstraints();
+    /**
+     * @brief computeStatistics
+     */
+    void computeStatistics();
+    /**
+     * @brief hasConflict
+     * @param _e1
+     * @param _e2
+     * @return true if exams _e1 and _e2 have students in common
+     */
+    bool hasConflict(int _e1, int _e2) const;
+
+    Parameters parameters;
+    eoRng gen;
+    // Students of each exam
+    std::vector<std::vector<int> > examStudents;
+    std::vector<int> examDurations;
+    // Pairs of exams with students in common, as (e1 << 32 | e2) with e1 < e2, sorted
+    std::vector<uint64_t> conflicts;
+    // Period dates ("dd:mm:yyyy, hh:mm:ss"), durations and penalties
+    std::vector<std::string> periodTimes;
+    std::vector<int> periodPenalties;
+    // Room capacities and penalties
+    std::vector<int> roomCapacities;
+    std::vector<int> roomPenalties;
+    // Hard constraints, as written to the file
+    std::vector<std::string> periodHardConstraints;
+    std::vector<std::string> roomHardConstraints;
+    Statistics statistics;
+};
+
+
+#endif // ITC2007GENERATOR_H
@@ -0,0 +1,398 @@
+#ifndef ITC2007INSTANCECACHE_H
+#define ITC2007INSTANCECACHE_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <unistd.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include "data/TimetableProblemData.hpp"
+#include "data/ITC2007Constraints.hpp"
+#include "utils/MappedFile.h"
+
+
+/**
+ * @brief The ITC2007InstanceCache class. Binary cache of a preprocessed ITC2007 instance.
+ *
+ * The cache file holds everything ITC2007TestSet::load derives from the .exam
+ * file: exam, period and room arrays, sorted class sizes, hard constraints,
+ * institutional weightings, the conflict matrix in compressed sparse row form
+ * and its density. It is keyed by a hash of the source file, so an edited
+ * instance is preprocessed again. Reading maps the file and rebuilds the
+ * TimetableProblemData, including its sparse conflict matrix, without the
+ * student map and the O(E^2) scans.
+ *
+ * Layout: Header, then int32 arrays in this order
+ *  exams               numExams x {duration, numStudents}
+ *  sortedClassSizes    numExams x {exam, numStudents}
+ *  periods             numPeriods x {day, month, year, hour, minutes, seconds, duration, penalty}
+ *  rooms               numRooms x {capacity, penalty}
+ *  hardConstraints     numHardConstraints x {type, e1, e2}
+ *  conflictRowStart    numExams+1
+ *  conflictCols        numConflicts
+ *  conflictVals        numConflicts
+ * Integers are in native byte order; the cache is not meant to be moved across machines.
+ */
+class ITC2007InstanceCache {
+
+public:
+    /**
+     * @brief hash FNV-1a hash of the source file contents
+     * @param _begin
+     * @param _size
+     * @return
+     */
+    inline static uint64_t hash(char const *_begin, std::size_t _size);
+
+    /**
+     * @brief getCacheFilename
+     * @param _instanceFilename
+     * @return Cache file name of instance _instanceFilename
+     */
+    inline static std::string getCacheFilename(std::string const &_instanceFilename);
+
+    /**
+     * @brief read Rebuild _data from cache file _cacheFilename
+     * @param _cacheFilename
+     * @param _sourceHash Hash of the source file
+     * @param _sourceSize Size of the source file
+     * @param _data Empty timetable problem data
+     * @return false, leaving _data untouched, if the cache is missing, stale or corrupt
+     */
+    inline static bool read(std::string const &_cacheFilename, uint64_t _sourceHash, uint64_t _sourceSize,
+                            TimetableProblemData &_data);
+
+    /**
+     * @brief write Write _data to cache file _cacheFilename. The file is written
+     * under a temporary name and then renamed, so concurrent runs never read a
+     * partial cache.
+     * @param _cacheFilename
+     * @param _sourceHash Hash of the source file
+     * @param _sourceSize Size of the source file
+     * @param _data
+     * @return false if the cache couldn't be written
+     */
+    inline static bool write(std::string const &_cacheFilename, uint64_t _sourceHash, uint64_t _sourceSize,
+                             TimetableProblemData const &_data);
+
+protected:
+    // Cache format version. Increment whenever the layout changes.
+    static const uint32_t VERSION = 1;
+
+    // Hard constraint types
+    enum ConstraintType { AFTER = 0, EXAM_COINCIDENCE = 1, EXCLUSION = 2, ROOM_EXCLUSIVE = 3 };
+
+    /**
+     * @brief The Header struct
+     */
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        uint64_t sourceHash;
+        uint64_t sourceSize;
+        int32_t numExams;
+        int32_t numPeriods;
+        int32_t numRooms;
+        int32_t numStudents;
+        int32_t numEnrolments;
+        int32_t numHardConstraints;
+        int32_t numConflicts;
+        // two_in_a_row, two_in_a_day, period_spread, non_mixed_durations, front_load size, front_load[0..2]
+        int32_t weightings[8];
+        int32_t padding;
+        double conflictMatrixDensity;
+    };
+
+    /**
+     * @brief getPayloadSize
+     * @param _header
+     * @return # int32 values following the header
+     */
+    inline static uint64_t getPayloadSize(Header const &_header);
+
+    /**
+     * @brief writeInts Append _values to _os
+     * @param _os
+     * @param _values
+     */
+    inline static void writeInts(std::ostream &_os, std::vector<int32_t> const &_values);
+};
+
+
+
+uint64_t ITC2007InstanceCache::hash(char const *_begin, std::size_t _size) {
+    uint64_t h = 14695981039346656037ULL;
+    for (std::size_t i = 0; i < _size; ++i) {
+        h ^= static_cast<unsigned char>(_begin[i]);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+
+std::string ITC2007InstanceCache::getCacheFilename(std::string const &_instanceFilename) {
+    return _instanceFilename + ".cache";
+}
+
+
+uint64_t ITC2007InstanceCache::getPayloadSize(Header const &_header) {
+    return 2*(uint64_t)_header.numExams + 2*(uint64_t)_header.numExams + 8*(uint64_t)_header.numPeriods
+            + 2*(uint64_t)_header.numRooms + 3*(uint64_t)_header.numHardConstraints
+            + ((uint64_t)_header.numExams+1) + 2*(uint64_t)_header.numConflicts;
+}
+
+
+bool ITC2007InstanceCache::read(std::string const &_cacheFilename, uint64_t _sourceHash, uint64_t _sourceSize,
+                                TimetableProblemData &_data) {
+    if (access(_cacheFilename.c_str(), R_OK) != 0)
+        return false;
+    MappedFile file(_cacheFilename);
+    if (file.size() < sizeof(Header))
+        return false;
+    Header header;
+    std::memcpy(&header, file.begin(), sizeof(Header));
+    if (std::memcmp(header.magic, "FTAETPC", 8) != 0 || header.version != VERSION
+            || header.headerSize != sizeof(Header) || header.sourceHash != _sourceHash
+            || header.sourceSize != _sourceSize)
+        return false;
+    if (header.numExams < 0 || header.numPeriods < 0 || header.numRooms < 0
+            || header.numHardConstraints < 0 || header.numConflicts < 0
+            || file.size() != sizeof(Header) + getPayloadSize(header)*sizeof(int32_t))
+        return false;
+
+    int numExams = header.numExams;
+    // The mapping is page aligned and the header size is a multiple of 8
+    int32_t const *p = reinterpret_cast<int32_t const *>(file.begin() + sizeof(Header));
+
+    // Exams and course class sizes
+    boost::shared_ptr<std::vector<boost::shared_ptr<Exam> > > examVector(new std::vector<boost::shared_ptr<Exam> >());
+    boost::shared_ptr<std::vector<int> > courseClassSize(new std::vector<int>(numExams));
+    examVector->reserve(numExams);
+    for (int i = 0; i < numExams; ++i, p += 2) {
+        examVector->push_back(boost::make_shared<Exam>(i, p[1], p[0]));
+        (*courseClassSize)[i] = p[1];
+    }
+    boost::shared_ptr<std::vector<std::pair<int,int> > > sortedCourseClassSize(
+                new std::vector<std::pair<int,int> >(numExams));
+    for (int i = 0; i < numExams; ++i, p += 2)
+        (*sortedCourseClassSize)[i] = std::make_pair(p[0], p[1]);
+
+    // Periods
+    boost::shared_ptr<std::vector<boost::shared_ptr<ITC2007Period> > > periodVector(
+                new std::vector<boost::shared_ptr<ITC2007Period> >());
+    periodVector->reserve(header.numPeriods);
+    for (int i = 0; i < header.numPeriods; ++i, p += 8)
+        periodVector->push_back(boost::make_shared<ITC2007Period>(i, Date(p[0], p[1], p[2]),
+                                                                  Time(p[3], p[4], p[5]), p[6], p[7]));
+
+    // Rooms
+    boost::shared_ptr<std::vector<boost::shared_ptr<Room> > > roomVector(new std::vector<boost::shared_ptr<Room> >());
+    roomVector->reserve(header.numRooms);
+    for (int i = 0; i < header.numRooms; ++i, p += 2)
+        roomVector->push_back(boost::make_shared<Room>(i, p[0], p[1]));
+
+    // Hard constraints
+    std::vector<boost::shared_ptr<Constraint> > hardConstraints;
+    hardConstraints.reserve(header.numHardConstraints);
+    for (int i = 0; i < header.numHardConstraints; ++i, p += 3) {
+        int e1 = p[1], e2 = p[2];
+        if (e1 < 0 || e1 >= numExams || e2 < 0 || e2 >= numExams)
+            return false;
+        boost::shared_ptr<Constraint> hardConstr;
+        switch (p[0]) {
+        case AFTER:            hardConstr = boost::make_shared<AfterConstraint>(e1, e2);           break;
+        case EXAM_COINCIDENCE: hardConstr = boost::make_shared<ExamCoincidenceConstraint>(e1, e2); break;
+        case EXCLUSION:        hardConstr = boost::make_shared<ExamExclusionConstraint>(e1, e2);   break;
+        case ROOM_EXCLUSIVE:   hardConstr = boost::make_shared<RoomExclusiveConstraint>(e1);       break;
+        default: return false;
+        }
+        hardConstraints.push_back(hardConstr);
+        if (p[0] == ROOM_EXCLUSIVE)
+            (*examVector)[e1]->insertRoomRelatedHardConstraint(hardConstr);
+        else {
+            (*examVector)[e1]->insertPeriodRelatedHardConstraint(hardConstr);
+            (*examVector)[e2]->insertPeriodRelatedHardConstraint(hardConstr);
+        }
+    }
+
+    // Conflict matrix and exam graph. Edges are added in the same order as in
+    // ITC2007TestSet::buildExamGraph, so the graph is identical.
+    int32_t const *rowStart = p;
+    int32_t const *cols = rowStart + numExams + 1;
+    int32_t const *vals = cols + header.numConflicts;
+    if (rowStart[0] != 0 || rowStart[numExams] != header.numConflicts)
+        return false;
+    boost::shared_ptr<IntMatrix> conflictMatrix(new IntMatrix(numExams, numExams));
+    boost::shared_ptr<AdjacencyList> examGraph(new AdjacencyList(numExams));
+    for (int v1 = 0; v1 < numExams; ++v1) {
+        if (rowStart[v1] > rowStart[v1+1])
+            return false;
+        for (int k = rowStart[v1]; k < rowStart[v1+1]; ++k) {
+            int v2 = cols[k];
+            if (v2 < 0 || v2 >= numExams)
+                return false;
+            conflictMatrix->setVal(v1, v2, vals[k]);
+            if (v2 > v1)
+                add_edge(v1, v2, *examGraph);
+        }
+    }
+    boost::shared_ptr<SparseIntMatrix> sparseConflictMatrix(new SparseIntMatrix(
+                numExams, std::vector<int>(rowStart, rowStart+numExams+1),
+                std::vector<int>(cols, cols+header.numConflicts), std::vector<int>(vals, vals+header.numConflicts)));
+
+    InstitutionalModelWeightings model_weightings;
+    model_weightings.two_in_a_row = header.weightings[0];
+    model_weightings.two_in_a_day = header.weightings[1];
+    model_weightings.period_spread = header.weightings[2];
+    model_weightings.non_mixed_durations = header.weightings[3];
+    if (header.weightings[4] < 0 || header.weightings[4] > 3)
+        return false;
+    model_weightings.front_load.assign(header.weightings+5, header.weightings+5+header.weightings[4]);
+
+    // Set TimetableProblemData fields
+    _data.setNumExams(numExams);
+    _data.setNumPeriods(header.numPeriods);
+    _data.setNumRooms(header.numRooms);
+    _data.setNumStudents(header.numStudents);
+    _data.setNumEnrolments(header.numEnrolments);
+    _data.setExamVector(examVector);
+    _data.setCourseClassSize(courseClassSize);
+    _data.setSortedCourseClassSize(sortedCourseClassSize);
+    _data.setPeriodVector(periodVector);
+    _data.setRoomVector(roomVector);
+    _data.setHardConstraints(hardConstraints);
+    _data.setConflictMatrix(conflictMatrix, header.conflictMatrixDensity);
+    _data.setSparseConflictMatrix(sparseConflictMatrix);
+    _data.setCompactExamGraph(boost::make_shared<CompactGraph>(*sparseConflictMatrix));
+    _data.setExamGraph(examGraph);
+    _data.setInstitutionalModelWeightings(model_weightings);
+    return true;
+}
+
+
+bool ITC2007InstanceCache::write(std::string const &_cacheFilename, uint64_t _sourceHash, uint64_t _sourceSize,
+                                 TimetableProblemData const &_data) {
+    int numExams = _data.getNumExams();
+    Header header;
+    std::memset(&header, 0, sizeof(Header));
+    std::memcpy(header.magic, "FTAETPC", 8);
+    header.version = VERSION;
+    header.headerSize = sizeof(Header);
+    header.sourceHash = _sourceHash;
+    header.sourceSize = _sourceSize;
+    header.numExams = numExams;
+    header.numPeriods = _data.getNumPeriods();
+    header.numRooms = _data.getNumRooms();
+    header.numStudents = _data.getNumStudents();
+    header.numEnrolments = _data.getNumEnrolments();
+    header.conflictMatrixDensity = _data.getConflictMatrixDensity();
+
+    InstitutionalModelWeightings const &model_weightings = _data.getInstitutionalModelWeightings();
+    header.weightings[0] = model_weightings.two_in_a_row;
+    header.weightings[1] = model_weightings.two_in_a_day;
+    header.weightings[2] = model_weightings.period_spread;
+    header.weightings[3] = model_weightings.non_mixed_durations;
+    header.weightings[4] = std::min<int>(model_weightings.front_load.size(), 3);
+    for (int i = 0; i < header.weightings[4]; ++i)
+        header.weightings[5+i] = model_weightings.front_load[i];
+
+    std::vector<int32_t> exams, sortedClassSizes, periods, rooms, hardConstraints;
+    for (auto const &exam : _data.getExamVector()) {
+        exams.push_back(exam->getDuration());
+        exams.push_back(exam->getNumStudents());
+    }
+    for (auto const &p : _data.getSortedCourseClassSize()) {
+        sortedClassSizes.push_back(p.first);
+        sortedClassSizes.push_back(p.second);
+    }
+    for (auto const &period : _data.getPeriodVector()) {
+        int32_t values[] = { period->getDate().getDay(), period->getDate().getMonth(), period->getDate().getYear(),
+                             period->getTime().getHour(), period->getTime().getMinutes(), period->getTime().getSeconds(),
+                             period->getDuration(), period->getPenalty() };
+        periods.insert(periods.end(), values, values+8);
+    }
+    for (auto const &room : _data.getRoomVector()) {
+        rooms.push_back(room->getCapacity());
+        rooms.push_back(room->getPenalty());
+    }
+    for (auto const &constraint : _data.getHardConstraints()) {
+        Constraint const *c = constraint.get();
+        if (auto after = dynamic_cast<AfterConstraint const *>(c))
+            hardConstraints.insert(hardConstraints.end(), { AFTER, after->getE1(), after->getE2() });
+        else if (auto coincidence = dynamic_cast<ExamCoincidenceConstraint const *>(c))
+            hardConstraints.insert(hardConstraints.end(), { EXAM_COINCIDENCE, coincidence->getE1(), coincidence->getE2() });
+        else if (auto exclusion = dynamic_cast<ExamExclusionConstraint const *>(c))
+            hardConstraints.insert(hardConstraints.end(), { EXCLUSION, exclusion->getE1(), exclusion->getE2() });
+        else if (auto exclusive = dynamic_cast<RoomExclusiveConstraint const *>(c))
+            hardConstraints.insert(hardConstraints.end(), { ROOM_EXCLUSIVE, exclusive->getE(), exclusive->getE() });
+        else
+            return false;
+    }
+    header.numHardConstraints = hardConstraints.size() / 3;
+
+    // Conflict matrix in compressed sparse row form
+    std::vector<int32_t> rowStart(numExams+1, 0), cols, vals;
+    if (_data.getSparseConflictMatrix()) {
+        SparseIntMatrix const &sparseConflictMatrix = *_data.getSparseConflictMatrix();
+        rowStart.assign(sparseConflictMatrix.getRowStart().begin(), sparseConflictMatrix.getRowStart().end());
+        cols.assign(sparseConflictMatrix.getCols().begin(), sparseConflictMatrix.getCols().end());
+        vals.assign(sparseConflictMatrix.getVals().begin(), sparseConflictMatrix.getVals().end());
+    }
+    else {
+        IntMatrix const &conflictMatrix = _data.getConflictMatrix();
+        for (int i = 0; i < numExams; ++i) {
+            for (int j = 0; j < numExams; ++j) {
+                if (conflictMatrix.getVal(i, j) != 0) {
+                    cols.push_back(j);
+                    vals.push_back(conflictMatrix.getVal(i, j));
+                }
+            }
+            rowStart[i+1] = cols.size();
+        }
+    }
+    header.numConflicts = cols.size();
+
+    std::string tmpFilename = _cacheFilename + ".tmp." + std::to_string(getpid());
+    {
+        std::ofstream os(tmpFilename.c_str(), std::ios::binary | std::ios::trunc);
+        if (!os.is_open()) {
+            std::cerr << "Couldn't write instance cache: " << _cacheFilename << std::endl;
+            return false;
+        }
+        os.write(reinterpret_cast<char const *>(&header), sizeof(Header));
+        writeInts(os, exams);
+        writeInts(os, sortedClassSizes);
+        writeInts(os, periods);
+        writeInts(os, rooms);
+        writeInts(os, hardConstraints);
+        writeInts(os, rowStart);
+        writeInts(os, cols);
+        writeInts(os, vals);
+        if (!os) {
+            std::remove(tmpFilename.c_str());
+            std::cerr << "Couldn't write instance cache: " << _cacheFilename << std::endl;
+            return false;
+        }
+    }
+    if (std::rename(tmpFilename.c_str(), _cacheFilename.c_str()) != 0) {
+        std::remove(tmpFilename.c_str());
+        return false;
+    }
+    return true;
+}
+
+
+void ITC2007InstanceCache::writeInts(std::ostream &_os, std::vector<int32_t> const &_values) {
+    if (!_values.empty())
+        _os.write(reinterpret_cast<char const *>(_values.data()), _values.size()*sizeof(int32_t));
+}
+
+
+#endif // ITC2007INSTANCECACHE_H
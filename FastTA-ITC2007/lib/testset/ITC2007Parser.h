@@ -0,0 +1,249 @@
+#ifndef ITC2007PARSER_H
+#define ITC2007PARSER_H
+
+#include <string>
+#include <cstring>
+#include <stdexcept>
+
+
+/**
+ * @brief The ITC2007Parser class. Single-pass cursor over the bytes of an
+ * ITC2007 instance file (see ITC2007TestSet::load for the format).
+ *
+ * Lines end with "\r\n" or "\n". Fields are separated by commas, optionally
+ * followed by blanks. Integers are parsed in place, without copying the
+ * field or building intermediate strings. Parse errors throw
+ * std::runtime_error with the offending line number.
+ */
+class ITC2007Parser {
+
+public:
+    /**
+     * @brief ITC2007Parser Constructor
+     * @param _begin First byte
+     * @param _end Past the last byte
+     */
+    inline ITC2007Parser(char const *_begin, char const *_end);
+
+    /**
+     * @brief atEnd Skip empty lines
+     * @return true if the end of the input was reached
+     */
+    inline bool atEnd();
+
+    /**
+     * @brief atSectionHeader Skip empty lines
+     * @return true if the current line is a section header "[...]"
+     */
+    inline bool atSectionHeader();
+
+    /**
+     * @brief readSectionHeader Read line "[_name]"
+     * @param _name
+     * @return false, consuming nothing, if the current line is not "[_name]"
+     */
+    inline bool readSectionHeader(char const *_name);
+
+    /**
+     * @brief readSectionSize Read line "[_name:size]"
+     * @param _name
+     * @return size
+     */
+    inline int readSectionSize(char const *_name);
+
+    /**
+     * @brief readInt Read a (possibly signed) decimal integer, skipping leading blanks
+     * @return
+     */
+    inline int readInt();
+
+    /**
+     * @brief readWord Read an identifier made of upper case letters and '_'
+     * @return
+     */
+    inline std::string readWord();
+
+    /**
+     * @brief expect Read character _c, skipping leading blanks
+     * @param _c
+     */
+    inline void expect(char _c);
+
+    /**
+     * @brief tryRead Read character _c, skipping leading blanks, if present
+     * @param _c
+     * @return true if _c was read
+     */
+    inline bool tryRead(char _c);
+
+    /**
+     * @brief nextLine Check that the current line has no more fields and go to the next one
+     */
+    inline void nextLine();
+
+    /**
+     * @brief getLineNumber
+     * @return Current line number, starting at 1
+     */
+    inline int getLineNumber() const;
+
+    /**
+     * @brief error Throw a std::runtime_error for the current line
+     * @param _message
+     */
+    inline void error(std::string const &_message) const;
+
+protected:
+    /**
+     * @brief skipBlanks Skip spaces and tabs
+     */
+    inline void skipBlanks();
+
+    /**
+     * @brief skipEmptyLines Skip lines containing only blanks
+     */
+    inline void skipEmptyLines();
+
+    /**
+     * @brief atEndOfLine
+     * @return true at "\r", "\n" or at the end of the input
+     */
+    inline bool atEndOfLine() const;
+
+    // Current position
+    char const *pos;
+    // Past the last byte
+    char const *end;
+    // Current line number
+    int lineNumber;
+};
+
+
+
+ITC2007Parser::ITC2007Parser(char const *_begin, char const *_end)
+    : pos(_begin), end(_end), lineNumber(1) { }
+
+
+bool ITC2007Parser::atEnd() {
+    skipEmptyLines();
+    return pos == end;
+}
+
+
+bool ITC2007Parser::atSectionHeader() {
+    skipEmptyLines();
+    return pos != end && *pos == '[';
+}
+
+
+bool ITC2007Parser::readSectionHeader(char const *_name) {
+    skipEmptyLines();
+    std::size_t n = std::strlen(_name);
+    if (end - pos < (std::ptrdiff_t)n+2 || pos[0] != '[' || std::memcmp(pos+1, _name, n) != 0 || pos[n+1] != ']')
+        return false;
+    pos += n+2;
+    nextLine();
+    return true;
+}
+
+
+int ITC2007Parser::readSectionSize(char const *_name) {
+    skipEmptyLines();
+    std::size_t n = std::strlen(_name);
+    if (end - pos < (std::ptrdiff_t)n+2 || pos[0] != '[' || std::memcmp(pos+1, _name, n) != 0 || pos[n+1] != ':')
+        error(std::string("expected [") + _name + ":<size>]");
+    pos += n+2;
+    int size = readInt();
+    expect(']');
+    nextLine();
+    return size;
+}
+
+
+int ITC2007Parser::readInt() {
+    skipBlanks();
+    bool negative = false;
+    if (pos != end && (*pos == '-' || *pos == '+')) {
+        negative = (*pos == '-');
+        ++pos;
+    }
+    if (pos == end || *pos < '0' || *pos > '9')
+        error("expected an integer");
+    int value = 0;
+    for (; pos != end && *pos >= '0' && *pos <= '9'; ++pos)
+        value = value*10 + (*pos - '0');
+    return negative ? -value : value;
+}
+
+
+std::string ITC2007Parser::readWord() {
+    skipBlanks();
+    char const *first = pos;
+    while (pos != end && ((*pos >= 'A' && *pos <= 'Z') || *pos == '_'))
+        ++pos;
+    if (pos == first)
+        error("expected an identifier");
+    return std::string(first, pos);
+}
+
+
+void ITC2007Parser::expect(char _c) {
+    if (!tryRead(_c))
+        error(std::string("expected '") + _c + "'");
+}
+
+
+bool ITC2007Parser::tryRead(char _c) {
+    skipBlanks();
+    if (pos != end && *pos == _c) {
+        ++pos;
+        return true;
+    }
+    return false;
+}
+
+
+void ITC2007Parser::nextLine() {
+    skipBlanks();
+    if (!atEndOfLine())
+        error("unexpected characters at end of line");
+    if (pos != end && *pos == '\r')
+        ++pos;
+    if (pos != end && *pos == '\n')
+        ++pos;
+    ++lineNumber;
+}
+
+
+int ITC2007Parser::getLineNumber() const {
+    return lineNumber;
+}
+
+
+void ITC2007Parser::error(std::string const &_message) const {
+    throw std::runtime_error("ITC2007 instance, line " + std::to_string(lineNumber) + ": " + _message);
+}
+
+
+void ITC2007Parser::skipBlanks() {
+    while (pos != end && (*pos == ' ' || *pos == '\t'))
+        ++pos;
+}
+
+
+void ITC2007Parser::skipEmptyLines() {
+    while (true) {
+        skipBlanks();
+        if (pos == end || !atEndOfLine())
+            return;
+        nextLine();
+    }
+}
+
+
+bool ITC2007Parser::atEndOfLine() const {
+    return pos == end || *pos == '\r' || *pos == '\n';
+}
+
+
+#endif // ITC2007PARSER_H
@@ -1,6 +1,13 @@
 #include "ITC2007TestSet.h"
-#include <boost/regex.hpp>
-#include <boost/unordered_map.hpp>
+#include "testset/ITC2007Parser.h"
+#include "testset/ITC2007InstanceCache.h"
+#include "utils/MappedFile.h"
+#include "utils/WorkStealingPool.h"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <unistd.h>
+#include <boost/make_shared.hpp>
 #include "utils/DateTime.h"
 
 
@@ -79,19 +86,66 @@ void ITC2007TestSet::load() {
     //In addition, it is recomended that competitors should ignore unknown lines in the provided format.
 
     std::string filename = this->getRootDirectory() + "/" + this->getName();
-    std::string wholeFile = read_from_file(filename.c_str());
-    // Get line tokenizer
-    tokenizer<escaped_list_separator<char> > tok(wholeFile, escaped_list_separator<char>('\\', '\r')); // Lines terminate with \r\n
-    // Get line iterator
-    tokenizer<escaped_list_separator<char> >::iterator it = tok.begin();
+    // Map the instance file. It is parsed in a single pass, in place.
+    MappedFile file(filename);
+    // Hash of the instance file, which keys the preprocessed instance cache and
+    // identifies the instance in solution archives
+    uint64_t fileHash = ITC2007InstanceCache::hash(file.begin(), file.size());
+    timetableProblemData->setInstanceHash(fileHash);
+    if (useInstanceCache) {
+        if (ITC2007InstanceCache::read(ITC2007InstanceCache::getCacheFilename(filename), fileHash, file.size(),
+                                       *timetableProblemData.get())) {
+            timetableProblemData->updateMemoryAccounting();
+            return;
+        }
+    }
+    ITC2007Parser parser(file.begin(), file.end());
     // Read exams and students
-    readExams(it, tok);
+    readExams(parser);
     // Read periods
-    readPeriods(it, tok);
+    readPeriods(parser);
     // Read rooms
-    readRooms(it, tok);
+    readRooms(parser);
     // Read constraints and weightings
-    readConstraints(it, tok);
+    readConstraints(parser);
+    // Save the preprocessed instance for the next runs
+    if (useInstanceCache)
+        ITC2007InstanceCache::write(ITC2007InstanceCache::getCacheFilename(filename), fileHash, file.size(),
+                                    *timetableProblemData.get());
+    // Register the footprint of the loaded data
+    timetableProblemData->updateMemoryAccounting();
+}
+
+
+////
+/// \brief ITC2007TestSet::findInstanceFile
+/// \param _benchmarksDir
+/// \param _instance Instance name, e.g. set1
+/// \return Instance file name in _benchmarksDir, e.g. exam_comp_set1.exam, or "" if not found
+///
+string ITC2007TestSet::findInstanceFile(string const& _benchmarksDir, string const& _instance) {
+    string candidates[] = { _instance + ".exam", "exam_comp_" + _instance + ".exam" };
+    for (auto const& candidate : candidates) {
+        if (access((_benchmarksDir + "/" + candidate).c_str(), R_OK) == 0)
+            return candidate;
+    }
+    return "";
+}
+
+
+////
+/// \brief ITC2007TestSet::loadInstance
+/// \param _benchmarksDir
+/// \param _instance Instance name, e.g. set1
+/// \return Loaded instance. Throws std::runtime_error if its file isn't found or can't be read
+///
+boost::shared_ptr<ITC2007TestSet> ITC2007TestSet::loadInstance(string const& _benchmarksDir, string const& _instance) {
+    string instanceFile = findInstanceFile(_benchmarksDir, _instance);
+    if (instanceFile.empty())
+        throw runtime_error("instance file not found in " + _benchmarksDir);
+    auto testSet = boost::make_shared<ITC2007TestSet>(instanceFile, _instance, _benchmarksDir);
+    testSet->load();
+    return testSet;
 }
 
 
@@ -101,11 +155,9 @@ void ITC2007TestSet::load() {
 
 ////
 /// \brief ITC2007TestSet::readExams
-/// \param it
-/// \param tok
+/// \param _parser
 ///
-void ITC2007TestSet::readExams(tokenizer<escaped_list_separator<char> >::iterator& it,
-                               tokenizer<escaped_list_separator<char> > const& tok) {
+void ITC2007TestSet::readExams(ITC2007Parser &_parser) {
     //
     // The problem instance files have the following format;
     // Number of Exams:
@@ -116,113 +168,93 @@ void ITC2007TestSet::readExams(tokenizer<escaped_list_separator<char> >::iterato
     // The line ends with a return character and line feed and is comma separated.
     ////
 
-    // Number of exams
-    int numExams = 0;
-    if (it != tok.end()) {
-        // Read number of exams
-        std::string s(*it);
-        boost::cmatch matches;
-        boost::regex re("(\\[Exams:)(\\d+)(\\])");
-        // If there's a match
-        if (boost::regex_match(s.c_str(), matches, re)) {
-             // Extract digits from std::string. The digits are the third subexpression, index = 2.
-            std::string match(matches[2].first, matches[2].second);
-            numExams = atoi(match.c_str());
+    if (_parser.atEnd())
+        throw runtime_error("Error while reading ITC07 exams");
+    // Read number of exams
+    int numExams = _parser.readSectionSize("Exams");
 #ifdef ITC2007TESTSET_DEBUG
-            cout << "\tnumExams: " << numExams << endl;
+    cout << "\tnumExams: " << numExams << endl;
 #endif
-            // Set number of exams
-            timetableProblemData->setNumExams(numExams);
-            //////////////////////////////////////////
-            //
-            // Build Student map, Conflict matrix, and exam graph
-            //
-            //////////////////////////////////////////
-            //
-            // Define student map containing the list of exams for each student
-            //
-            boost::unordered_map<int, std::vector<int> > studentMap;
-            // Build Student map
-            buildStudentMap(it, tok, studentMap);
-            // Build Conflict matrix,
-            buildConflictMatrix(studentMap);
-            // Build exam graph representing exam relations
-            buildExamGraph(timetableProblemData.get()->getConflictMatrix());
+    // Set number of exams
+    timetableProblemData->setNumExams(numExams);
+    //////////////////////////////////////////
+    //
+    // Build Student index, Conflict matrix, and exam graph
+    //
+    //////////////////////////////////////////
+    //
+    // Define student index containing the list of exams for each student
+    //
+    StudentEnrolments studentEnrolments;
+    // Build Student index
+    buildStudentIndex(_parser, studentEnrolments);
+    // Build Conflict matrix,
+    buildConflictMatrix(studentEnrolments);
+    // Build exam graph representing exam relations
+    buildExamGraph(*timetableProblemData.get()->getSparseConflictMatrix());
 
 #ifdef ITC2007TESTSET_DEBUG
-            //////////////////////////////////////////////////////////////////////////
-            //
-            // Verification of conflict matrix and exam graph integrity
-            //
-            //////////////////////////////////////////////////////////////////////////
-            IntMatrix const& conflictMatrix = timetableProblemData.get()->getConflictMatrix();
-            cout << "nlines = " << conflictMatrix.getNumLines() << endl;
-            cout << "ncols = " << conflictMatrix.getNumCols() << endl;
-            // Count the number of non-zero elements
-            int nonZeroElements = 0;
-            // Verify if it's symmetric
-            for (int i = 0; i < conflictMatrix.getNumLines(); ++i) {
-                for (int j = 0; j < conflictMatrix.getNumCols(); ++j) {
-                    if (conflictMatrix.getVal(i,j) != 0)
-                        ++nonZeroElements;
-
-                    if (conflictMatrix.getVal(i, j) != conflictMatrix.getVal(j, i))
-                        throw runtime_error("Not symmetric");
-                }
-            }
-            // Print the conflict matrix density
-            double conflictDensity = timetableProblemData.get()->getConflictMatrixDensity();
-            cout << "conflictDensity = " << conflictDensity << endl;
-            cout << "conflictDensity [%] = " << setprecision(3) << (conflictDensity * 100) << endl;
-
-            // Verification of exam graph integrity.
-            // # conflicts between exams. Should be equal to the number of non-zero elements in the conflict matrix
-            int countNumConflicts = 0;
-            // Get exam graph
-            AdjacencyList const& examGraph = timetableProblemData.get()->getExamGraph();
-            property_map<AdjacencyList, vertex_index_t>::type index_map = get(vertex_index, examGraph);
-            graph_traits<AdjacencyList>::adjacency_iterator ai, a_end;
-            // Iterate over all exams and check if the number of edges in the exam graph
-            // correspond to the edeges in the conflict matrix
-            for (int ei = 0; ei < numExams; ++ei) {
-                // Get ei adjacent exams
-                boost::tie(ai, a_end) = adjacent_vertices(ei, examGraph);
-                for (; ai != a_end; ++ai) {
-                    // Get adjacent exam
-                    int ej = get(index_map, *ai);
-                    // Verify if there's a conflict between ei and ej
-                    if (conflictMatrix.getVal(ei, ej) > 0)
-                        ++countNumConflicts;
-                }
-            }
-            cout << "nonZeroElements = " << nonZeroElements << ", countNumConflicts = " << countNumConflicts << endl;
-            if (nonZeroElements != countNumConflicts)
-                throw runtime_error("Error in exam graph integrity");
-#endif
-
+    //////////////////////////////////////////////////////////////////////////
+    //
+    // Verification of conflict matrix and exam graph integrity
+    //
+    //////////////////////////////////////////////////////////////////////////
+    IntMatrix const& conflictMatrix = timetableProblemData.get()->getConflictMatrix();
+    cout << "nlines = " << conflictMatrix.getNumLines() << endl;
+    cout << "ncols = " << conflictMatrix.getNumCols() << endl;
+    // Count the number of non-zero elements
+    int nonZeroElements = 0;
+    // Verify if it's symmetric
+    for (int i = 0; i < conflictMatrix.getNumLines(); ++i) {
+        for (int j = 0; j < conflictMatrix.getNumCols(); ++j) {
+            if (conflictMatrix.getVal(i,j) != 0)
+                ++nonZeroElements;
+
+            if (conflictMatrix.getVal(i, j) != conflictMatrix.getVal(j, i))
+                throw runtime_error("Not symmetric");
         }
-        else
-        {
-            cout << "[readExams] Error parsing input file. The regexp \"" << re << "\" does not match \"" << s << "\"" << endl;
-            cin.get();
+    }
+    // Print the conflict matrix density
+    double conflictDensity = timetableProblemData.get()->getConflictMatrixDensity();
+    cout << "conflictDensity = " << conflictDensity << endl;
+    cout << "conflictDensity [%] = " << setprecision(3) << (conflictDensity * 100) << endl;
+
+    // Verification of exam graph integrity.
+    // # conflicts between exams. Should be equal to the number of non-zero elements in the conflict matrix
+    int countNumConflicts = 0;
+    // Get exam graph
+    AdjacencyList const& examGraph = timetableProblemData.get()->getExamGraph();
+    property_map<AdjacencyList, vertex_index_t>::type index_map = get(vertex_index, examGraph);
+    graph_traits<AdjacencyList>::adjacency_iterator ai, a_end;
+    // Iterate over all exams and check if the number of edges in the exam graph
+    // correspond to the edeges in the conflict matrix
+    for (int ei = 0; ei < numExams; ++ei) {
+        // Get ei adjacent exams
+        boost::tie(ai, a_end) = adjacent_vertices(ei, examGraph);
+        for (; ai != a_end; ++ai) {
+            // Get adjacent exam
+            int ej = get(index_map, *ai);
+            // Verify if there's a conflict between ei and ej
+            if (conflictMatrix.getVal(ei, ej) > 0)
+                ++countNumConflicts;
         }
     }
-    else
-        throw runtime_error("Error while reading ITC07 exams");
+    cout << "nonZeroElements = " << nonZeroElements << ", countNumConflicts = " << countNumConflicts << endl;
+    if (nonZeroElements != countNumConflicts)
+        throw runtime_error("Error in exam graph integrity");
+#endif
 }
 
 
-// Vector of pairs (exam idx, # students) for keeping course total students for each exam in a sorted manner
-
-
 ////
-/// \brief ITC2007TestSet::buildConflictMatrix
-/// \param it
-/// \param tok
+/// \brief ITC2007TestSet::buildStudentIndex Builds the student -> exams index from the
+/// exam -> students lines, in two passes over the mapped file. The first pass counts the
+/// exams of each student, the second one fills the index. The exams of each student are
+/// listed in increasing order, as they are read.
+/// \param _parser
+/// \param _studentEnrolments
 ///
-void ITC2007TestSet::buildStudentMap(boost::tokenizer<boost::escaped_list_separator<char> >::iterator &_it,
-                                     const boost::tokenizer<boost::escaped_list_separator<char> > &_tok,
-                                     boost::unordered_map<int, vector<int> > & _studentMap) {
+void ITC2007TestSet::buildStudentIndex(ITC2007Parser &_parser, StudentEnrolments &_studentEnrolments) {
 
     int numExams = timetableProblemData->getNumExams();
     // Vector for keeping course total students. Exams indexed from [0..numExams-1].
@@ -237,53 +269,36 @@ void ITC2007TestSet::buildStudentMap(boost::tokenizer<boost::escaped_list_separa
     int numEnrolments = 0;
     // Create *empty* exam vector
     boost::shared_ptr<vector<boost::shared_ptr<Exam> > > examVector(new vector<boost::shared_ptr<Exam> >());
-    // Go to the first line of exams
-    ++_it;
-    // Parse lines
-    for (int i = 0; i < numExams && _it != _tok.end(); ++i, ++_it) {
-        std::string line(*_it); // Lines start with \n because it wasn't removed
-#ifdef ITC2007TESTSET_DEBUG
-//        cout << i << ": " << line << endl;
-#endif
-        // Get number tokenizer
-        tokenizer<escaped_list_separator<char> > numberTok(line, escaped_list_separator<char>('\\', ','));
-        // Get number iterator
-        tokenizer<escaped_list_separator<char> >::iterator beg = numberTok.begin();
-        examDuration = atoi((*beg).c_str());
-#ifdef ITC2007TESTSET_DEBUG
-//        cout << "examDuration: " << examDuration << " - Students: ";
-#endif
-        ++beg; // Go to the first student
+    examVector->reserve(numExams);
+    // # exams of each student, indexed by student number
+    vector<int> &start = _studentEnrolments.start;
+    start.assign(1, 0);
+    //
+    // First pass: parse lines "duration, student, student, ..." and count
+    //
+    ITC2007Parser countParser(_parser);
+    for (int i = 0; i < numExams; ++i) {
+        if (countParser.atEnd())
+            throw runtime_error("Error while reading ITC07 exams: missing exam lines");
+        examDuration = countParser.readInt();
         // Exam number (start at 0)
         int exam = i;
         // Number of students enrolled in each exam
         int numExamStudents = 0;
 
-        for (; beg != numberTok.end(); ++beg) {
-#ifdef ITC2007TESTSET_DEBUG
-//            cout << *beg << " ";
-#endif
-            //////////////////////////////////////////
-            // Build student map
-            //////////////////////////////////////////
+        while (countParser.tryRead(',')) {
             // Current student
-            int student = atoi((*beg).c_str());
-            // Insert current exam, given by the index i, in the student map
-            // If student doesn't exist yet, create entry <student, exam>
-            boost::unordered_map<int, vector<int> >::iterator mapIt = _studentMap.find(student);
-            if (mapIt == _studentMap.end()) {
-                vector<int> exams;
-                exams.push_back(exam);
-                _studentMap.insert(pair<int, vector<int> >(student, exams));
-            }
-            else {
-                // Else add exam to the student exams
-                mapIt->second.push_back(exam);
-            }
+            int student = countParser.readInt();
+            if (student < 0)
+                countParser.error("negative student number");
+            // start[student+1] counts the exams of student
+            if (student+2 > (int)start.size())
+                start.resize(student+2, 0);
+            ++start[student+1];
             // Increment # students
             ++numExamStudents;
         }
-//        cout << endl << endl;
+        countParser.nextLine();
 
         // Insert total number of students associated to each exam
         (*courseClassSize.get())[exam] = numExamStudents;
@@ -295,16 +310,33 @@ void ITC2007TestSet::buildStudentMap(boost::tokenizer<boost::escaped_list_separa
         numEnrolments1 += numExamStudents;
     }
     int numStudents = 0, numStudents1 = 0, smallest = INT_MAX, greatest = INT_MIN;
-    for (auto const&s : _studentMap) {
-        //                cout << "Student: " << s.first << " - total exams: " << s.second.size() << endl;
+    for (int student = 0; student+1 < (int)start.size(); ++student) {
+        if (start[student+1] == 0)
+            continue;
         ++numStudents1;
-        smallest = min(smallest, s.first);
-        greatest = max(greatest, s.first);
-        numEnrolments += s.second.size();
+        smallest = min(smallest, student);
+        greatest = max(greatest, student);
+        numEnrolments += start[student+1];
     }
     // Update # students
     numStudents = greatest-smallest+1;
 
+    //
+    // Second pass: fill the index
+    //
+    for (std::size_t student = 1; student < start.size(); ++student)
+        start[student] += start[student-1];
+    _studentEnrolments.exams.resize(start.back());
+    vector<int> next(start.begin(), start.end()-1);
+    for (int exam = 0; exam < numExams; ++exam) {
+        // Skip empty lines and the exam duration, as validated by the first pass
+        _parser.atEnd();
+        _parser.readInt();
+        while (_parser.tryRead(','))
+            _studentEnrolments.exams[next[_parser.readInt()]++] = exam;
+        _parser.nextLine();
+    }
+
 #ifdef ITC2007TESTSET_DEBUG
     // Print student info
     cout << "Print student info" << endl << endl;
@@ -367,66 +399,145 @@ void ITC2007TestSet::buildStudentMap(boost::tokenizer<boost::escaped_list_separa
 
 /**
  * @brief ITC2007TestSet::buildConflictMatrix Builds the Conflict matrix
- * @param _studentMap Student map containing the list of exams for each student
- * @return
+ *
+ * Students are split in contiguous shards of the student index, one task each. A shard lists the
+ * exam pairs (v1 <= v2) of its students, sorts them and reduces equal pairs to
+ * (pair, # students). The shard counts are then merged by a sort-reduce into
+ * the sparse conflict structure (CSR, both triangles), from which the dense
+ * conflict matrix and its density are filled in O(nnz).
+ *
+ * @param _studentEnrolments Student index containing the list of exams for each student
  */
-void ITC2007TestSet::buildConflictMatrix(boost::unordered_map<int, vector<int> > const& _studentMap) {
+void ITC2007TestSet::buildConflictMatrix(StudentEnrolments const& _studentEnrolments) {
+    // Pair (v1, v2) packed in one key, v1 in the high half
+    typedef std::pair<uint64_t, int> PairCount;
     // # exams
     int numExams = timetableProblemData->getNumExams();
-    // Create shared ptr to manage Conflict Matrix
-    boost::shared_ptr<IntMatrix> ptrConflictMatrix(new IntMatrix(numExams, numExams));
-    // Get Conflict Matrix
-    IntMatrix &conflictMatrix = *ptrConflictMatrix.get();
-    // Now, fill the conflict matrix and exam graph for each student
-    // (each map entry corresponds to one student enrolment data)
-    int v1, v2;
-    for (auto entry : _studentMap) {
-        vector<int>& exams = entry.second;
-        int examListSize = exams.size();
-        for (int i = 0; i < examListSize; ++i) {
-            for (int j = i+1; j < examListSize; ++j) {
-                // Get vertices.
-                v1 = exams[i];
-                v2 = exams[j];
-                // Increment by one (one student is enrolled in v1 and v2) arc's cost in
-                // the conflict matrix for vertices v1 and v2
-                conflictMatrix.incVal(v1, v2);
-                conflictMatrix.incVal(v2, v1); // Conflict matrix is symmetric
+    // Exam lists of the students
+    vector<int> const& start = _studentEnrolments.start;
+    vector<int> const& studentExams = _studentEnrolments.exams;
+    std::size_t numStudents = start.size()-1;
+
+    unsigned numShards = std::max<std::size_t>(1, std::min<std::size_t>(numThreads, numStudents));
+    vector<vector<PairCount> > shardCounts(numShards);
+    WorkStealingPool pool(numShards);
+    pool.parallelFor(numShards, [&](unsigned _shard, unsigned _worker) {
+        std::size_t first = numStudents * _shard / numShards;
+        std::size_t last = numStudents * (_shard+1) / numShards;
+        vector<uint64_t> keys;
+        for (std::size_t s = first; s < last; ++s) {
+            int const* exams = studentExams.data() + start[s];
+            int examListSize = start[s+1] - start[s];
+            for (int i = 0; i < examListSize; ++i) {
+                for (int j = i+1; j < examListSize; ++j) {
+                    // One student is enrolled in v1 and v2
+                    uint64_t v1 = std::min(exams[i], exams[j]), v2 = std::max(exams[i], exams[j]);
+                    keys.push_back((v1 << 32) | v2);
+                }
             }
         }
+        std::sort(keys.begin(), keys.end());
+        vector<PairCount> &counts = shardCounts[_shard];
+        for (std::size_t k = 0; k < keys.size(); ) {
+            std::size_t next = k+1;
+            while (next < keys.size() && keys[next] == keys[k])
+                ++next;
+            counts.push_back(PairCount(keys[k], next-k));
+            k = next;
+        }
+    });
+
+    // Merge the shard counts
+    vector<PairCount> pairs;
+    for (auto &counts : shardCounts) {
+        pairs.insert(pairs.end(), counts.begin(), counts.end());
+        vector<PairCount>().swap(counts);
+    }
+    std::sort(pairs.begin(), pairs.end(), [](PairCount const& p1, PairCount const& p2) {
+        return p1.first < p2.first;
+    });
+    std::size_t numPairs = 0;
+    for (std::size_t k = 0; k < pairs.size(); ++k) {
+        if (numPairs > 0 && pairs[numPairs-1].first == pairs[k].first)
+            pairs[numPairs-1].second += pairs[k].second;
+        else
+            pairs[numPairs++] = pairs[k];
     }
+    pairs.resize(numPairs);
+
+    // Build the symmetric CSR structure. Pairs are sorted by (v1, v2), so every
+    // line is filled in increasing column order: first the pairs (c, line) with
+    // c < line, then the diagonal and the pairs (line, c) with c > line.
+    vector<int> rowStart(numExams+1, 0);
+    for (auto const& p : pairs) {
+        int v1 = p.first >> 32, v2 = p.first & 0xffffffff;
+        ++rowStart[v1+1];
+        if (v1 != v2)
+            ++rowStart[v2+1];
+    }
+    for (int i = 0; i < numExams; ++i)
+        rowStart[i+1] += rowStart[i];
+    vector<int> cols(rowStart[numExams]), vals(rowStart[numExams]);
+    vector<int> next(rowStart.begin(), rowStart.end()-1);
+    for (auto const& p : pairs) {
+        int v1 = p.first >> 32, v2 = p.first & 0xffffffff;
+        if (v1 == v2) {
+            // An exam listed twice for one student counts twice, as in a symmetric increment
+            cols[next[v1]] = v1;
+            vals[next[v1]++] = 2*p.second;
+        }
+        else {
+            cols[next[v1]] = v2;
+            vals[next[v1]++] = p.second;
+            cols[next[v2]] = v1;
+            vals[next[v2]++] = p.second;
+        }
+    }
+    boost::shared_ptr<SparseIntMatrix> ptrSparseConflictMatrix(
+                new SparseIntMatrix(numExams, std::move(rowStart), std::move(cols), std::move(vals)));
+
+    // Fill the dense conflict matrix from the sparse structure
+    boost::shared_ptr<IntMatrix> ptrConflictMatrix(new IntMatrix(numExams, numExams));
+    IntMatrix &conflictMatrix = *ptrConflictMatrix.get();
+    SparseIntMatrix const& sparseConflictMatrix = *ptrSparseConflictMatrix.get();
+    for (int i = 0; i < numExams; ++i)
+        for (int k = sparseConflictMatrix.getRowBegin(i); k < sparseConflictMatrix.getRowEnd(i); ++k)
+            conflictMatrix.setVal(i, sparseConflictMatrix.getCol(k), sparseConflictMatrix.getVal(k));
+    // The ‘conflict’ density is the ratio of the number of non-zero elements in the
+    // conflict matrix to the total number of conflict matrix elements, without the diagonal
+    double conflictMatrixDensity = (numExams > 1)
+            ? sparseConflictMatrix.getNumNonZeros() / ((double)numExams * numExams - numExams) : 0;
+
     // Set conflict matrix in the TimetableProblemData
-    timetableProblemData.get()->setConflictMatrix(ptrConflictMatrix);
+    timetableProblemData.get()->setConflictMatrix(ptrConflictMatrix, conflictMatrixDensity);
+    timetableProblemData.get()->setSparseConflictMatrix(ptrSparseConflictMatrix);
 }
 
 
 
 ////
-/// \brief ITC2007TestSet::buildExamGraph
-/// \param conflictMatrix
+/// \brief ITC2007TestSet::buildExamGraph Builds the exam graph, as a Boost adjacency list
+/// and as a CompactGraph, from the non-zero entries of the sparse conflict matrix, in O(nnz).
+/// Edges are added in increasing (v1, v2) order, so the neighbours of each vertex are
+/// listed in increasing order in both graphs.
+/// \param _sparseConflictMatrix
 ///
-void ITC2007TestSet::buildExamGraph(const IntMatrix &conflictMatrix) {
+void ITC2007TestSet::buildExamGraph(SparseIntMatrix const& _sparseConflictMatrix) {
     // Instantiate graph with ncols vertices
-//    boost::shared_ptr<AdjacencyList> ptrGraphAux(new AdjacencyList(conflictMatrix.getNumCols()+1));
-///
-/// SEE!
-///
-    boost::shared_ptr<AdjacencyList> ptrGraphAux(new AdjacencyList(conflictMatrix.getNumCols()));
+    boost::shared_ptr<AdjacencyList> ptrGraphAux(new AdjacencyList(_sparseConflictMatrix.getNumLines()));
 
     // and set TimetableProblemData field
     timetableProblemData.get()->setExamGraph(ptrGraphAux);
-    int cost;
     // Vertices start at 0 as specified by the ITC 2007 rules
-    for (int v1 = 0; v1 < conflictMatrix.getNumLines(); ++v1) {
-        for (int v2 = 0; v2 < conflictMatrix.getNumLines(); ++v2) {
-            cost = conflictMatrix.getVal(v1, v2);
-            if (cost != 0) {
-                if (v2 > v1) {
-                    add_edge(v1, v2, *ptrGraphAux.get());
-                }
-            }
+    for (int v1 = 0; v1 < _sparseConflictMatrix.getNumLines(); ++v1) {
+        for (int k = _sparseConflictMatrix.getRowBegin(v1); k < _sparseConflictMatrix.getRowEnd(v1); ++k) {
+            int v2 = _sparseConflictMatrix.getCol(k);
+            if (v2 > v1)
+                add_edge(v1, v2, *ptrGraphAux.get());
         }
     }
+    // Compact exam graph
+    timetableProblemData.get()->setCompactExamGraph(boost::make_shared<CompactGraph>(_sparseConflictMatrix));
 }
 
 
@@ -438,11 +549,9 @@ void ITC2007TestSet::buildExamGraph(const IntMatrix &conflictMatrix) {
 
 ////
 /// \brief ITC2007TestSet::readPeriods
-/// \param it
-/// \param tok
+/// \param _parser
 ///
-void ITC2007TestSet::readPeriods(tokenizer<escaped_list_separator<char> >::iterator& it,
-                                 tokenizer<escaped_list_separator<char> > const& tok) {
+void ITC2007TestSet::readPeriods(ITC2007Parser &_parser) {
     //
     // The problem instance files have the following format;
     // Number of Periods:
@@ -457,71 +566,29 @@ void ITC2007TestSet::readPeriods(tokenizer<escaped_list_separator<char> >::itera
     boost::shared_ptr<vector<boost::shared_ptr<ITC2007Period> > > periodVector(
                 new vector<boost::shared_ptr<ITC2007Period> >());
 
-    if (it != tok.end()) {
-        // Match period number
-        int numPeriods = matchPeriods(it);
-        int periodId = 0; // Period index
-        ++it; // Read next line
-        // Read periods info
-        for (int i = 0; i < numPeriods; ++i) {
-//            cout << "line " << (i+1) << ":" << endl;
-            // Match a sequence line
-            matchPeriodSequenceLine(periodId, it, periodVector);
-            ++periodId; // Increment period index
-            ++it; // Read next line
-        }
-        //
-        // Set TimetableProblemData field
-        //
-        // Set number of periods
-        timetableProblemData.get()->setNumPeriods(numPeriods);
-        // Set period vector
-        timetableProblemData->setPeriodVector(periodVector);
-#ifdef ITC2007TESTSET_DEBUG
-        // Processed period information
-        cout << "Processed period information: " << endl;
-        cout << "numPeriods = " << numPeriods << endl;
-        cout << "period vector # entries = " << timetableProblemData->getPeriodVector().size() << endl;
-#endif
-    }
-    else
+    if (_parser.atEnd())
         throw runtime_error("Error while reading ITC07 periods");
-}
-
-
-
-
-////
-/// \brief ITC2007TestSet::matchPeriods
-/// \param it
-/// \return
-///
-int ITC2007TestSet::matchPeriods(tokenizer<escaped_list_separator<char> >::iterator& it) {
-    /////////////////////////////////////////////////
-    // Lines start with \n because it wasn't removed
-    //
-    // Remove first \n in the regexp
-    /////////////////////////////////////////////////
-
-    // Number of periods
-    int numPeriods = 0;
     // Read number of periods specified within the Timetabling Session e.g. [Periods:42]
-    std::string s(*it);
-    boost::cmatch matches;
-    //        boost::regex re("(\\[Periods:)(\\d+)(\\])");
-    boost::regex re("(\\\n)(\\[Periods:)(\\d+)(\\])");
-
-    if (boost::regex_match(s.c_str(), matches, re)) {
-        // Extract digits from std::string. The digits are the third subexpression, index = 3.
-        std::string match(matches[3].first, matches[3].second);
-        numPeriods = atoi(match.c_str());
-//        cout << "\tnumPeriods: " << numPeriods << endl;
-    }
-    else {
-        cout << "The regexp \"" << re << "\" does not match \"" << s << "\"" << endl;
-        cin.get();
+    int numPeriods = _parser.readSectionSize("Periods");
+    periodVector->reserve(numPeriods);
+    // Read periods info
+    for (int periodId = 0; periodId < numPeriods; ++periodId) {
+        // Match a sequence line
+        matchPeriodSequenceLine(periodId, _parser, periodVector);
     }
-    return numPeriods;
+    //
+    // Set TimetableProblemData field
+    //
+    // Set number of periods
+    timetableProblemData.get()->setNumPeriods(numPeriods);
+    // Set period vector
+    timetableProblemData->setPeriodVector(periodVector);
+#ifdef ITC2007TESTSET_DEBUG
+    // Processed period information
+    cout << "Processed period information: " << endl;
+    cout << "numPeriods = " << numPeriods << endl;
+    cout << "period vector # entries = " << timetableProblemData->getPeriodVector().size() << endl;
+#endif
 }
 
 
@@ -529,63 +596,47 @@ int ITC2007TestSet::matchPeriods(tokenizer<escaped_list_separator<char> >::itera
 ////
 /// \brief ITC2007TestSet::matchPeriodSequenceLine
 /// \param _periodId
-/// \param _it
+/// \param _parser
 /// \param _periodVector
-/// \return
 ///
-int ITC2007TestSet::matchPeriodSequenceLine(int _periodId,
-                                            tokenizer<escaped_list_separator<char> >::iterator& _it,
-                                            boost::shared_ptr<vector<boost::shared_ptr<ITC2007Period> > >& _periodVector) {
+void ITC2007TestSet::matchPeriodSequenceLine(int _periodId, ITC2007Parser &_parser,
+                                             boost::shared_ptr<vector<boost::shared_ptr<ITC2007Period> > >& _periodVector) {
 
     // Read sequence of lines detailing Period Dates, Times, Durations and associated Penalty:
     //  E.g.  31:05:2005, 09:00:00, 180, 0.
-    std::string s(*_it);
-    //    std::std::string s("\n15:04:2005, 09:30:00");
-
-    boost::cmatch matches;
-    boost::regex re("(\\\n)(\\d{2}):(\\d{2}):(\\d{4}), (\\d{2}):(\\d{2}):(\\d{2}), (\\d+), (\\d+)");
-
-    if (boost::regex_match(s.c_str(), matches, re)) {
-        // Extract values from std::string. E.g., the day part is the second subexpression, index = 2.
-        std::string matchDay(matches[2].first, matches[2].second);
-        int day = atoi(matchDay.c_str());
-        std::string matchMonth(matches[3].first, matches[3].second);
-        int month = atoi(matchMonth.c_str());
-        std::string matchYear(matches[4].first, matches[4].second);
-        int year = atoi(matchYear.c_str());
-
-        std::string matchHour(matches[5].first, matches[5].second);
-        int hour = atoi(matchHour.c_str());
-        std::string matchMinute(matches[6].first, matches[6].second);
-        int minute = atoi(matchMinute.c_str());
-        std::string matchSecond(matches[7].first, matches[7].second);
-        int second = atoi(matchSecond.c_str());
-
-        std::string matchDuration(matches[8].first, matches[8].second);
-        int duration = atoi(matchDuration.c_str());
-
-        std::string matchPenalty(matches[9].first, matches[9].second);
-        int penalty = atoi(matchPenalty.c_str());
+    int day = _parser.readInt();
+    _parser.expect(':');
+    int month = _parser.readInt();
+    _parser.expect(':');
+    int year = _parser.readInt();
+    _parser.expect(',');
+
+    int hour = _parser.readInt();
+    _parser.expect(':');
+    int minute = _parser.readInt();
+    _parser.expect(':');
+    int second = _parser.readInt();
+    _parser.expect(',');
+
+    int duration = _parser.readInt();
+    _parser.expect(',');
+    int penalty = _parser.readInt();
+    _parser.nextLine();
 #ifdef ITC2007TESTSET_DEBUG
-        cout << "\tday: " << day << endl;
-        cout << "\tmonth: " << month << endl;
-        cout << "\tyear: " << year << endl;
-        cout << "\thour: " << hour << endl;
-        cout << "\tminute: " << minute << endl;
-        cout << "\tsecond: " << second << endl;
-        cout << "\tduration: " << duration << endl;
-        cout << "\tpenalty: " << penalty << endl;
-        cout << endl;
+    cout << "\tday: " << day << endl;
+    cout << "\tmonth: " << month << endl;
+    cout << "\tyear: " << year << endl;
+    cout << "\thour: " << hour << endl;
+    cout << "\tminute: " << minute << endl;
+    cout << "\tsecond: " << second << endl;
+    cout << "\tduration: " << duration << endl;
+    cout << "\tpenalty: " << penalty << endl;
+    cout << endl;
 #endif
-        // Create Period instance for keeping period information
-        boost::shared_ptr<ITC2007Period> period(new ITC2007Period(_periodId, Date(day, month, year),
-                                                                  Time(hour, minute, second), duration, penalty));
-        _periodVector->push_back(period);
-    }
-    else {
-        cout << "The regexp \"" << re << "\" does not match \"" << s << "\"" << endl;
-        cin.get();
-    }
+    // Create Period instance for keeping period information
+    boost::shared_ptr<ITC2007Period> period(new ITC2007Period(_periodId, Date(day, month, year),
+                                                              Time(hour, minute, second), duration, penalty));
+    _periodVector->push_back(period);
 }
 
 
@@ -596,11 +647,9 @@ int ITC2007TestSet::matchPeriodSequenceLine(int _periodId,
 
 ////
 /// \brief ITC2007TestSet::readRooms
-/// \param it
-/// \param tok
+/// \param _parser
 ///
-void ITC2007TestSet::readRooms(tokenizer<escaped_list_separator<char> >::iterator& it,
-                               tokenizer<escaped_list_separator<char> > const& tok) {
+void ITC2007TestSet::readRooms(ITC2007Parser &_parser) {
     //
     // The problem instance files have the following format;
     // Number of Rooms:
@@ -617,70 +666,29 @@ void ITC2007TestSet::readRooms(tokenizer<escaped_list_separator<char> >::iterato
     boost::shared_ptr<vector<boost::shared_ptr<Room> > > roomVector(
                 new vector<boost::shared_ptr<Room> >());
 
-    if (it != tok.end()) {
-        // Match rooms number
-        int numRooms = matchRooms(it);
-        int roomId = 0; // Room index
-        ++it; // Read next line
-        // Read rooms info
-        for (int i = 0; i < numRooms; ++i) {
-//            cout << "line " << (i+1) << ":" << endl;
-            // Match a sequence line
-            matchRoomSequenceLine(roomId, it, roomVector);
-            ++roomId; // Increment room index
-            ++it; // Read next line
-        }
-        //
-        // Set TimetableProblemData field
-        //
-        // Set number of rooms
-        (*timetableProblemData.get()).setNumRooms(numRooms);
-        // Set room vector
-        timetableProblemData->setRoomVector(roomVector);
-#ifdef ITC2007TESTSET_DEBUG
-        // Processed period information
-        cout << "Processed room information: " << endl;
-        cout << "numRooms = " << numRooms << endl;
-        cout << "room vector # entries = " << timetableProblemData->getRoomVector().size() << endl;
-#endif
-    }
-    else
+    if (_parser.atEnd())
         throw runtime_error("Error while reading ITC07 rooms");
-}
-
-
-
-////
-/// \brief ITC2007TestSet::matchRooms
-/// \param it
-/// \return
-///
-int ITC2007TestSet::matchRooms(tokenizer<escaped_list_separator<char> >::iterator& it) {
-    /////////////////////////////////////////////////
-    // Lines start with \n because it wasn't removed
-    //
-    // Remove first \n in the regexp
-    /////////////////////////////////////////////////
-
-    // Number of rooms
-    int numRooms = 0;
     // Read number of rooms used e.g. [Rooms:10]
-    std::string s(*it);
-    boost::cmatch matches;
-    //        boost::regex re("(\\[Rooms:)(\\d+)(\\])");
-    boost::regex re("(\\\n)(\\[Rooms:)(\\d+)(\\])");
-
-    if (boost::regex_match(s.c_str(), matches, re)) {
-        // Extract digits from std::string. The digits are the third subexpression, index = 3.
-        std::string match(matches[3].first, matches[3].second);
-        numRooms = atoi(match.c_str());
-    }
-    else {
-        cout << "The regexp \"" << re << "\" does not match \"" << s << "\"" << endl;
-        cin.get();
+    int numRooms = _parser.readSectionSize("Rooms");
+    roomVector->reserve(numRooms);
+    // Read rooms info
+    for (int roomId = 0; roomId < numRooms; ++roomId) {
+        // Match a sequence line
+        matchRoomSequenceLine(roomId, _parser, roomVector);
     }
-
-    return numRooms;
+    //
+    // Set TimetableProblemData field
+    //
+    // Set number of rooms
+    (*timetableProblemData.get()).setNumRooms(numRooms);
+    // Set room vector
+    timetableProblemData->setRoomVector(roomVector);
+#ifdef ITC2007TESTSET_DEBUG
+    // Processed period information
+    cout << "Processed room information: " << endl;
+    cout << "numRooms = " << numRooms << endl;
+    cout << "room vector # entries = " << timetableProblemData->getRoomVector().size() << endl;
+#endif
 }
 
 
@@ -688,40 +696,25 @@ int ITC2007TestSet::matchRooms(tokenizer<escaped_list_separator<char> >::iterato
 ////
 /// \brief ITC2007TestSet::matchRoomSequenceLine
 /// \param _roomId
-/// \param _it
+/// \param _parser
 /// \param _roomVector
-/// \return
 ///
-int ITC2007TestSet::matchRoomSequenceLine(int _roomId, tokenizer<escaped_list_separator<char> >::iterator& _it,
-                                          boost::shared_ptr<vector<boost::shared_ptr<Room> > > &_roomVector) {
+void ITC2007TestSet::matchRoomSequenceLine(int _roomId, ITC2007Parser &_parser,
+                                           boost::shared_ptr<vector<boost::shared_ptr<Room> > > &_roomVector) {
     // Read sequence of lines detailing room capacity and associated penalty:
     //  E.g.  260, 0
-    std::string s(*_it);
-    boost::cmatch matches;
-    boost::regex re("(\\\n)(\\d+), (\\d+)");
-
-    if (boost::regex_match(s.c_str(), matches, re)) {
-        // Extract values from std::string.
-        std::string matchCapacity(matches[2].first, matches[2].second);
-        int roomCapacity = atoi(matchCapacity.c_str());
-
-        std::string matchPenalty(matches[3].first, matches[3].second);
-        int penalty = atoi(matchPenalty.c_str());
+    int roomCapacity = _parser.readInt();
+    _parser.expect(',');
+    int penalty = _parser.readInt();
+    _parser.nextLine();
 #ifdef ITC2007TESTSET_DEBUG
-//        cout << "\tcapacity: " << roomCapacity << endl;
-//        cout << "\tpenalty: " << penalty << endl;
-//        cout << endl;
+//    cout << "\tcapacity: " << roomCapacity << endl;
+//    cout << "\tpenalty: " << penalty << endl;
+//    cout << endl;
 #endif
-        // Get number of periods
-        int numPeriods = timetableProblemData.get()->getNumPeriods();
-        // Create Room instance for keeping room information
-        boost::shared_ptr<Room> room(new Room(_roomId, roomCapacity, penalty));
-        _roomVector->push_back(room);
-    }
-    else {
-        cout << "The regexp \"" << re << "\" does not match \"" << s << "\"" << endl;
-        cin.get();
-    }
+    // Create Room instance for keeping room information
+    boost::shared_ptr<Room> room(new Room(_roomId, roomCapacity, penalty));
+    _roomVector->push_back(room);
 }
 
 
@@ -732,11 +725,9 @@ int ITC2007TestSet::matchRoomSequenceLine(int _roomId, tokenizer<escaped_list_se
 
 ////
 /// \brief ITC2007TestSet::readConstraints
-/// \param it
-/// \param tok
+/// \param _parser
 ///
-void ITC2007TestSet::readConstraints(tokenizer<escaped_list_separator<char> >::iterator& it,
-                                     tokenizer<escaped_list_separator<char> > const& tok) {
+void ITC2007TestSet::readConstraints(ITC2007Parser &_parser) {
 
     //
     // The problem instance files have the following format:
@@ -770,154 +761,97 @@ void ITC2007TestSet::readConstraints(tokenizer<escaped_list_separator<char> >::i
     // FRONTLOAD, 100, 30, 5
     ////
 
-    // Get hard and soft constraints vectors
+    // Get hard constraints vector
     auto &hardConstraints = timetableProblemData.get()->getHardConstraints();
-//    auto &softConstraints = timetableProblemData.get()->getSoftConstraints();
     InstitutionalModelWeightings model_weightings;
 
-    if (it != tok.end()) {
-        readPeriodHardConstraints(it, hardConstraints);
+    if (!_parser.atEnd()) {
+        readPeriodHardConstraints(_parser, hardConstraints);
 #ifdef ITC2007TESTSET_DEBUG
         cout << "Finished reading Period hard constraints" << endl;
 #endif
 
-        readRoomHardConstraints(it, hardConstraints);
+        readRoomHardConstraints(_parser, hardConstraints);
 #ifdef ITC2007TESTSET_DEBUG
         cout << "Finished reading Room hard constraints" << endl;
 #endif
 
         // Read Institutional Weightings
-        readInstitutionalWeightingsSoftConstraints(it, model_weightings);
+        readInstitutionalWeightingsSoftConstraints(_parser, model_weightings);
 #ifdef ITC2007TESTSET_DEBUG
         cout << "Finished reading Institutional Weightings soft constraints" << endl;
 #endif
 
-    // Set timetableProblemData Institutional Model Weightings
-    timetableProblemData->setInstitutionalModelWeightings(model_weightings);
-
-//        // Read Institutional Weightings soft constraints
-//        readInstitutionalWeightingsSoftConstraints(it, softConstraints);
-//#ifdef ITC2007TESTSET_DEBUG
-//        cout << "Finished reading Institutional Weightings soft constraints" << endl;
-//#endif
+        // Set timetableProblemData Institutional Model Weightings
+        timetableProblemData->setInstitutionalModelWeightings(model_weightings);
     }
-
-//    // Add Soft Room penalty and Soft Period penalty constraints
-//    boost::shared_ptr<Constraint> roomPenaltysoftConstr(
-//                new RoomPenaltySoftConstraint()
-//                );
-//    softConstraints.push_back(roomPenaltysoftConstr);
-
-//    boost::shared_ptr<Constraint> periodPenaltysoftConstr(
-//                new PeriodPenaltySoftConstraint()
-//                );
-//    softConstraints.push_back(periodPenaltysoftConstr);
 }
 
 
 
 ////
 /// \brief ITC2007TestSet::readPeriodHardConstraints
-/// \param it
+/// \param _parser
 /// \param hardConstraints
 ///
-void ITC2007TestSet::readPeriodHardConstraints(tokenizer<escaped_list_separator<char> >::iterator& it,
+void ITC2007TestSet::readPeriodHardConstraints(ITC2007Parser &_parser,
                                                vector<boost::shared_ptr<Constraint> > &hardConstraints) {
-    std::string s(*it);
-    boost::cmatch matches;
     // Section begins with the tag [PeriodHardConstraints]
-    boost::regex re("(\\\n)(\\[PeriodHardConstraints\\])");
-    if (!boost::regex_match(s.c_str(), matches, re))
-    {
-        cout << "The regexp \"" << re << "\" does not match \"" << s << "\"" << endl;
-        // throw exception
+    if (!_parser.readSectionHeader("PeriodHardConstraints"))
         throw runtime_error("No PeriodHardConstraints specified");
-    }
 #ifdef ITC2007TESTSET_DEBUG
     cout << "Read period hard constraints header" << endl;
 #endif
-    ++it; // Proceed to read the next line
-
-    // Read constraints if any.
-    // If line starts with a number then is a Period hard constraint
-    while (readPeriodConstraint(it, hardConstraints))
-        ++it;
+    // Read constraints if any, up to the header of Room hard constraints
+    while (readPeriodConstraint(_parser, hardConstraints))
+        ;
 }
 
 
 
 ////
 /// \brief ITC2007TestSet::readPeriodConstraint
-/// \param it
+/// \param _parser
 /// \param hardConstraints
-/// \return
+/// \return false if there are no more period constraints
 ///
-bool ITC2007TestSet::readPeriodConstraint(tokenizer<escaped_list_separator<char> >::iterator& it,
+bool ITC2007TestSet::readPeriodConstraint(ITC2007Parser &_parser,
                                           vector<boost::shared_ptr<Constraint> >& hardConstraints) {
-    std::string s(*it);
-    boost::cmatch matches;
-    boost::regex re("(\\\n)(\\d+), (AFTER|EXAM_COINCIDENCE|EXCLUSION), (\\d+)");
-
-    if (boost::regex_match(s.c_str(), matches, re)) {
-        // Extract values from std::string.
-        // Read Exam 1
-        std::string matchExam1(matches[2].first, matches[2].second);
-        int exam1 = atoi(matchExam1.c_str());
-        // Read Constraint type
-        std::string constraintType(matches[3].first, matches[3].second);
-        // Read Exam 2
-        std::string matchExam2(matches[4].first, matches[4].second);
-        int exam2 = atoi(matchExam2.c_str());
+    if (_parser.atEnd() || _parser.atSectionHeader())
+        return false;
+    // E.g. 0, AFTER, 3
+    int exam1 = _parser.readInt();
+    _parser.expect(',');
+    std::string constraintType = _parser.readWord();
+    _parser.expect(',');
+    int exam2 = _parser.readInt();
+    _parser.nextLine();
 #ifdef ITC2007TESTSET_DEBUG
-        cout << "\texam1: " << exam1 << endl;
-        cout << "\ttype of constraint: " << constraintType << endl;
-        cout << "\texam2: " << exam2 << endl;
-        cout << endl;
+    cout << "\texam1: " << exam1 << endl;
+    cout << "\ttype of constraint: " << constraintType << endl;
+    cout << "\texam2: " << exam2 << endl;
+    cout << endl;
 #endif
+    auto const& examVector = this->getTimetableProblemData()->getExamVector();
+    int numExams = timetableProblemData->getNumExams();
+    if (exam1 < 0 || exam1 >= numExams || exam2 < 0 || exam2 >= numExams)
+        _parser.error("exam index out of range");
 
-///
-/// TODO: Improve code generality
-///
+    // Period Related Hard Constraints
+    boost::shared_ptr<Constraint> hardConstr;
+    if (constraintType == "EXAM_COINCIDENCE")
+        hardConstr = boost::make_shared<ExamCoincidenceConstraint>(exam1, exam2);
+    else if (constraintType == "EXCLUSION")
+        hardConstr = boost::make_shared<ExamExclusionConstraint>(exam1, exam2);
+    else if (constraintType == "AFTER")
+        hardConstr = boost::make_shared<AfterConstraint>(exam1, exam2);
+    else
+        _parser.error("unknown period constraint " + constraintType);
 
-        auto const& examVector = this->getTimetableProblemData()->getExamVector();
-
-        // Period Related Hard Constraints
-        if (constraintType == "EXAM_COINCIDENCE") {
-            boost::shared_ptr<Constraint> hardConstr(
-                        new ExamCoincidenceConstraint(exam1, exam2)
-                        );
-            hardConstraints.push_back(hardConstr);
-            // Insert this hard constraint into each associated exam, 'exam1' and 'exam2'
-            examVector[exam1]->insertPeriodRelatedHardConstraint(hardConstr);
-            examVector[exam2]->insertPeriodRelatedHardConstraint(hardConstr);
-        }
-        else if (constraintType == "EXCLUSION") {
-            boost::shared_ptr<Constraint> hardConstr(
-                        new ExamExclusionConstraint(exam1, exam2)
-                        );
-            hardConstraints.push_back(hardConstr);
-            // Insert this hard constraint into each associated exam, 'exam1' and 'exam2'
-            examVector[exam1]->insertPeriodRelatedHardConstraint(hardConstr);
-            examVector[exam2]->insertPeriodRelatedHardConstraint(hardConstr);
-        }
-        else if (constraintType == "AFTER") {
-            boost::shared_ptr<Constraint> hardConstr(
-                        new AfterConstraint(exam1, exam2)
-                        );
-            hardConstraints.push_back(hardConstr);
-            // Insert this hard constraint into each associated exam, 'exam1' and 'exam2'
-            examVector[exam1]->insertPeriodRelatedHardConstraint(hardConstr);
-            examVector[exam2]->insertPeriodRelatedHardConstraint(hardConstr);
-        }
-    }
-    else {
-//        cout << "The regexp \"" << re << "\" does not match \"" << s << "\"" << endl;
-        //        cin.get();
-        return false; // It couldn't read a period constraint.
-        // There are two possibilities:
-        // (1) the file format is incorrect,
-        // (2) Read the header of Room hard constraint
-    }
+    hardConstraints.push_back(hardConstr);
+    // Insert this hard constraint into each associated exam, 'exam1' and 'exam2'
+    examVector[exam1]->insertPeriodRelatedHardConstraint(hardConstr);
+    examVector[exam2]->insertPeriodRelatedHardConstraint(hardConstr);
     return true;
 }
 
@@ -925,13 +859,11 @@ bool ITC2007TestSet::readPeriodConstraint(tokenizer<escaped_list_separator<char>
 
 /////
 /// \brief ITC07TestSet::readRoomHardConstraints
-/// \param it
+/// \param _parser
 /// \param hardConstraints
 ///
-void ITC2007TestSet::readRoomHardConstraints(tokenizer<escaped_list_separator<char> >::iterator& it,
+void ITC2007TestSet::readRoomHardConstraints(ITC2007Parser &_parser,
                                              vector<boost::shared_ptr<Constraint> >& hardConstraints) {
-    std::string s(*it);
-    boost::cmatch matches;
     // Room Related Hard Constraints
     //
     // This section begins with the line [RoomHardConstraints] and provides data on conditions which are
@@ -939,72 +871,52 @@ void ITC2007TestSet::readRoomHardConstraints(tokenizer<escaped_list_separator<ch
     // This is
     // ROOM_EXCLUSIVE.  An exam must be timetabled in a room by itself e.g.
     // 2, ROOM_EXCLUSIVE      Exam ‘2' must be timetabled in a room by itself.
-    boost::regex re("(\\\n)(\\[RoomHardConstraints\\])");
-    if (!boost::regex_match(s.c_str(), matches, re))
-    {
-        cout << "The regexp \"" << re << "\" does not match \"" << s << "\"" << endl;
-        // throw exception
+    if (!_parser.readSectionHeader("RoomHardConstraints"))
         throw runtime_error("No RoomHardConstraints specified");
-    }
 #ifdef ITC2007TESTSET_DEBUG
     cout << "Read room hard constraints header" << endl;
 #endif
-    ++it; // Proceed to read the next line
-
-    // Read constraints if any.
-    // If line starts with a number then is a Room hard constraint
-    while (readRoomConstraint(it, hardConstraints))
-        ++it;
+    // Read constraints if any, up to the header of InstitutionalWeightings
+    while (readRoomConstraint(_parser, hardConstraints))
+        ;
 }
 
 
 
 /////
 /// \brief ITC07TestSet::readRoomConstraint
-/// \param it
+/// \param _parser
 /// \param hardConstraints
-/// \return
+/// \return false if there are no more room constraints
 ///
-bool ITC2007TestSet::readRoomConstraint(tokenizer<escaped_list_separator<char> >::iterator& it,
+bool ITC2007TestSet::readRoomConstraint(ITC2007Parser &_parser,
                                         vector<boost::shared_ptr<Constraint> >& hardConstraints) {
-    std::string s(*it);
-    boost::cmatch matches;
-    boost::regex re("(\\\n)(\\d+), (ROOM_EXCLUSIVE)");
-
-    if (boost::regex_match(s.c_str(), matches, re)) {
-        // Extract values from std::string.
-        // Read Exam
-        std::string matchExam(matches[2].first, matches[2].second);
-        int exam = atoi(matchExam.c_str());
-        // Read Constraint type
-        std::string constraintType(matches[3].first, matches[3].second);
+    if (_parser.atEnd() || _parser.atSectionHeader())
+        return false;
+    // E.g. 2, ROOM_EXCLUSIVE
+    int exam = _parser.readInt();
+    _parser.expect(',');
+    std::string constraintType = _parser.readWord();
+    _parser.nextLine();
 #ifdef ITC2007TESTSET_DEBUG
-        cout << "\texam: " << exam << endl;
-        cout << "\ttype of constraint: " << constraintType << endl;
-        cout << endl;
+    cout << "\texam: " << exam << endl;
+    cout << "\ttype of constraint: " << constraintType << endl;
+    cout << endl;
 #endif
-        auto const& examVector = this->getTimetableProblemData()->getExamVector();
-
-        ///
-        /// Improve code generality
-        ///
-        // Room Related Hard Constraints
-        if (constraintType == "ROOM_EXCLUSIVE") {
-            boost::shared_ptr<Constraint> hardConstr(
-                        new RoomExclusiveConstraint(exam)
-                        );
-            hardConstraints.push_back(hardConstr);
-            // Insert this hard constraint into the associated exam, 'exam'
-            examVector[exam]->insertRoomRelatedHardConstraint(hardConstr);
-        }
-    }
-    else {
-//        cout << "The regexp \"" << re << "\" does not match \"" << s << "\"" << endl;
-        return false; // It couldn't read a room constraint.
-        // There are two possibilities:
-        // (1) the file format is incorrect,
-        // (2) Read the header of InstitutionalWeightings
-    }
+    auto const& examVector = this->getTimetableProblemData()->getExamVector();
+    if (exam < 0 || exam >= timetableProblemData->getNumExams())
+        _parser.error("exam index out of range");
+
+    // Room Related Hard Constraints
+    if (constraintType != "ROOM_EXCLUSIVE")
+        _parser.error("unknown room constraint " + constraintType);
+
+    boost::shared_ptr<Constraint> hardConstr(
+                new RoomExclusiveConstraint(exam)
+                );
+    hardConstraints.push_back(hardConstr);
+    // Insert this hard constraint into the associated exam, 'exam'
+    examVector[exam]->insertRoomRelatedHardConstraint(hardConstr);
     return true;
 }
 
@@ -1015,10 +927,10 @@ bool ITC2007TestSet::readRoomConstraint(tokenizer<escaped_list_separator<char> >
 
 ////
 /// \brief ITC2007TestSet::readInstitutionalWeightingsSoftConstraints
-/// \param it
-/// \param softConstraints
+/// \param _parser
+/// \param _model_weightings
 ///
-void ITC2007TestSet::readInstitutionalWeightingsSoftConstraints(tokenizer<escaped_list_separator<char> >::iterator& it,
+void ITC2007TestSet::readInstitutionalWeightingsSoftConstraints(ITC2007Parser &_parser,
                                                                 InstitutionalModelWeightings &_model_weightings) {
     // Institutional Model Weightings
     //
@@ -1031,24 +943,15 @@ void ITC2007TestSet::readInstitutionalWeightingsSoftConstraints(tokenizer<escape
     // NONMIXEDDURATIONS, 10
     // FRONTLOAD, 100, 30, 5
     //
-    std::string s(*it);
-    boost::cmatch matches;
     // Section begins with the tag [InstitutionalWeightings]
-    boost::regex re("(\\\n)(\\[InstitutionalWeightings\\])");
-    if (!boost::regex_match(s.c_str(), matches, re))
-    {
-        cout << "The regexp \"" << re << "\" does not match \"" << s << "\"" << endl;
-        // throw exception
+    if (!_parser.readSectionHeader("InstitutionalWeightings"))
         throw runtime_error("No InstitutionalWeightings specified");
-    }
 #ifdef ITC2007TESTSET_DEBUG
     cout << "Read [InstitutionalWeightings] header" << endl;
 #endif
-    ++it; // Proceed to read the next line
-
-    // Read constraints if any.
-    while (readInstitutionalWeightingsConstraint(it, _model_weightings))
-        ++it;
+    // Read constraints if any, up to the end of file
+    while (readInstitutionalWeightingsConstraint(_parser, _model_weightings))
+        ;
 }
 
 
@@ -1059,117 +962,64 @@ void ITC2007TestSet::readInstitutionalWeightingsSoftConstraints(tokenizer<escape
 
 ////
 /// \brief ITC2007TestSet::readInstitutionalWeightingsConstraint
-/// \param it
-/// \param softConstraints
-/// \return
+/// \param _parser
+/// \param _model_weightings
+/// \return false if there are no more weightings
 ///
-bool ITC2007TestSet::readInstitutionalWeightingsConstraint(tokenizer<escaped_list_separator<char> >::iterator& it,
+bool ITC2007TestSet::readInstitutionalWeightingsConstraint(ITC2007Parser &_parser,
                                                            InstitutionalModelWeightings &_model_weightings) {
-    std::string s(*it);
-    boost::cmatch matches;
-
-    ///
-    /// Improve code generality and regex parsing robustness
-    ///
-
+    if (_parser.atEnd() || _parser.atSectionHeader())
+        return false;
     // E. g.
     // TWOINAROW, 7
     // TWOINADAY, 5
     // PERIODSPREAD, 3
     // NONMIXEDDURATIONS, 10
     // FRONTLOAD, 100, 30, 5
-    boost::regex re("(\\\n)(((TWOINAROW|TWOINADAY|PERIODSPREAD|NONMIXEDDURATIONS),(\\s*)(\\d+))|((FRONTLOAD),(\\s*)(\\d+),(\\s*)(\\d+),(\\s*)(\\d+)))");
-
-    if (boost::regex_match(s.c_str(), matches, re)) {
-        // Extract values from std::string.
-        //
-        // In the case of the constraints:
-        //  TWOINAROW, 7
-        //  TWOINADAY, 5
-        //  PERIODSPREAD, 3
-        //  NONMIXEDDURATIONS, 10
-        //
-        // matches[4] and matches[6] contain the <constraint type> and <id> fields.
-        //
-        // In the constraint:
-        // FRONTLOAD, 100, 30, 5
-        //
-        // matches[8], matches[10], matches[12], and matches[14] contain the <constraint type> and <id1>,<id2>,<id3> fields.
-        //
-        //  Input line containing constraint info
-        std::string inputLine(matches[2].first, matches[2].second);
-
-        if (inputLine.find("FRONTLOAD") != std::string::npos) {
-            // Constraint type
-            std::string constraintType(matches[8].first, matches[8].second);
-            // Id1
-            std::string matchId1(matches[10].first, matches[10].second);
-            int id1 = atoi(matchId1.c_str());
-            // Id2
-            std::string matchId2(matches[12].first, matches[12].second);
-            int id2 = atoi(matchId2.c_str());
-            // Id3
-            std::string matchId3(matches[14].first, matches[14].second);
-            int id3 = atoi(matchId3.c_str());
+    std::string constraintType = _parser.readWord();
+    _parser.expect(',');
+    int id = _parser.readInt();
+
+    if (constraintType == "FRONTLOAD") {
+        _parser.expect(',');
+        int id2 = _parser.readInt();
+        _parser.expect(',');
+        int id3 = _parser.readInt();
 #ifdef ITC2007TESTSET_DEBUG
-            cout << "\ttype of constraint: " << constraintType << endl;
-            cout << "\tid1: " << id1 << endl;
-            cout << "\tid2: " << id2 << endl;
-            cout << "\tid3: " << id3 << endl;
-            cout << endl;
-#endif
-            // FRONTLOAD soft constraint
-            if (constraintType == "FRONTLOAD") {
-                // First parameter  = number of largest exams. Largest exams are specified by class size
-                // Second parameter = number of last periods to take into account
-                // Third parameter  = the penalty or weighting
-                int numberLargestExams = id1;
-                int numberLastPeriods = id2;
-                int weightFL = id3;
-                // Set fields in _model_weightings instance
-                _model_weightings.front_load = { numberLargestExams, numberLastPeriods, weightFL };
-            }
-        }
-        else {
-            // Constraint type
-            std::string constraintType(matches[4].first, matches[4].second);
-            // Id
-            std::string matchId(matches[6].first, matches[6].second);
-            int id = atoi(matchId.c_str());
-#ifdef ITC2007TESTSET_DEBUG
-            cout << "\ttype of constraint: " << constraintType << endl;
-            cout << "\tid: " << id << endl;
+        cout << "\ttype of constraint: " << constraintType << endl;
+        cout << "\tid1: " << id << endl;
+        cout << "\tid2: " << id2 << endl;
+        cout << "\tid3: " << id3 << endl;
+        cout << endl;
 #endif
-            // TWOINAROW soft constraint
-            if (constraintType == "TWOINAROW") {
-                int weight2R = id;
-                // Set fields in _model_weightings instance
-                _model_weightings.two_in_a_row = weight2R;
-            }
-            else if (constraintType == "TWOINADAY") { // TWOINADAY soft constraint
-                int weight2D = id;
-                // Set fields in _model_weightings instance
-                _model_weightings.two_in_a_day = weight2D;
-            }
-            else if (constraintType == "PERIODSPREAD") { // PERIODSPREAD soft constraint
-                int weightPS = id;
-                // Set fields in _model_weightings instance
-                _model_weightings.period_spread = weightPS;
-            }
-            else if (constraintType == "NONMIXEDDURATIONS") { // NONMIXEDDURATIONS soft constraint
-                int weightNMD = id;
-                // Set fields in _model_weightings instance
-                _model_weightings.non_mixed_durations = weightNMD;
-            }
-        }
+        // FRONTLOAD soft constraint
+        // First parameter  = number of largest exams. Largest exams are specified by class size
+        // Second parameter = number of last periods to take into account
+        // Third parameter  = the penalty or weighting
+        int numberLargestExams = id;
+        int numberLastPeriods = id2;
+        int weightFL = id3;
+        // Set fields in _model_weightings instance
+        _model_weightings.front_load = { numberLargestExams, numberLastPeriods, weightFL };
     }
     else {
-//        cout << "The regexp \"" << re << "\" does not match \"" << s << "\"" << endl;
-        return false; // It couldn't read a period constraint.
-        // There are two possibilities:
-        // (1) the file format is incorrect,
-        // (2) Reach the end of file
+#ifdef ITC2007TESTSET_DEBUG
+        cout << "\ttype of constraint: " << constraintType << endl;
+        cout << "\tid: " << id << endl;
+#endif
+        // Set fields in _model_weightings instance
+        if (constraintType == "TWOINAROW")              // TWOINAROW soft constraint
+            _model_weightings.two_in_a_row = id;
+        else if (constraintType == "TWOINADAY")         // TWOINADAY soft constraint
+            _model_weightings.two_in_a_day = id;
+        else if (constraintType == "PERIODSPREAD")      // PERIODSPREAD soft constraint
+            _model_weightings.period_spread = id;
+        else if (constraintType == "NONMIXEDDURATIONS") // NONMIXEDDURATIONS soft constraint
+            _model_weightings.non_mixed_durations = id;
+        else
+            _parser.error("unknown institutional weighting " + constraintType);
     }
+    _parser.nextLine();
     return true;
 }
 
@@ -10,7 +10,7 @@
 #include "data/Room.h"
 #include "data/ITC2007Period.h"
 #include "data/ConstraintValidator.hpp"
-#include <boost/tokenizer.hpp>
+#include "testset/ITC2007Parser.h"
 
 
 
@@ -18,9 +18,13 @@
 class ITC2007TestSet : public TestSet {
 
 public:
-    // Constructor
-    ITC2007TestSet(std::string _testSetName, std::string _description, std::string _rootDir)
-        : TestSet(_testSetName, _description, _rootDir, boost::shared_ptr<TimetableProblemData>(new TimetableProblemData()))
+    // Constructor. If _useInstanceCache is true, load() reads the preprocessed instance from a
+    // binary cache next to the .exam file, creating it on the first run (see ITC2007InstanceCache).
+    // _numThreads threads build the conflict matrix.
+    ITC2007TestSet(std::string _testSetName, std::string _description, std::string _rootDir,
+                   bool _useInstanceCache = false, unsigned _numThreads = 1)
+        : TestSet(_testSetName, _description, _rootDir, boost::shared_ptr<TimetableProblemData>(new TimetableProblemData())),
+          useInstanceCache(_useInstanceCache), numThreads(_numThreads > 0 ? _numThreads : 1)
     {
 
 //        cout << "ITC07TestSet ctor" << endl;
@@ -33,54 +37,65 @@ public:
     // Overriden method
     virtual void load() override;
 
+    // Instance file of _instance in _benchmarksDir, _instance.exam or exam_comp__instance.exam,
+    // or "" if not found
+    static std::string findInstanceFile(std::string const& _benchmarksDir, std::string const& _instance);
+    // Find and load instance _instance of _benchmarksDir. Throws std::runtime_error on failure
+    static boost::shared_ptr<ITC2007TestSet> loadInstance(std::string const& _benchmarksDir,
+                                                          std::string const& _instance);
+
 protected:
     // Read exams and students
-    void readExams(boost::tokenizer<boost::escaped_list_separator<char> >::iterator& it,
-                   boost::tokenizer<boost::escaped_list_separator<char> > const& tok);
+    void readExams(ITC2007Parser &_parser);
     // Read periods
-    void readPeriods(boost::tokenizer<boost::escaped_list_separator<char> >::iterator& it,
-                     boost::tokenizer<boost::escaped_list_separator<char> > const& tok);
+    void readPeriods(ITC2007Parser &_parser);
     // Read rooms
-    void readRooms(boost::tokenizer<boost::escaped_list_separator<char> >::iterator& it,
-                   boost::tokenizer<boost::escaped_list_separator<char> > const& tok);
+    void readRooms(ITC2007Parser &_parser);
     // Read constraints and weightings
-    void readConstraints(boost::tokenizer<boost::escaped_list_separator<char> >::iterator& it,
-                         boost::tokenizer<boost::escaped_list_separator<char> > const& tok);
+    void readConstraints(ITC2007Parser &_parser);
 
 
     ///////////////////////////
     // Auxiliary methods
     ///////////////////////////
-    int matchPeriods(boost::tokenizer<boost::escaped_list_separator<char> >::iterator& it);
-    int matchPeriodSequenceLine(int _periodId, boost::tokenizer<boost::escaped_list_separator<char> >::iterator& _it,
-                                boost::shared_ptr<std::vector<boost::shared_ptr<ITC2007Period> > > &_periodVector);
+    void matchPeriodSequenceLine(int _periodId, ITC2007Parser &_parser,
+                                 boost::shared_ptr<std::vector<boost::shared_ptr<ITC2007Period> > > &_periodVector);
 
-    int matchRooms(boost::tokenizer<boost::escaped_list_separator<char> >::iterator& it);
-    int matchRoomSequenceLine(int _roomId, boost::tokenizer<boost::escaped_list_separator<char> >::iterator& _it,
-                              boost::shared_ptr<std::vector<boost::shared_ptr<Room> > > &_roomVector);
+    void matchRoomSequenceLine(int _roomId, ITC2007Parser &_parser,
+                               boost::shared_ptr<std::vector<boost::shared_ptr<Room> > > &_roomVector);
 
-    void readPeriodHardConstraints(boost::tokenizer<boost::escaped_list_separator<char> >::iterator& it,
+    void readPeriodHardConstraints(ITC2007Parser &_parser,
                                    std::vector<boost::shared_ptr<Constraint> > &hardConstraints);
-    bool readPeriodConstraint(boost::tokenizer<boost::escaped_list_separator<char> >::iterator& it,
+    bool readPeriodConstraint(ITC2007Parser &_parser,
                               std::vector<boost::shared_ptr<Constraint> >& hardConstraints);
 
-    void readRoomHardConstraints(boost::tokenizer<boost::escaped_list_separator<char> >::iterator& it,
-                                  std::vector<boost::shared_ptr<Constraint> >& hardConstraints);
-    bool readRoomConstraint(boost::tokenizer<boost::escaped_list_separator<char> >::iterator& it,
+    void readRoomHardConstraints(ITC2007Parser &_parser,
+                                 std::vector<boost::shared_ptr<Constraint> >& hardConstraints);
+    bool readRoomConstraint(ITC2007Parser &_parser,
                             std::vector<boost::shared_ptr<Constraint> >& hardConstraints);
 
-    void readInstitutionalWeightingsSoftConstraints(boost::tokenizer<boost::escaped_list_separator<char> >::iterator& it,
-                                                 InstitutionalModelWeightings &_model_weightings);
-    bool readInstitutionalWeightingsConstraint(boost::tokenizer<boost::escaped_list_separator<char> >::iterator& it,
-                                                 InstitutionalModelWeightings &_model_weightings);
+    void readInstitutionalWeightingsSoftConstraints(ITC2007Parser &_parser,
+                                                    InstitutionalModelWeightings &_model_weightings);
+    bool readInstitutionalWeightingsConstraint(ITC2007Parser &_parser,
+                                               InstitutionalModelWeightings &_model_weightings);
+
+    // Student -> exams index in compressed sparse row form. The exams of student s are
+    // exams[start[s]..start[s+1]). Student numbers without exams have empty ranges.
+    struct StudentEnrolments {
+        std::vector<int> start;
+        std::vector<int> exams;
+    };
+
+    void buildStudentIndex(ITC2007Parser &_parser, StudentEnrolments &_studentEnrolments);
 
-    void buildStudentMap(boost::tokenizer<boost::escaped_list_separator<char> >::iterator &_it,
-                         const boost::tokenizer<boost::escaped_list_separator<char> > &_tok,
-                         boost::unordered_map<int, std::vector<int> > & _studentMap);
+    void buildConflictMatrix(StudentEnrolments const& _studentEnrolments);
 
-    void buildConflictMatrix(boost::unordered_map<int, std::vector<int> > const& _studentMap);
+    void buildExamGraph(SparseIntMatrix const& _sparseConflictMatrix);
 
-    void buildExamGraph(const IntMatrix &conflictMatrix);
+    // Read and write the preprocessed instance cache
+    bool useInstanceCache;
+    // Number of threads building the conflict matrix
+    unsigned numThreads;
 
 };
 
@@ -0,0 +1,106 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <stdexcept>
+#include <cstddef>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+/**
+ * @brief The MappedFile class. Read-only memory mapping of a whole file.
+ */
+class MappedFile {
+
+public:
+    /**
+     * @brief MappedFile Map file _filename. Throws std::runtime_error on failure.
+     * @param _filename
+     */
+    inline MappedFile(std::string const &_filename);
+
+    /**
+     * @brief ~MappedFile Unmap the file
+     */
+    inline ~MappedFile();
+
+    MappedFile(MappedFile const &) = delete;
+    MappedFile &operator=(MappedFile const &) = delete;
+
+    /**
+     * @brief begin
+     * @return Pointer to the first byte of the file
+     */
+    inline char const *begin() const;
+
+    /**
+     * @brief end
+     * @return Pointer past the last byte of the file
+     */
+    inline char const *end() const;
+
+    /**
+     * @brief size
+     * @return File size in bytes
+     */
+    inline std::size_t size() const;
+
+protected:
+    // Mapped bytes (nullptr for an empty file)
+    char const *data;
+    // File size
+    std::size_t length;
+};
+
+
+
+MappedFile::MappedFile(std::string const &_filename) : data(nullptr), length(0) {
+    int fd = open(_filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("Couldn't open file: " + _filename);
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        throw std::runtime_error("Couldn't stat file: " + _filename);
+    }
+    length = st.st_size;
+    if (length > 0) {
+        void *addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("Couldn't map file: " + _filename);
+        }
+        // The file is read once, front to back
+        madvise(addr, length, MADV_SEQUENTIAL);
+        data = static_cast<char const *>(addr);
+    }
+    // The mapping stays valid after the descriptor is closed
+    close(fd);
+}
+
+
+MappedFile::~MappedFile() {
+    if (data != nullptr)
+        munmap(const_cast<char *>(data), length);
+}
+
+
+char const *MappedFile::begin() const {
+    return data;
+}
+
+
+char const *MappedFile::end() const {
+    return data + length;
+}
+
+
+std::size_t MappedFile::size() const {
+    return length;
+}
+
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,319 @@
+#ifndef MEMORYACCOUNTING_H
+#define MEMORYACCOUNTING_H
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <iostream>
+#include <iomanip>
+#include <cstddef>
+#include <boost/shared_ptr.hpp>
+
+
+//
+// Memory accounting of the major data structures, enabled by compiling with
+// -DETTP_MEMORY_ACCOUNTING (CMake option ETTP_MEMORY_ACCOUNTING). When disabled, the
+// structures don't register their footprint and the EAs don't report it; the footprint
+// of a structure can still be computed on demand (getMemoryFootprint).
+//
+
+
+/**
+ * @brief The MemoryAccounting class. Bytes allocated by the problem data and the solutions,
+ * per category of data structure.
+ *
+ * A Footprint holds the bytes of one or more structures, computed from the capacities of
+ * their containers (the heap blocks they own), so it is exact for vectors and an estimate
+ * for node based containers and shared counts. An Account registers the footprint of one
+ * structure in the process-wide current and peak bytes per category; the structure updates
+ * it at its sample points (construction, copy) and releases it on destruction. A Tracker
+ * follows the current and peak footprint of a set of structures, e.g. a population.
+ */
+class MemoryAccounting {
+
+public:
+    /**
+     * @brief The Category enum. Accounted data structures
+     */
+    enum Category {
+        // TimetableProblemData: dense and sparse conflict matrices
+        ConflictMatrix,
+        // TimetableProblemData: boost adjacency list and compact exam graph
+        ExamGraph,
+        // TimetableProblemData: exam, room and period vectors, class sizes, hard constraints
+        ProblemEntities,
+        // TimetableContainerMatrix: # exams x # periods ColumnMatrix
+        TimetableMatrix,
+        // TimetableContainerMatrix: (exam, room) tuples of each period
+        PeriodsExams,
+        // TimetableContainerMatrix: # exams of each period
+        PeriodsSizes,
+        // TimetableContainerMatrix: scheduled exams vector
+        ScheduledExams,
+        // TimetableContainerMatrix: scheduled rooms vector, with the occupation of each period
+        ScheduledRooms,
+        NumCategories
+    };
+
+    /**
+     * @brief The Footprint struct. Bytes per category
+     */
+    struct Footprint {
+        Footprint() {
+            for (auto &b : bytes)
+                b = 0;
+        }
+        Footprint &operator+=(Footprint const &_other) {
+            for (int c = 0; c < NumCategories; ++c)
+                bytes[c] += _other.bytes[c];
+            return *this;
+        }
+        std::size_t getTotal() const {
+            std::size_t total = 0;
+            for (auto b : bytes)
+                total += b;
+            return total;
+        }
+        std::size_t bytes[NumCategories];
+    };
+
+    /**
+     * @brief The Account class. Footprint of one structure registered in the process-wide
+     * accounting. Copies start empty: the copied structure registers its own footprint.
+     */
+    class Account {
+    public:
+        Account() { }
+        Account(Account const &) { }
+        Account &operator=(Account const &) { return *this; }
+        ~Account() { update(Footprint()); }
+        /**
+         * @brief update Replace the registered footprint by _footprint
+         * @param _footprint
+         */
+        void update(Footprint const &_footprint) {
+#ifdef ETTP_MEMORY_ACCOUNTING
+            for (int c = 0; c < NumCategories; ++c) {
+                if (_footprint.bytes[c] != footprint.bytes[c])
+                    MemoryAccounting::add((Category)c, (long long)_footprint.bytes[c] - (long long)footprint.bytes[c]);
+            }
+            footprint = _footprint;
+#else
+            (void)_footprint;
+#endif
+        }
+    private:
+#ifdef ETTP_MEMORY_ACCOUNTING
+        Footprint footprint;
+#endif
+    };
+
+    /**
+     * @brief The Tracker class. Current and peak footprint of a set of structures sampled
+     * at given points, e.g. a population at the end of every generation. The peak of each
+     * category and the peak total are tracked independently.
+     */
+    class Tracker {
+    public:
+        Tracker() : peakTotal(0) { }
+        /**
+         * @brief sample Set the current footprint
+         * @param _footprint
+         */
+        void sample(Footprint const &_footprint) {
+            current = _footprint;
+            for (int c = 0; c < NumCategories; ++c) {
+                if (current.bytes[c] > peak.bytes[c])
+                    peak.bytes[c] = current.bytes[c];
+            }
+            if (current.getTotal() > peakTotal)
+                peakTotal = current.getTotal();
+        }
+        Footprint const &getCurrent() const { return current; }
+        Footprint const &getPeak() const { return peak; }
+        std::size_t getPeakTotal() const { return peakTotal; }
+        /**
+         * @brief print Print the current and peak bytes per category
+         * @param _os
+         * @param _title
+         */
+        void print(std::ostream &_os, std::string const &_title) const {
+            MemoryAccounting::print(_os, _title, current, peak, peakTotal);
+        }
+    private:
+        Footprint current;
+        Footprint peak;
+        std::size_t peakTotal;
+    };
+
+    /**
+     * @brief isEnabled
+     * @return true if the structures register their footprint
+     */
+    static bool isEnabled() {
+#ifdef ETTP_MEMORY_ACCOUNTING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief getCurrent
+     * @return Bytes currently registered by the live structures
+     */
+    static Footprint getCurrent() {
+        Footprint footprint;
+        for (int c = 0; c < NumCategories; ++c)
+            footprint.bytes[c] = (std::size_t)getCounters().current[c].load(std::memory_order_relaxed);
+        return footprint;
+    }
+    /**
+     * @brief getPeak
+     * @return Peak of the registered bytes of each category
+     */
+    static Footprint getPeak() {
+        Footprint footprint;
+        for (int c = 0; c < NumCategories; ++c)
+            footprint.bytes[c] = (std::size_t)getCounters().peak[c].load(std::memory_order_relaxed);
+        return footprint;
+    }
+    /**
+     * @brief getPeakTotal
+     * @return Peak of the registered bytes of all categories
+     */
+    static std::size_t getPeakTotal() {
+        return (std::size_t)getCounters().peakTotal.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief printProcess Print the process-wide current and peak bytes per category
+     * @param _os
+     */
+    static void printProcess(std::ostream &_os) {
+        print(_os, "Memory accounting (all live structures)", getCurrent(), getPeak(), getPeakTotal());
+    }
+
+    /**
+     * @brief print Print a current and a peak footprint, one line per category
+     * @param _os
+     * @param _title
+     * @param _current
+     * @param _peak
+     * @param _peakTotal
+     */
+    static void print(std::ostream &_os, std::string const &_title, Footprint const &_current,
+                      Footprint const &_peak, std::size_t _peakTotal) {
+        std::ios::fmtflags flags = _os.flags();
+        std::streamsize precision = _os.precision();
+        _os << _title << std::endl;
+        _os << "  " << std::left << std::setw(18) << "Category" << std::right
+            << std::setw(14) << "Current (KiB)" << std::setw(14) << "Peak (KiB)" << std::setw(10) << "Share" << std::endl;
+        std::size_t total = _current.getTotal();
+        _os << std::fixed << std::setprecision(1);
+        for (int c = 0; c < NumCategories; ++c) {
+            if (_current.bytes[c] == 0 && _peak.bytes[c] == 0)
+                continue;
+            _os << "  " << std::left << std::setw(18) << getCategoryName((Category)c) << std::right
+                << std::setw(14) << toKiB(_current.bytes[c]) << std::setw(14) << toKiB(_peak.bytes[c])
+                << std::setw(9) << (total ? 100.0 * _current.bytes[c] / total : 0.0) << "%" << std::endl;
+        }
+        _os << "  " << std::left << std::setw(18) << "Total" << std::right
+            << std::setw(14) << toKiB(total) << std::setw(14) << toKiB(_peakTotal) << std::endl;
+        _os.flags(flags);
+        _os.precision(precision);
+    }
+
+    /**
+     * @brief getCategoryName
+     * @param _category
+     * @return
+     */
+    static char const *getCategoryName(Category _category) {
+        static char const *names[NumCategories] = {
+            "conflict matrix", "exam graph", "problem entities",
+            "timetable matrix", "periods exams", "periods sizes", "scheduled exams", "scheduled rooms"
+        };
+        return names[_category];
+    }
+
+    //
+    // Bytes owned by standard containers
+    //
+    /**
+     * @brief vectorBytes
+     * @param _vector
+     * @return Bytes of the _vector buffer
+     */
+    template <typename T>
+    static std::size_t vectorBytes(std::vector<T> const &_vector) {
+        return _vector.capacity() * sizeof(T);
+    }
+    /**
+     * @brief nestedVectorBytes
+     * @param _vector
+     * @return Bytes of the _vector buffer and of the buffers of its elements
+     */
+    template <typename T>
+    static std::size_t nestedVectorBytes(std::vector<std::vector<T> > const &_vector) {
+        std::size_t bytes = vectorBytes(_vector);
+        for (auto const &v : _vector)
+            bytes += vectorBytes(v);
+        return bytes;
+    }
+    /**
+     * @brief sharedVectorBytes
+     * @param _vector
+     * @return Bytes of the _vector buffer, of the pointed objects and of their shared counts
+     */
+    template <typename T>
+    static std::size_t sharedVectorBytes(std::vector<boost::shared_ptr<T> > const &_vector) {
+        return vectorBytes(_vector) + _vector.size() * (sizeof(T) + sharedCountBytes);
+    }
+
+protected:
+    // Estimated size of a shared_ptr control block (use and weak counts, vtable, pointer)
+    static const std::size_t sharedCountBytes = 2 * sizeof(int) + 2 * sizeof(void *);
+
+    struct Counters {
+        Counters() : peakTotal(0), currentTotal(0) {
+            for (int c = 0; c < NumCategories; ++c) {
+                current[c] = 0;
+                peak[c] = 0;
+            }
+        }
+        std::atomic<long long> current[NumCategories];
+        std::atomic<long long> peak[NumCategories];
+        std::atomic<long long> peakTotal;
+        std::atomic<long long> currentTotal;
+    };
+
+    static Counters &getCounters() {
+        static Counters counters;
+        return counters;
+    }
+
+    /**
+     * @brief add Add _delta bytes to _category and update the peaks
+     */
+    static void add(Category _category, long long _delta) {
+        Counters &counters = getCounters();
+        long long value = counters.current[_category].fetch_add(_delta, std::memory_order_relaxed) + _delta;
+        updatePeak(counters.peak[_category], value);
+        long long total = counters.currentTotal.fetch_add(_delta, std::memory_order_relaxed) + _delta;
+        updatePeak(counters.peakTotal, total);
+    }
+
+    static void updatePeak(std::atomic<long long> &_peak, long long _value) {
+        long long peak = _peak.load(std::memory_order_relaxed);
+        while (_value > peak && !_peak.compare_exchange_weak(peak, _value, std::memory_order_relaxed))
+            ;
+    }
+
+    static double toKiB(std::size_t _bytes) {
+        return _bytes / 1024.0;
+    }
+};
+
+
+#endif // MEMORYACCOUNTING_H
@@ -0,0 +1,340 @@
+#ifndef MOVELOG_H
+#define MOVELOG_H
+
+#include <string>
+#include <memory>
+#include <iostream>
+#include <stdexcept>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include "utils/MappedFile.h"
+
+
+/**
+ * @brief The MoveRecord struct. One iteration of a local search: the Kempe chain move
+ * built, the cost of the neighbour and the outcome.
+ */
+struct MoveRecord {
+    // Selected exam, with its source and destination period and room. Room moves have
+    // sourcePeriod == destPeriod.
+    int32_t exam;
+    int32_t sourcePeriod;
+    int32_t destPeriod;
+    int32_t sourceRoom;
+    // Destination room of the selected exam, -1 if the neighbour is infeasible
+    int32_t destRoom;
+    // 1 if the neighbour is feasible
+    int32_t feasible;
+    // Neighbour cost, -1 if the neighbour is infeasible
+    int64_t neighbourCost;
+    // 1 if the move was applied
+    int32_t accepted;
+    int32_t padding;
+    // Cost of the current solution after the iteration
+    int64_t cost;
+
+    bool operator==(MoveRecord const &_other) const {
+        return exam == _other.exam && sourcePeriod == _other.sourcePeriod && destPeriod == _other.destPeriod &&
+                sourceRoom == _other.sourceRoom && destRoom == _other.destRoom && feasible == _other.feasible &&
+                neighbourCost == _other.neighbourCost && accepted == _other.accepted && cost == _other.cost;
+    }
+    bool operator!=(MoveRecord const &_other) const { return !(*this == _other); }
+};
+
+
+/**
+ * @brief The MoveLog class. Deterministic record and replay of a seeded local search.
+ *
+ * In Record mode, every iteration of the search is appended to a binary log: the move
+ * the Kempe chain heuristic built from the random generator, the cost the incremental
+ * evaluator computed for the neighbour, whether the move was accepted and the resulting
+ * cost. In Replay mode the same seeded run, e.g. built from a later revision, is compared
+ * iteration by iteration with the log, and the first divergence is kept: a different move
+ * means the random generator is consumed differently, the same move with a different
+ * cost means the evaluation changed.
+ *
+ * The log is a Header, holding the RunInfo needed to repeat the run, followed by fixed
+ * size MoveRecords in native byte order.
+ */
+class MoveLog {
+
+public:
+    /**
+     * @brief The RunInfo struct. Parameters of the recorded run
+     */
+    struct RunInfo {
+        // Random generator seed
+        uint64_t seed;
+        // Instance hash (see TimetableProblemData::getInstanceHash)
+        uint64_t instanceHash;
+        // Cooling schedule
+        double initT;
+        double alpha;
+        double span;
+        double finalT;
+        // Algorithm and instance names, zero terminated
+        char algorithm[16];
+        char instance[64];
+    };
+
+    /**
+     * @brief The Mode enum
+     */
+    enum Mode { Record, Replay };
+
+    /**
+     * @brief MoveLog Create log _filename and record a run.
+     * Throws std::runtime_error if the file can't be created.
+     * @param _filename
+     * @param _runInfo
+     */
+    inline MoveLog(std::string const &_filename, RunInfo const &_runInfo);
+    /**
+     * @brief MoveLog Open log _filename and replay the run it holds.
+     * Throws std::runtime_error if the file isn't a move log.
+     * @param _filename
+     */
+    inline explicit MoveLog(std::string const &_filename);
+
+    inline ~MoveLog();
+
+    MoveLog(MoveLog const &) = delete;
+    MoveLog &operator=(MoveLog const &) = delete;
+
+    /**
+     * @brief makeRecord
+     * @param _neighbor Neighbour evaluated in the iteration (ETTPneighbor)
+     * @param _solution Current solution after the iteration
+     * @param _accepted true if the move was applied
+     * @return Record of the iteration
+     */
+    template <typename Neighbor, typename EOT>
+    static MoveRecord makeRecord(Neighbor &_neighbor, EOT const &_solution, bool _accepted);
+
+    /**
+     * @brief move Record the next iteration, or compare it with the log
+     * @param _record
+     */
+    inline void move(MoveRecord const &_record);
+    /**
+     * @brief finish End of the run. In Replay mode, a run shorter than the log diverges.
+     */
+    inline void finish();
+
+    /**
+     * @brief getMode
+     * @return
+     */
+    Mode getMode() const { return mode; }
+    /**
+     * @brief getRunInfo
+     * @return
+     */
+    RunInfo const &getRunInfo() const { return header.runInfo; }
+    /**
+     * @brief getNumMoves
+     * @return # iterations recorded or compared
+     */
+    uint64_t getNumMoves() const { return numMoves; }
+    /**
+     * @brief getNumRecords
+     * @return # records of the log being replayed
+     */
+    uint64_t getNumRecords() const { return numRecords; }
+    /**
+     * @brief hasDiverged
+     * @return true if the replayed run differs from the log
+     */
+    bool hasDiverged() const { return diverged; }
+
+    /**
+     * @brief printDivergence Print the first divergence, if any
+     * @param _os
+     */
+    inline void printDivergence(std::ostream &_os) const;
+    /**
+     * @brief print Print _record on one line
+     * @param _os
+     * @param _record
+     */
+    inline static void print(std::ostream &_os, MoveRecord const &_record);
+
+protected:
+    // Log format version. Increment whenever the layout changes.
+    static const uint32_t VERSION = 1;
+
+    /**
+     * @brief The Header struct
+     */
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t recordSize;
+        RunInfo runInfo;
+    };
+
+    std::string filename;
+    Mode mode;
+    Header header;
+    // Record mode
+    FILE *file;
+    // Replay mode
+    std::unique_ptr<MappedFile> mappedFile;
+    MoveRecord const *records;
+    uint64_t numRecords;
+    // # iterations recorded or compared
+    uint64_t numMoves;
+    // First divergence: iteration, and the logged and replayed records if they exist
+    bool diverged;
+    uint64_t divergenceIndex;
+    bool hasLogged;
+    bool hasReplayed;
+    MoveRecord logged;
+    MoveRecord replayed;
+};
+
+
+
+MoveLog::MoveLog(std::string const &_filename, RunInfo const &_runInfo)
+    : filename(_filename), mode(Record), file(nullptr), records(nullptr), numRecords(0), numMoves(0),
+      diverged(false), divergenceIndex(0), hasLogged(false), hasReplayed(false) {
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "ETTPMLOG", sizeof(header.magic));
+    header.version = VERSION;
+    header.recordSize = sizeof(MoveRecord);
+    header.runInfo = _runInfo;
+    header.runInfo.algorithm[sizeof(header.runInfo.algorithm)-1] = '\0';
+    header.runInfo.instance[sizeof(header.runInfo.instance)-1] = '\0';
+    file = fopen(filename.c_str(), "wb");
+    if (file == nullptr)
+        throw std::runtime_error(filename + ": can't create the move log");
+    if (fwrite(&header, sizeof(header), 1, file) != 1) {
+        fclose(file);
+        throw std::runtime_error(filename + ": can't write the move log");
+    }
+}
+
+
+MoveLog::MoveLog(std::string const &_filename)
+    : filename(_filename), mode(Replay), file(nullptr), records(nullptr), numRecords(0), numMoves(0),
+      diverged(false), divergenceIndex(0), hasLogged(false), hasReplayed(false) {
+    mappedFile.reset(new MappedFile(filename));
+    if (mappedFile->size() < sizeof(Header))
+        throw std::runtime_error(filename + ": not a move log");
+    memcpy(&header, mappedFile->begin(), sizeof(Header));
+    if (memcmp(header.magic, "ETTPMLOG", sizeof(header.magic)) != 0)
+        throw std::runtime_error(filename + ": not a move log");
+    if (header.version != VERSION || header.recordSize != sizeof(MoveRecord))
+        throw std::runtime_error(filename + ": unsupported move log version " + std::to_string(header.version));
+    if ((mappedFile->size() - sizeof(Header)) % sizeof(MoveRecord) != 0)
+        throw std::runtime_error(filename + ": truncated move log");
+    records = reinterpret_cast<MoveRecord const *>(mappedFile->begin() + sizeof(Header));
+    numRecords = (mappedFile->size() - sizeof(Header)) / sizeof(MoveRecord);
+}
+
+
+MoveLog::~MoveLog() {
+    if (file)
+        fclose(file);
+}
+
+
+template <typename Neighbor, typename EOT>
+MoveRecord MoveLog::makeRecord(Neighbor &_neighbor, EOT const &_solution, bool _accepted) {
+    auto const &kempeChain = _neighbor.getKempeChain();
+    MoveRecord record;
+    memset(&record, 0, sizeof(record));
+    record.exam = kempeChain.getEi();
+    record.sourcePeriod = kempeChain.getTi();
+    record.destPeriod = kempeChain.getTj();
+    record.sourceRoom = kempeChain.getRi();
+    record.feasible = _neighbor.isFeasible();
+    // The destination room and the neighbour cost are only set for feasible neighbours
+    record.destRoom = record.feasible ? kempeChain.getRj() : -1;
+    record.neighbourCost = record.feasible ? _neighbor.getSolutionCost() : -1;
+    record.accepted = _accepted;
+    record.cost = _solution.getSolutionCost();
+    return record;
+}
+
+
+void MoveLog::move(MoveRecord const &_record) {
+    if (mode == Record) {
+        if (fwrite(&_record, sizeof(MoveRecord), 1, file) != 1)
+            throw std::runtime_error(filename + ": can't write the move log");
+    }
+    else if (!diverged) {
+        bool logEnded = numMoves >= numRecords;
+        if (logEnded || records[numMoves] != _record) {
+            diverged = true;
+            divergenceIndex = numMoves;
+            hasLogged = !logEnded;
+            if (hasLogged)
+                logged = records[numMoves];
+            hasReplayed = true;
+            replayed = _record;
+        }
+    }
+    ++numMoves;
+}
+
+
+void MoveLog::finish() {
+    if (mode == Record) {
+        if (fflush(file) != 0)
+            throw std::runtime_error(filename + ": can't write the move log");
+    }
+    else if (!diverged && numMoves < numRecords) {
+        diverged = true;
+        divergenceIndex = numMoves;
+        hasLogged = true;
+        logged = records[numMoves];
+        hasReplayed = false;
+    }
+}
+
+
+void MoveLog::printDivergence(std::ostream &_os) const {
+    if (!diverged) {
+        _os << "No divergence in " << numMoves << " iterations" << std::endl;
+        return;
+    }
+    _os << "First divergence at iteration " << divergenceIndex << std::endl;
+    _os << "  logged:   ";
+    if (hasLogged)
+        print(_os, logged);
+    else
+        _os << "(end of the log, " << numRecords << " iterations)" << std::endl;
+    _os << "  replayed: ";
+    if (hasReplayed)
+        print(_os, replayed);
+    else
+        _os << "(end of the run, " << numMoves << " iterations)" << std::endl;
+    if (hasLogged && hasReplayed) {
+        bool sameMove = logged.exam == replayed.exam && logged.sourcePeriod == replayed.sourcePeriod &&
+                logged.destPeriod == replayed.destPeriod && logged.sourceRoom == replayed.sourceRoom &&
+                logged.destRoom == replayed.destRoom && logged.feasible == replayed.feasible;
+        if (!sameMove)
+            _os << "  The moves differ: the random generator was consumed differently" << std::endl;
+        else if (logged.neighbourCost != replayed.neighbourCost)
+            _os << "  Same move, different neighbour cost: the evaluation changed" << std::endl;
+        else
+            _os << "  Same move and neighbour cost, different outcome: the acceptance changed" << std::endl;
+    }
+}
+
+
+void MoveLog::print(std::ostream &_os, MoveRecord const &_record) {
+    _os << (_record.sourcePeriod == _record.destPeriod ? "room move" : "shift move")
+        << " exam " << _record.exam << ": period " << _record.sourcePeriod << " -> " << _record.destPeriod
+        << ", room " << _record.sourceRoom << " -> " << _record.destRoom;
+    if (_record.feasible)
+        _os << ", neighbour cost " << _record.neighbourCost;
+    else
+        _os << ", infeasible";
+    _os << (_record.accepted ? ", accepted" : ", rejected") << ", cost " << _record.cost << std::endl;
+}
+
+
+#endif // MOVELOG_H
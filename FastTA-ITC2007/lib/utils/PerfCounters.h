@@ -0,0 +1,405 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <string>
+#include <thread>
+#include <stdexcept>
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+//
+// Hardware performance counters per phase of a run, enabled by compiling with
+// -DETTP_PERF_COUNTERS (CMake option ETTP_PERF_COUNTERS). When disabled, the scopes
+// placed in ETTPKempeChainHeuristic, eoChromosome and the main application expand
+// to nothing.
+//
+#ifdef ETTP_PERF_COUNTERS
+#define ETTP_PERF_SCOPE(_phase) PerfProfiler::Scope perfScope(PerfProfiler::getCurrent(), PerfProfiler::_phase)
+#else
+#define ETTP_PERF_SCOPE(_phase) do { } while (0)
+#endif
+
+
+/**
+ * @brief The PerfCounters class. Group of Linux perf_event_open hardware counters
+ * (cycles, instructions, L1 data cache read misses, last level cache misses and branch
+ * misses) counting the user space execution of the calling thread.
+ *
+ * Events the processor (or the hypervisor) doesn't support are left out of the group.
+ * If no event can be opened, e.g. with kernel.perf_event_paranoid > 2, isOpen() is false
+ * and getError() tells why.
+ */
+class PerfCounters {
+
+public:
+    /**
+     * @brief The Event enum. Counted events
+     */
+    enum Event { Cycles, Instructions, L1DMisses, LLCMisses, BranchMisses, NumEvents };
+
+    /**
+     * @brief The Sample struct. Counter values at one point in time
+     */
+    struct Sample {
+        uint64_t values[NumEvents];
+        // Time the group was enabled and running (they differ if the group was multiplexed)
+        uint64_t timeEnabled;
+        uint64_t timeRunning;
+    };
+
+    /**
+     * @brief PerfCounters Open the counters of the calling thread
+     */
+    inline PerfCounters();
+    /**
+     * @brief ~PerfCounters Close the counters
+     */
+    inline ~PerfCounters();
+
+    PerfCounters(PerfCounters const &) = delete;
+    PerfCounters &operator=(PerfCounters const &) = delete;
+
+    /**
+     * @brief isOpen
+     * @return true if at least one event is counted
+     */
+    bool isOpen() const { return numGroupEvents > 0; }
+    /**
+     * @brief hasEvent
+     * @param _event
+     * @return true if _event is counted
+     */
+    bool hasEvent(Event _event) const { return eventIndex[_event] >= 0; }
+    /**
+     * @brief getError
+     * @return Why the events that couldn't be opened failed
+     */
+    std::string const &getError() const { return error; }
+
+    /**
+     * @brief read Read the counters; the events that aren't counted read 0.
+     * Must be called from the thread that created the counters.
+     * @param _sample
+     */
+    inline void read(Sample &_sample) const;
+
+    /**
+     * @brief getEventName
+     * @param _event
+     * @return
+     */
+    static char const *getEventName(Event _event) {
+        static char const *names[NumEvents] = { "cycles", "instructions", "L1D misses", "LLC misses", "branch misses" };
+        return names[_event];
+    }
+
+protected:
+    // Group leader file descriptor, -1 if no event could be opened
+    int leader;
+    // Events of the group, in the order the kernel reports them
+    int fds[NumEvents];
+    int numGroupEvents;
+    // eventIndex[e] = position of event e in the group, -1 if not counted
+    int eventIndex[NumEvents];
+    std::string error;
+};
+
+
+/**
+ * @brief The PerfProfiler class. Attributes the hardware counters to the phases of a run:
+ * instance load, solution initialisation, Kempe chain move building, delta evaluation,
+ * move application and solution copy.
+ *
+ * A phase is measured by reading the counters at the start and at the end of a Scope;
+ * the cost of a pair of reads is calibrated at construction and subtracted. Scopes are
+ * inclusive: a copy made during initialisation counts in both phases. The counters only
+ * count the thread that created the profiler, so scopes only measure on the thread where
+ * the profiler is active (see Activation); on other threads they do nothing.
+ */
+class PerfProfiler {
+
+public:
+    /**
+     * @brief The Phase enum. Profiled phases
+     */
+    enum Phase { Load, Init, Build, Evaluate, Apply, Copy, NumPhases };
+
+    /**
+     * @brief The Scope class. Adds the counts of its lifetime to a phase
+     */
+    class Scope {
+    public:
+        Scope(PerfProfiler *_profiler, Phase _phase) : profiler(_profiler), phase(_phase) {
+            if (profiler)
+                profiler->counters.read(start);
+        }
+        ~Scope() {
+            if (profiler) {
+                PerfCounters::Sample end;
+                profiler->counters.read(end);
+                profiler->add(phase, start, end);
+            }
+        }
+    private:
+        PerfProfiler *profiler;
+        Phase phase;
+        PerfCounters::Sample start;
+    };
+
+    /**
+     * @brief The Activation class. Makes a profiler the current one of the calling thread
+     * during its lifetime
+     */
+    class Activation {
+    public:
+        explicit Activation(PerfProfiler *_profiler) : previous(current()) {
+            if (_profiler && _profiler->owner != std::this_thread::get_id())
+                throw std::runtime_error("PerfProfiler: a profiler can only be activated on the thread that created it");
+            current() = (_profiler && _profiler->isAvailable()) ? _profiler : nullptr;
+        }
+        ~Activation() { current() = previous; }
+        Activation(Activation const &) = delete;
+        Activation &operator=(Activation const &) = delete;
+    private:
+        PerfProfiler *previous;
+    };
+
+    /**
+     * @brief PerfProfiler Open the counters of the calling thread and calibrate the cost of a scope
+     */
+    inline PerfProfiler();
+
+    /**
+     * @brief isEnabled
+     * @return true if the profiling scopes are compiled in
+     */
+    static bool isEnabled() {
+#ifdef ETTP_PERF_COUNTERS
+        return true;
+#else
+        return false;
+#endif
+    }
+    /**
+     * @brief getCurrent
+     * @return The profiler active on the calling thread, or nullptr
+     */
+    static PerfProfiler *getCurrent() { return current(); }
+
+    /**
+     * @brief isAvailable
+     * @return true if the counters could be opened
+     */
+    bool isAvailable() const { return counters.isOpen(); }
+
+    /**
+     * @brief print Print the counts per phase, IPC and misses per move. A move is one
+     * delta evaluation; the per move figures cover building, evaluating and applying moves.
+     * @param _os
+     */
+    inline void print(std::ostream &_os) const;
+
+protected:
+    static PerfProfiler *&current() {
+        static thread_local PerfProfiler *profiler = nullptr;
+        return profiler;
+    }
+
+    /**
+     * @brief add Add the counts between _start and _end to _phase
+     */
+    void add(Phase _phase, PerfCounters::Sample const &_start, PerfCounters::Sample const &_end) {
+        PhaseCounters &phase = phases[_phase];
+        ++phase.calls;
+        for (int e = 0; e < PerfCounters::NumEvents; ++e)
+            phase.values[e] += _end.values[e] - _start.values[e];
+        timeEnabled += _end.timeEnabled - _start.timeEnabled;
+        timeRunning += _end.timeRunning - _start.timeRunning;
+    }
+
+    struct PhaseCounters {
+        uint64_t calls;
+        uint64_t values[PerfCounters::NumEvents];
+    };
+
+    PerfCounters counters;
+    std::thread::id owner;
+    PhaseCounters phases[NumPhases];
+    // Mean counts of an empty scope
+    double overhead[PerfCounters::NumEvents];
+    // Time the counters were enabled and running inside scopes
+    uint64_t timeEnabled;
+    uint64_t timeRunning;
+};
+
+
+
+PerfCounters::PerfCounters() : leader(-1), numGroupEvents(0) {
+    for (int e = 0; e < NumEvents; ++e) {
+        fds[e] = -1;
+        eventIndex[e] = -1;
+    }
+#ifdef __linux__
+    static const uint32_t types[NumEvents] = {
+        PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE
+    };
+    static const uint64_t configs[NumEvents] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+    for (int e = 0; e < NumEvents; ++e) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = types[e];
+        attr.config = configs[e];
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        // Calling thread, any CPU
+        int fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);
+        if (fd < 0) {
+            error += std::string(error.empty() ? "" : "; ") + getEventName((Event)e) + ": " + strerror(errno);
+            continue;
+        }
+        if (leader < 0)
+            leader = fd;
+        fds[numGroupEvents] = fd;
+        eventIndex[e] = numGroupEvents++;
+    }
+#else
+    error = "perf_event_open is only available on Linux";
+#endif
+}
+
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (int i = 0; i < numGroupEvents; ++i)
+        close(fds[i]);
+#endif
+}
+
+
+void PerfCounters::read(Sample &_sample) const {
+    memset(&_sample, 0, sizeof(_sample));
+#ifdef __linux__
+    if (leader < 0)
+        return;
+    // PERF_FORMAT_GROUP layout: nr, time_enabled, time_running, values[nr]
+    uint64_t buffer[3 + NumEvents];
+    if (::read(leader, buffer, sizeof(buffer)) < (ssize_t)(3 * sizeof(uint64_t)))
+        return;
+    _sample.timeEnabled = buffer[1];
+    _sample.timeRunning = buffer[2];
+    for (int e = 0; e < NumEvents; ++e) {
+        if (eventIndex[e] >= 0 && (uint64_t)eventIndex[e] < buffer[0])
+            _sample.values[e] = buffer[3 + eventIndex[e]];
+    }
+#endif
+}
+
+
+
+PerfProfiler::PerfProfiler() : owner(std::this_thread::get_id()), timeEnabled(0), timeRunning(0) {
+    for (auto &phase : phases)
+        phase = PhaseCounters();
+    for (auto &value : overhead)
+        value = 0;
+    if (!isAvailable())
+        return;
+    // Calibrate the cost of an empty scope
+    const int numCalibrationScopes = 1000;
+    PerfCounters::Sample start, end;
+    for (int i = 0; i < numCalibrationScopes; ++i) {
+        counters.read(start);
+        counters.read(end);
+        for (int e = 0; e < PerfCounters::NumEvents; ++e)
+            overhead[e] += end.values[e] - start.values[e];
+    }
+    for (auto &value : overhead)
+        value /= numCalibrationScopes;
+}
+
+
+void PerfProfiler::print(std::ostream &_os) const {
+    static char const *phaseNames[NumPhases] = { "Load", "Init", "Build", "Evaluate", "Apply", "Copy" };
+    if (!isAvailable()) {
+        _os << "Hardware counters unavailable: " << counters.getError() << std::endl;
+        return;
+    }
+    // Counts of a phase without the scope overhead
+    auto count = [&](PhaseCounters const &_phase, int _event) {
+        double value = _phase.values[_event] - _phase.calls * overhead[_event];
+        return value > 0 ? value : 0.0;
+    };
+    auto ratio = [](double _n, double _d) { return _d > 0 ? _n / _d : 0.0; };
+    auto flags = _os.flags();
+    auto precision = _os.precision();
+    _os << std::fixed << std::setprecision(2);
+    _os << "Hardware counters (user space)" << std::endl;
+    if (!counters.getError().empty())
+        _os << "  Not counted: " << counters.getError() << std::endl;
+    if (timeRunning < timeEnabled)
+        _os << "  Counters multiplexed, running " << 100.0 * ratio(timeRunning, timeEnabled)
+            << "% of the time: counts are underestimated" << std::endl;
+    _os << "  " << std::left << std::setw(10) << "Phase" << std::right << std::setw(12) << "Calls";
+    for (int e = 0; e < PerfCounters::NumEvents; ++e)
+        _os << std::setw(16) << PerfCounters::getEventName((PerfCounters::Event)e);
+    _os << std::setw(8) << "IPC" << std::endl;
+    for (int p = 0; p < NumPhases; ++p) {
+        PhaseCounters const &phase = phases[p];
+        if (phase.calls == 0)
+            continue;
+        _os << "  " << std::left << std::setw(10) << phaseNames[p] << std::right << std::setw(12) << phase.calls;
+        for (int e = 0; e < PerfCounters::NumEvents; ++e) {
+            if (counters.hasEvent((PerfCounters::Event)e))
+                _os << std::setw(16) << std::setprecision(0) << count(phase, e);
+            else
+                _os << std::setw(16) << "-";
+        }
+        _os << std::setw(8) << std::setprecision(2)
+            << ratio(count(phase, PerfCounters::Instructions), count(phase, PerfCounters::Cycles)) << std::endl;
+    }
+    // Per move: build + evaluate + apply over the # delta evaluations
+    double numMoves = phases[Evaluate].calls;
+    if (numMoves > 0) {
+        double totals[PerfCounters::NumEvents];
+        for (int e = 0; e < PerfCounters::NumEvents; ++e)
+            totals[e] = count(phases[Build], e) + count(phases[Evaluate], e) + count(phases[Apply], e);
+        _os << "  Per move (build + evaluate + apply, " << (uint64_t)numMoves << " moves):" << std::endl;
+        for (int e = 0; e < PerfCounters::NumEvents; ++e) {
+            if (counters.hasEvent((PerfCounters::Event)e))
+                _os << "    " << std::left << std::setw(16) << PerfCounters::getEventName((PerfCounters::Event)e)
+                    << std::right << std::setw(14) << totals[e] / numMoves << std::endl;
+        }
+        _os << "    " << std::left << std::setw(16) << "IPC" << std::right << std::setw(14)
+            << ratio(totals[PerfCounters::Instructions], totals[PerfCounters::Cycles]) << std::endl;
+        // Misses per thousand instructions
+        for (int e : { PerfCounters::L1DMisses, PerfCounters::LLCMisses, PerfCounters::BranchMisses }) {
+            if (counters.hasEvent((PerfCounters::Event)e) && counters.hasEvent(PerfCounters::Instructions))
+                _os << "    " << std::left << std::setw(16)
+                    << (std::string(PerfCounters::getEventName((PerfCounters::Event)e)) + " PKI")
+                    << std::right << std::setw(14) << 1000 * ratio(totals[e], totals[PerfCounters::Instructions])
+                    << std::endl;
+        }
+    }
+    _os.flags(flags);
+    _os.precision(precision);
+}
+
+
+#endif // PERFCOUNTERS_H
@@ -0,0 +1,274 @@
+#ifndef SEARCHTELEMETRY_H
+#define SEARCHTELEMETRY_H
+
+#include <vector>
+#include <map>
+#include <chrono>
+#include <cmath>
+#include <climits>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+
+
+//
+// Search telemetry counters, enabled by compiling with -DETTP_TELEMETRY (CMake option
+// ETTP_TELEMETRY). When disabled, the hooks placed in the explorers and in
+// ETTPKempeChainHeuristic expand to nothing.
+//
+#ifdef ETTP_TELEMETRY
+#define ETTP_TELEMETRY_HOOK(_telemetry, _call) do { if (_telemetry) (_telemetry)->_call; } while (0)
+#define ETTP_TELEMETRY_TIMER(_telemetry, _phase) \
+    SearchTelemetry::Timer telemetryTimer((_telemetry), SearchTelemetry::_phase)
+#else
+#define ETTP_TELEMETRY_HOOK(_telemetry, _call) do { } while (0)
+#define ETTP_TELEMETRY_TIMER(_telemetry, _phase) do { } while (0)
+#endif
+
+
+/**
+ * @brief The SearchTelemetry class. Throughput and operator counters of one local search:
+ * accepted, rejected and infeasible moves per threshold (thresholds are binned on a
+ * logarithmic scale), built/infeasible/accepted moves per operator, Kempe chain length
+ * of the shift moves and time spent building, evaluating and applying moves.
+ *
+ * The explorer and the Kempe chain heuristic of a search share one instance, which
+ * isn't thread safe.
+ */
+class SearchTelemetry {
+
+public:
+    /**
+     * @brief The Move enum. Move operators of ETTPKempeChainHeuristic
+     */
+    enum Move { RoomMove, ShiftMove, NumMoves };
+    /**
+     * @brief The Phase enum. Timed phases of a move
+     */
+    enum Phase { Build, Evaluate, Apply, NumPhases };
+
+    /**
+     * @brief The Timer class. Adds the lifetime of the timer to a phase
+     */
+    class Timer {
+    public:
+        Timer(SearchTelemetry *_telemetry, Phase _phase) : telemetry(_telemetry), phase(_phase) {
+            if (telemetry)
+                start = Clock::now();
+        }
+        ~Timer() {
+            if (telemetry)
+                telemetry->addTime(phase, std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+        }
+    private:
+        SearchTelemetry *telemetry;
+        Phase phase;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    /**
+     * @brief SearchTelemetry Constructor
+     * @param _binsPerDecade # threshold bins per decade
+     */
+    explicit SearchTelemetry(int _binsPerDecade = 10)
+        : binsPerDecade(_binsPerDecade), currentBinIndex(INT_MIN), currentBin(nullptr),
+          lastMove(ShiftMove), seconds(0) {
+        for (auto &counters : moves)
+            counters = MoveCounters();
+        for (auto &phase : phases)
+            phase = PhaseCounters();
+        setThreshold(0);
+    }
+
+    /**
+     * @brief isEnabled
+     * @return true if the telemetry hooks are compiled in
+     */
+    static bool isEnabled() {
+#ifdef ETTP_TELEMETRY
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    //
+    // Explorer hooks
+    //
+    /**
+     * @brief start Search start
+     */
+    void start() { startTime = Clock::now(); }
+    /**
+     * @brief stop Search end
+     */
+    void stop() { seconds += std::chrono::duration<double>(Clock::now() - startTime).count(); }
+    /**
+     * @brief setThreshold Current threshold (TA), temperature (SA) or level (GDA)
+     * @param _threshold
+     */
+    void setThreshold(double _threshold) {
+        int index = (_threshold > 0) ? (int)std::floor(std::log10(_threshold) * binsPerDecade) : INT_MIN;
+        if (index != currentBinIndex || currentBin == nullptr) {
+            currentBinIndex = index;
+            currentBin = &thresholdBins[index];
+        }
+    }
+    /**
+     * @brief moveInfeasible The last move was rejected because the neighbour is infeasible
+     */
+    void moveInfeasible() {
+        ++currentBin->infeasible;
+        ++moves[lastMove].infeasible;
+    }
+    /**
+     * @brief moveDone Outcome of the last move
+     * @param _accepted
+     */
+    void moveDone(bool _accepted) {
+        if (_accepted) {
+            ++currentBin->accepted;
+            ++moves[lastMove].accepted;
+        }
+        else
+            ++currentBin->rejected;
+    }
+
+    //
+    // ETTPKempeChainHeuristic hooks
+    //
+    /**
+     * @brief moveBuilt A move of operator _move was built
+     * @param _move
+     */
+    void moveBuilt(Move _move) {
+        lastMove = _move;
+        ++moves[_move].built;
+    }
+    /**
+     * @brief chainLength Exams moved by a shift move
+     * @param _numExams
+     */
+    void chainLength(std::size_t _numExams) {
+        if (_numExams >= chainLengths.size())
+            chainLengths.resize(_numExams+1, 0);
+        ++chainLengths[_numExams];
+    }
+    /**
+     * @brief addTime
+     * @param _phase
+     * @param _ns Nanoseconds
+     */
+    void addTime(Phase _phase, double _ns) {
+        phases[_phase].ns += _ns;
+        ++phases[_phase].calls;
+    }
+
+    /**
+     * @brief print Print the counters
+     * @param _os
+     */
+    inline void print(std::ostream &_os) const;
+
+protected:
+    typedef std::chrono::steady_clock Clock;
+
+    struct ThresholdBin {
+        uint64_t accepted;
+        uint64_t rejected;
+        uint64_t infeasible;
+        ThresholdBin() : accepted(0), rejected(0), infeasible(0) { }
+    };
+    struct MoveCounters {
+        uint64_t built;
+        uint64_t infeasible;
+        uint64_t accepted;
+    };
+    struct PhaseCounters {
+        double ns;
+        uint64_t calls;
+    };
+
+    int binsPerDecade;
+    // Bins indexed by floor(log10(threshold) * binsPerDecade); INT_MIN holds thresholds <= 0
+    std::map<int, ThresholdBin> thresholdBins;
+    int currentBinIndex;
+    ThresholdBin *currentBin;
+    MoveCounters moves[NumMoves];
+    Move lastMove;
+    // chainLengths[n] = # shift moves moving n exams
+    std::vector<uint64_t> chainLengths;
+    PhaseCounters phases[NumPhases];
+    Clock::time_point startTime;
+    double seconds;
+};
+
+
+
+void SearchTelemetry::print(std::ostream &_os) const {
+    static char const *moveNames[NumMoves] = { "Room move", "Shift move" };
+    static char const *phaseNames[NumPhases] = { "Build", "Evaluate", "Apply" };
+    uint64_t accepted = 0, rejected = 0, infeasible = 0;
+    for (auto const &bin : thresholdBins) {
+        accepted += bin.second.accepted;
+        rejected += bin.second.rejected;
+        infeasible += bin.second.infeasible;
+    }
+    uint64_t iterations = accepted + rejected;
+    auto rate = [](uint64_t _n, uint64_t _total) { return _total > 0 ? 100.0 * _n / _total : 0.0; };
+    auto flags = _os.flags();
+    auto precision = _os.precision();
+    _os << std::fixed << std::setprecision(2);
+    _os << "Search telemetry" << std::endl;
+    _os << "  Moves evaluated: " << iterations << " in " << seconds << " s ("
+        << (seconds > 0 ? iterations / seconds : 0.0) << " moves/s)" << std::endl;
+    _os << "  Accepted: " << accepted << " (" << rate(accepted, iterations) << "%), rejected: " << rejected
+        << " (" << rate(rejected, iterations) << "%), of which infeasible: " << infeasible << std::endl;
+    _os << "  " << std::left << std::setw(12) << "Operator" << std::right << std::setw(14) << "Built"
+        << std::setw(10) << "Share" << std::setw(14) << "Infeasible" << std::setw(14) << "Accepted"
+        << std::setw(10) << "Success" << std::endl;
+    uint64_t built = 0;
+    for (auto const &counters : moves)
+        built += counters.built;
+    for (int m = 0; m < NumMoves; ++m) {
+        _os << "  " << std::left << std::setw(12) << moveNames[m] << std::right << std::setw(14) << moves[m].built
+            << std::setw(9) << rate(moves[m].built, built) << "%" << std::setw(14) << moves[m].infeasible
+            << std::setw(14) << moves[m].accepted << std::setw(9) << rate(moves[m].accepted, moves[m].built)
+            << "%" << std::endl;
+    }
+    _os << "  Time per phase:" << std::endl;
+    for (int p = 0; p < NumPhases; ++p) {
+        _os << "    " << std::left << std::setw(10) << phaseNames[p] << std::right << std::setw(12)
+            << phases[p].ns * 1e-9 << " s, " << std::setw(12) << phases[p].calls << " calls, "
+            << std::setw(10) << (phases[p].calls > 0 ? phases[p].ns / phases[p].calls : 0.0) << " ns/call" << std::endl;
+    }
+    _os << "  Kempe chain length (exams moved per shift move):" << std::endl;
+    for (std::size_t n = 0; n < chainLengths.size(); ++n) {
+        if (chainLengths[n] > 0)
+            _os << "    " << std::setw(6) << n << std::setw(14) << chainLengths[n] << std::endl;
+    }
+    _os << "  Thresholds (" << binsPerDecade << " bins per decade):" << std::endl;
+    _os << "    " << std::setw(24) << "Range" << std::setw(14) << "Accepted" << std::setw(14) << "Rejected"
+        << std::setw(14) << "Infeasible" << std::setw(12) << "Acceptance" << std::endl;
+    _os << std::scientific << std::setprecision(3);
+    for (auto it = thresholdBins.rbegin(); it != thresholdBins.rend(); ++it) {
+        ThresholdBin const &bin = it->second;
+        uint64_t binIterations = bin.accepted + bin.rejected;
+        if (binIterations == 0)
+            continue;
+        _os << "    ";
+        if (it->first == INT_MIN)
+            _os << std::setw(24) << "<= 0";
+        else
+            _os << std::setw(11) << std::pow(10.0, (double)it->first / binsPerDecade) << " - "
+                << std::setw(10) << std::pow(10.0, (double)(it->first+1) / binsPerDecade);
+        _os << std::setw(14) << bin.accepted << std::setw(14) << bin.rejected << std::setw(14) << bin.infeasible
+            << std::fixed << std::setprecision(2) << std::setw(11) << rate(bin.accepted, binIterations) << "%"
+            << std::scientific << std::setprecision(3) << std::endl;
+    }
+    _os.flags(flags);
+    _os.precision(precision);
+}
+
+
+#endif // SEARCHTELEMETRY_H
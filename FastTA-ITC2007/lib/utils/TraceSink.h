@@ -0,0 +1,286 @@
+#ifndef TRACESINK_H
+#define TRACESINK_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+
+
+/**
+ * @brief The TraceRecord struct. One record of a search trace.
+ */
+struct TraceRecord {
+    enum Event : int32_t { START, THRESHOLD, END };
+
+    // Event kind
+    int32_t event;
+    // Threshold (TA) or temperature (SA)
+    double threshold;
+    // # iterations (neighbours explored) so far
+    uint64_t iteration;
+    // Cost of the current and of the best solution
+    double currentCost;
+    double bestCost;
+    // # accepted and rejected moves so far
+    uint64_t accepted;
+    uint64_t rejected;
+    // Seconds since the creation of the sink
+    double elapsed;
+};
+
+
+/**
+ * @brief The TraceSink class. Structured search trace written by a background thread.
+ *
+ * The search thread pushes TraceRecords into a single-producer single-consumer
+ * lock-free ring buffer; push() never blocks nor allocates, and a record is dropped
+ * (and counted) when the buffer is full. A writer thread drains the buffer and formats
+ * the records as CSV if the filename ends in ".csv", or as JSON lines otherwise, so
+ * neither formatting nor file I/O run on the search thread.
+ */
+class TraceSink {
+
+public:
+    /**
+     * @brief TraceSink Open _filename and start the writer thread.
+     * Throws std::runtime_error if the file can't be created.
+     * @param _filename
+     * @param _capacity Ring buffer capacity in records, rounded up to a power of two
+     */
+    inline explicit TraceSink(std::string const &_filename, std::size_t _capacity = 1 << 16);
+
+    /**
+     * @brief ~TraceSink Write the pending records, stop the writer thread and close the file
+     */
+    inline ~TraceSink();
+
+    TraceSink(TraceSink const &) = delete;
+    TraceSink &operator=(TraceSink const &) = delete;
+
+    /**
+     * @brief push Enqueue _record. Must only be called from one thread at a time.
+     * @param _record
+     * @return false if the buffer is full and the record was dropped
+     */
+    inline bool push(TraceRecord const &_record);
+
+    /**
+     * @brief getElapsed
+     * @return Seconds since the creation of the sink
+     */
+    double getElapsed() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    }
+    /**
+     * @brief getNumDropped
+     * @return # records dropped because the buffer was full
+     */
+    uint64_t getNumDropped() const { return numDropped; }
+    /**
+     * @brief getFilename
+     * @return
+     */
+    std::string const &getFilename() const { return filename; }
+
+protected:
+    /**
+     * @brief run Writer thread body
+     */
+    inline void run();
+    /**
+     * @brief write Format _record to the file
+     * @param _record
+     */
+    inline void write(TraceRecord const &_record);
+
+    std::string filename;
+    FILE *file;
+    bool csv;
+    std::chrono::steady_clock::time_point startTime;
+    // Ring buffer
+    std::vector<TraceRecord> buffer;
+    std::size_t mask;
+    // Next slot to write (producer) and to read (consumer), on separate cache lines
+    alignas(64) std::atomic<std::size_t> head;
+    alignas(64) std::atomic<std::size_t> tail;
+    // Producer side only
+    alignas(64) uint64_t numDropped;
+    std::atomic<bool> stopping;
+    std::thread writer;
+};
+
+
+/**
+ * @brief The SearchTracer class. Trace state of a threshold based local search explorer
+ * (moTAexplorer, moSAexplorer): iteration and move counters and best cost, pushed to a
+ * TraceSink at the start, at every _interval-th threshold change and at the end of the search.
+ * Disabled, i.e. without sink, it costs one test per iteration.
+ */
+class SearchTracer {
+
+public:
+    SearchTracer() : sink(nullptr), interval(1) { reset(); }
+
+    /**
+     * @brief setSink
+     * @param _sink Sink receiving the records; nullptr disables tracing
+     * @param _interval Trace every _interval-th threshold change
+     */
+    void setSink(TraceSink *_sink, unsigned long _interval = 1) {
+        if (_interval == 0)
+            throw std::runtime_error("SearchTracer: the trace interval must be positive");
+        sink = _sink;
+        interval = _interval;
+    }
+    /**
+     * @brief isEnabled
+     * @return true if there is a sink
+     */
+    bool isEnabled() const { return sink != nullptr; }
+
+    /**
+     * @brief start Search start
+     */
+    void start(double _threshold, double _cost) {
+        reset();
+        bestCost = _cost;
+        push(TraceRecord::START, _threshold, _cost);
+    }
+    /**
+     * @brief iteration Count one iteration
+     * @param _cost Cost of the current solution after the iteration
+     * @param _accepted true if the move was accepted
+     */
+    void iteration(double _cost, bool _accepted) {
+        ++numIterations;
+        if (_accepted) {
+            ++numAccepted;
+            if (_cost < bestCost)
+                bestCost = _cost;
+        }
+        else
+            ++numRejected;
+    }
+    /**
+     * @brief thresholdChanged Threshold update
+     */
+    void thresholdChanged(double _threshold, double _cost) {
+        if (++numThresholds % interval == 0)
+            push(TraceRecord::THRESHOLD, _threshold, _cost);
+    }
+    /**
+     * @brief end Search end
+     */
+    void end(double _threshold, double _cost) { push(TraceRecord::END, _threshold, _cost); }
+
+protected:
+    void reset() {
+        numIterations = numAccepted = numRejected = numThresholds = 0;
+        bestCost = std::numeric_limits<double>::max();
+    }
+
+    void push(int32_t _event, double _threshold, double _cost) {
+        TraceRecord record;
+        record.event = _event;
+        record.threshold = _threshold;
+        record.iteration = numIterations;
+        record.currentCost = _cost;
+        record.bestCost = bestCost;
+        record.accepted = numAccepted;
+        record.rejected = numRejected;
+        record.elapsed = sink->getElapsed();
+        sink->push(record);
+    }
+
+    TraceSink *sink;
+    unsigned long interval;
+    uint64_t numIterations;
+    uint64_t numAccepted;
+    uint64_t numRejected;
+    uint64_t numThresholds;
+    double bestCost;
+};
+
+
+
+TraceSink::TraceSink(std::string const &_filename, std::size_t _capacity)
+    : filename(_filename), file(nullptr), csv(false), startTime(std::chrono::steady_clock::now()),
+      mask(0), head(0), tail(0), numDropped(0), stopping(false) {
+    std::size_t capacity = 1;
+    while (capacity < _capacity)
+        capacity <<= 1;
+    buffer.resize(capacity);
+    mask = capacity - 1;
+    file = fopen(filename.c_str(), "w");
+    if (file == nullptr)
+        throw std::runtime_error(filename + ": can't create the trace file");
+    std::string extension = ".csv";
+    csv = filename.size() >= extension.size() &&
+            filename.compare(filename.size()-extension.size(), extension.size(), extension) == 0;
+    if (csv)
+        fputs("event,iteration,threshold,current,best,accepted,rejected,elapsed\n", file);
+    writer = std::thread(&TraceSink::run, this);
+}
+
+
+TraceSink::~TraceSink() {
+    stopping.store(true, std::memory_order_release);
+    writer.join();
+    fclose(file);
+}
+
+
+bool TraceSink::push(TraceRecord const &_record) {
+    std::size_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) > mask) {
+        ++numDropped;
+        return false;
+    }
+    buffer[h & mask] = _record;
+    head.store(h+1, std::memory_order_release);
+    return true;
+}
+
+
+void TraceSink::run() {
+    for (;;) {
+        // Read the flag before draining, so records pushed before the stop are written
+        bool stop = stopping.load(std::memory_order_acquire);
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        std::size_t h = head.load(std::memory_order_acquire);
+        for (; t != h; ++t) {
+            write(buffer[t & mask]);
+            tail.store(t+1, std::memory_order_release);
+        }
+        if (stop)
+            break;
+        fflush(file);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    fflush(file);
+}
+
+
+void TraceSink::write(TraceRecord const &_record) {
+    static char const *eventNames[] = { "start", "threshold", "end" };
+    char const *event = (_record.event >= 0 && _record.event <= TraceRecord::END) ? eventNames[_record.event] : "unknown";
+    if (csv)
+        fprintf(file, "%s,%llu,%.10g,%.10g,%.10g,%llu,%llu,%.6f\n", event,
+                (unsigned long long)_record.iteration, _record.threshold, _record.currentCost, _record.bestCost,
+                (unsigned long long)_record.accepted, (unsigned long long)_record.rejected, _record.elapsed);
+    else
+        fprintf(file, "{\"event\":\"%s\",\"iteration\":%llu,\"threshold\":%.10g,\"current\":%.10g,\"best\":%.10g,"
+                      "\"accepted\":%llu,\"rejected\":%llu,\"elapsed\":%.6f}\n", event,
+                (unsigned long long)_record.iteration, _record.threshold, _record.currentCost, _record.bestCost,
+                (unsigned long long)_record.accepted, (unsigned long long)_record.rejected, _record.elapsed);
+}
+
+
+#endif // TRACESINK_H
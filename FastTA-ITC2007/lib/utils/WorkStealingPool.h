@@ -0,0 +1,234 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+
+/**
+ * @brief The WorkStealingPool class
+ *
+ * Fixed-size thread pool running batches of independent tasks. The calling
+ * thread takes part as worker 0. The task indices of a batch are dealt in
+ * contiguous blocks to per-worker queues. A worker pops from the front of its
+ * own queue and, once it is empty, steals from the back of the other queues,
+ * so the imbalance between tasks (e.g. cells running a full TA or none) is
+ * absorbed dynamically.
+ */
+class WorkStealingPool {
+
+public:
+    /**
+     * @brief TaskFunction Task body. Receives the task index and the worker index.
+     */
+    typedef std::function<void(unsigned, unsigned)> TaskFunction;
+
+    /**
+     * @brief WorkStealingPool Constructor
+     * @param _numThreads Number of workers, including the calling thread
+     */
+    inline WorkStealingPool(unsigned _numThreads);
+
+    /**
+     * @brief ~WorkStealingPool Destructor. Stop worker threads.
+     */
+    inline ~WorkStealingPool();
+
+    /**
+     * @brief getNumThreads
+     * @return Number of workers, including the calling thread
+     */
+    inline unsigned getNumThreads() const;
+
+    /**
+     * @brief parallelFor Run tasks 0.._numTasks-1 and wait for their completion.
+     * The first exception thrown by a task is rethrown in the calling thread.
+     * @param _numTasks
+     * @param _task
+     */
+    inline void parallelFor(unsigned _numTasks, TaskFunction const &_task);
+
+protected:
+    /**
+     * @brief The TaskQueue struct
+     */
+    struct TaskQueue {
+        std::mutex mtx;
+        std::deque<unsigned> tasks;
+    };
+
+    /**
+     * @brief workerLoop Worker thread body
+     * @param _w worker index
+     */
+    inline void workerLoop(unsigned _w);
+
+    /**
+     * @brief runTasks Run tasks until every queue is empty
+     * @param _w worker index
+     */
+    inline void runTasks(unsigned _w);
+
+    /**
+     * @brief popTask Pop task from the front of worker _w queue
+     * @param _w
+     * @param _task
+     * @return false if the queue is empty
+     */
+    inline bool popTask(unsigned _w, unsigned &_task);
+
+    /**
+     * @brief stealTask Steal task from the back of another worker queue
+     * @param _w
+     * @param _task
+     * @return false if every queue is empty
+     */
+    inline bool stealTask(unsigned _w, unsigned &_task);
+
+    // Per-worker task queues
+    std::vector<boost::shared_ptr<TaskQueue> > queues;
+    // Worker threads (worker 0 is the calling thread)
+    std::vector<std::thread> threads;
+    // Synchronisation
+    std::mutex mtx;
+    std::condition_variable startCond;
+    std::condition_variable doneCond;
+    // Current batch task
+    TaskFunction const *currentTask;
+    // Batch number
+    unsigned long batchNumber;
+    // # workers still running the current batch
+    unsigned numActive;
+    // Stop flag
+    bool stop;
+    // First exception thrown in the current batch
+    std::exception_ptr error;
+};
+
+
+
+WorkStealingPool::WorkStealingPool(unsigned _numThreads)
+    : currentTask(nullptr), batchNumber(0), numActive(0), stop(false)
+{
+    if (_numThreads == 0)
+        _numThreads = 1;
+    for (unsigned w = 0; w < _numThreads; ++w)
+        queues.push_back(boost::make_shared<TaskQueue>());
+    for (unsigned w = 1; w < _numThreads; ++w)
+        threads.push_back(std::thread(&WorkStealingPool::workerLoop, this, w));
+}
+
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stop = true;
+    }
+    startCond.notify_all();
+    for (auto &thread : threads)
+        thread.join();
+}
+
+
+unsigned WorkStealingPool::getNumThreads() const {
+    return queues.size();
+}
+
+
+void WorkStealingPool::parallelFor(unsigned _numTasks, TaskFunction const &_task) {
+    unsigned numWorkers = queues.size();
+    // Deal tasks in contiguous blocks
+    for (unsigned w = 0; w < numWorkers; ++w) {
+        unsigned first = (unsigned long)_numTasks * w / numWorkers;
+        unsigned last = (unsigned long)_numTasks * (w+1) / numWorkers;
+        std::lock_guard<std::mutex> lock(queues[w]->mtx);
+        queues[w]->tasks.clear();
+        for (unsigned i = first; i < last; ++i)
+            queues[w]->tasks.push_back(i);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        currentTask = &_task;
+        numActive = threads.size();
+        error = nullptr;
+        ++batchNumber;
+    }
+    startCond.notify_all();
+    // The calling thread is worker 0
+    runTasks(0);
+    std::unique_lock<std::mutex> lock(mtx);
+    doneCond.wait(lock, [this]() { return numActive == 0; });
+    currentTask = nullptr;
+    if (error)
+        std::rethrow_exception(error);
+}
+
+
+void WorkStealingPool::workerLoop(unsigned _w) {
+    unsigned long lastBatch = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            startCond.wait(lock, [this, lastBatch]() { return stop || batchNumber != lastBatch; });
+            if (stop)
+                return;
+            lastBatch = batchNumber;
+        }
+        runTasks(_w);
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (--numActive == 0)
+                doneCond.notify_one();
+        }
+    }
+}
+
+
+void WorkStealingPool::runTasks(unsigned _w) {
+    unsigned task;
+    while (popTask(_w, task) || stealTask(_w, task)) {
+        try {
+            (*currentTask)(task, _w);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (!error)
+                error = std::current_exception();
+        }
+    }
+}
+
+
+bool WorkStealingPool::popTask(unsigned _w, unsigned &_task) {
+    std::lock_guard<std::mutex> lock(queues[_w]->mtx);
+    if (queues[_w]->tasks.empty())
+        return false;
+    _task = queues[_w]->tasks.front();
+    queues[_w]->tasks.pop_front();
+    return true;
+}
+
+
+bool WorkStealingPool::stealTask(unsigned _w, unsigned &_task) {
+    unsigned numWorkers = queues.size();
+    for (unsigned k = 1; k < numWorkers; ++k) {
+        TaskQueue &victim = *queues[(_w+k) % numWorkers];
+        std::lock_guard<std::mutex> lock(victim.mtx);
+        if (!victim.tasks.empty()) {
+            _task = victim.tasks.back();
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+
+#endif // WORKSTEALINGPOOL_H
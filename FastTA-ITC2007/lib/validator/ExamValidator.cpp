@@ -0,0 +1,255 @@
+#include "validator/ExamValidator.h"
+#include <algorithm>
+#include <stdexcept>
+#include "data/ITC2007Constraints.hpp"
+#include "testset/ITC2007Parser.h"
+#include "utils/MappedFile.h"
+
+
+using namespace std;
+
+
+
+ExamValidator::ExamValidator(TimetableProblemData const *_timetableProblemData)
+    : timetableProblemData(_timetableProblemData) {
+    if (timetableProblemData->getSparseConflictMatrix())
+        conflicts = *timetableProblemData->getSparseConflictMatrix();
+    else {
+        IntMatrix const &conflictMatrix = timetableProblemData->getConflictMatrix();
+        int numExams = timetableProblemData->getNumExams();
+        vector<int> rowStart(numExams+1, 0), cols, vals;
+        for (int i = 0; i < numExams; ++i) {
+            for (int j = 0; j < numExams; ++j) {
+                if (conflictMatrix.getVal(i, j) != 0) {
+                    cols.push_back(j);
+                    vals.push_back(conflictMatrix.getVal(i, j));
+                }
+            }
+            rowStart[i+1] = cols.size();
+        }
+        conflicts = SparseIntMatrix(numExams, std::move(rowStart), std::move(cols), std::move(vals));
+    }
+}
+
+
+bool ExamValidator::isSameDay(int _t1, int _t2) const {
+    auto const &periodVector = timetableProblemData->getPeriodVector();
+    Date const &d1 = periodVector[_t1]->getDate(), &d2 = periodVector[_t2]->getDate();
+    return d1.getDay() == d2.getDay() && d1.getMonth() == d2.getMonth() && d1.getYear() == d2.getYear();
+}
+
+
+ExamValidator::Report ExamValidator::validate(vector<int> const &_periods, vector<int> const &_rooms) const {
+    int numExams = timetableProblemData->getNumExams();
+    int numPeriods = timetableProblemData->getNumPeriods();
+    int numRooms = timetableProblemData->getNumRooms();
+    auto const &examVector = timetableProblemData->getExamVector();
+    auto const &periodVector = timetableProblemData->getPeriodVector();
+    auto const &roomVector = timetableProblemData->getRoomVector();
+    InstitutionalModelWeightings const &model_weightings = timetableProblemData->getInstitutionalModelWeightings();
+
+    Report report = Report();
+    // Exams with a valid assignment
+    vector<char> valid(numExams, 0);
+    for (int ei = 0; ei < numExams; ++ei) {
+        valid[ei] = ei < (int)_periods.size() && ei < (int)_rooms.size()
+                && _periods[ei] >= 0 && _periods[ei] < numPeriods && _rooms[ei] >= 0 && _rooms[ei] < numRooms;
+        if (!valid[ei])
+            ++report.invalidAssignments;
+    }
+
+    //
+    // Student conflicts, two in a row, two in a day and period spread: one pass over
+    // the pairs of conflicting exams (i < j)
+    //
+    for (int ei = 0; ei < numExams; ++ei) {
+        if (!valid[ei])
+            continue;
+        for (int k = conflicts.getRowBegin(ei); k < conflicts.getRowEnd(ei); ++k) {
+            int ej = conflicts.getCol(k);
+            if (ej <= ei || !valid[ej])
+                continue;
+            long numStudents = conflicts.getVal(k);
+            int t1 = min(_periods[ei], _periods[ej]), t2 = max(_periods[ei], _periods[ej]);
+            int gap = t2 - t1;
+            if (gap == 0) {
+                report.conflicts += numStudents;
+                continue;
+            }
+            if (isSameDay(t1, t2)) {
+                if (gap == 1)
+                    report.twoInARow += numStudents * model_weightings.two_in_a_row;
+                else
+                    report.twoInADay += numStudents * model_weightings.two_in_a_day;
+            }
+            if (gap <= model_weightings.period_spread)
+                report.periodSpread += numStudents;
+        }
+    }
+
+    //
+    // Room occupancy, mixed durations and room exclusivity, per room-period. Exams are
+    // bucketed by room-period with a counting sort.
+    //
+    int numCells = numRooms * numPeriods;
+    vector<int> cellStart(numCells+1, 0), cellExams(numExams);
+    for (int ei = 0; ei < numExams; ++ei) {
+        if (valid[ei])
+            ++cellStart[_rooms[ei]*numPeriods + _periods[ei] + 1];
+    }
+    for (int c = 0; c < numCells; ++c)
+        cellStart[c+1] += cellStart[c];
+    vector<int> cellPos(cellStart.begin(), cellStart.end()-1);
+    for (int ei = 0; ei < numExams; ++ei) {
+        if (valid[ei])
+            cellExams[cellPos[_rooms[ei]*numPeriods + _periods[ei]]++] = ei;
+    }
+    vector<int> durations;
+    for (int c = 0; c < numCells; ++c) {
+        int first = cellStart[c], last = cellStart[c+1];
+        if (first == last)
+            continue;
+        int rk = c / numPeriods;
+        long seats = 0;
+        durations.clear();
+        for (int i = first; i < last; ++i) {
+            int ei = cellExams[i];
+            seats += examVector[ei]->getNumStudents();
+            durations.push_back(examVector[ei]->getDuration());
+            // Room-Related (ROOM_EXCLUSIVE)
+            if (last - first > 1 && !examVector[ei]->getRoomRelatedHardConstraints().empty())
+                ++report.roomRelated;
+        }
+        if (seats > roomVector[rk]->getCapacity())
+            ++report.roomOccupancy;
+        sort(durations.begin(), durations.end());
+        long numDurations = unique(durations.begin(), durations.end()) - durations.begin();
+        report.mixedDurations += (numDurations - 1) * model_weightings.non_mixed_durations;
+    }
+
+    //
+    // Period utilisation, room and period penalties
+    //
+    for (int ei = 0; ei < numExams; ++ei) {
+        if (!valid[ei])
+            continue;
+        ITC2007Period const &period = *periodVector[_periods[ei]];
+        if (examVector[ei]->getDuration() > period.getDuration())
+            ++report.periodUtilisation;
+        report.roomPenalty += roomVector[_rooms[ei]]->getPenalty();
+        report.periodPenalty += period.getPenalty();
+    }
+
+    //
+    // Period-Related hard constraints
+    //
+    for (auto const &constraint : timetableProblemData->getHardConstraints()) {
+        Constraint const *c = constraint.get();
+        if (auto after = dynamic_cast<AfterConstraint const *>(c)) {
+            // e1 AFTER e2: e1 is scheduled after e2
+            int e1 = after->getE1(), e2 = after->getE2();
+            if (valid[e1] && valid[e2] && _periods[e1] <= _periods[e2])
+                ++report.periodRelated;
+        }
+        else if (auto coincidence = dynamic_cast<ExamCoincidenceConstraint const *>(c)) {
+            // Same period. As in the solver, the constraint is ignored for exams with
+            // students in common, which can't be scheduled together.
+            int e1 = coincidence->getE1(), e2 = coincidence->getE2();
+            if (valid[e1] && valid[e2] && _periods[e1] != _periods[e2] && conflicts.getVal(e1, e2) == 0)
+                ++report.periodRelated;
+        }
+        else if (auto exclusion = dynamic_cast<ExamExclusionConstraint const *>(c)) {
+            int e1 = exclusion->getE1(), e2 = exclusion->getE2();
+            if (valid[e1] && valid[e2] && _periods[e1] == _periods[e2])
+                ++report.periodRelated;
+        }
+    }
+
+    //
+    // Front load: the largest exams are penalised in the last periods
+    //
+    if (model_weightings.front_load.size() == 3) {
+        auto const &sortedCourseClassSize = timetableProblemData->getSortedCourseClassSize();
+        int numLargestExams = min<int>(model_weightings.front_load[0], sortedCourseClassSize.size());
+        int firstLastPeriod = numPeriods - model_weightings.front_load[1];
+        for (int i = 0; i < numLargestExams; ++i) {
+            int ei = sortedCourseClassSize[i].first;
+            if (valid[ei] && _periods[ei] >= firstLastPeriod)
+                report.frontLoad += model_weightings.front_load[2];
+        }
+    }
+    return report;
+}
+
+
+ExamValidator::Report ExamValidator::validate(eoChromosome const &_chrom) const {
+    auto const &scheduledExamsVector = _chrom.getScheduledExamsVector();
+    vector<int> periods(scheduledExamsVector.size()), rooms(scheduledExamsVector.size());
+    for (size_t ei = 0; ei < scheduledExamsVector.size(); ++ei) {
+        periods[ei] = scheduledExamsVector[ei].getPeriod();
+        rooms[ei] = scheduledExamsVector[ei].getRoom();
+    }
+    return validate(periods, rooms);
+}
+
+
+ExamValidator::Report ExamValidator::validate(string const &_solutionFilename) const {
+    vector<int> periods, rooms;
+    MappedFile file(_solutionFilename);
+    ITC2007Parser parser(file.begin(), file.end());
+    try {
+        while (!parser.atEnd()) {
+            periods.push_back(parser.readInt());
+            parser.expect(',');
+            rooms.push_back(parser.readInt());
+            parser.nextLine();
+        }
+    }
+    catch (runtime_error const &e) {
+        throw runtime_error(_solutionFilename + ": " + e.what());
+    }
+    if ((int)periods.size() > timetableProblemData->getNumExams())
+        throw runtime_error(_solutionFilename + ": " + to_string(periods.size()) + " exams scheduled, the instance has "
+                            + to_string(timetableProblemData->getNumExams()));
+    return validate(periods, rooms);
+}
+
+
+bool ExamValidator::check(eoChromosome const &_chrom, ostream &_os) const {
+    Report report = validate(_chrom);
+    bool ok = true;
+    if (!report.isFeasible()) {
+        _os << "[ExamValidator] infeasible solution, distance to feasibility = "
+            << report.getDistanceToFeasibility() << endl;
+        ok = false;
+    }
+    if (report.getSoftCost() != _chrom.getSolutionCost()) {
+        _os << "[ExamValidator] solution cost is " << _chrom.getSolutionCost()
+            << ", the validator computes " << report.getSoftCost() << endl;
+        ok = false;
+    }
+    if (!ok)
+        print(_os, report);
+    return ok;
+}
+
+
+void ExamValidator::print(ostream &_os, Report const &_report) {
+    _os << "Hard constraint violations" << endl
+        << "  Invalid assignments:  " << _report.invalidAssignments << endl
+        << "  Conflicts:            " << _report.conflicts << endl
+        << "  Room occupancy:       " << _report.roomOccupancy << endl
+        << "  Period utilisation:   " << _report.periodUtilisation << endl
+        << "  Period related:       " << _report.periodRelated << endl
+        << "  Room related:         " << _report.roomRelated << endl
+        << "Distance to feasibility: " << _report.getDistanceToFeasibility() << endl
+        << "Soft costs" << endl
+        << "  Two in a row:         " << _report.twoInARow << endl
+        << "  Two in a day:         " << _report.twoInADay << endl
+        << "  Period spread:        " << _report.periodSpread << endl
+        << "  Mixed durations:      " << _report.mixedDurations << endl
+        << "  Front load:           " << _report.frontLoad << endl
+        << "  Room penalty:         " << _report.roomPenalty << endl
+        << "  Period penalty:       " << _report.periodPenalty << endl
+        << "Solution cost: " << _report.getSoftCost() << endl;
+}
@@ -0,0 +1,137 @@
+#ifndef EXAMVALIDATOR_H
+#define EXAMVALIDATOR_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include "data/TimetableProblemData.hpp"
+#include "chromosome/eoChromosome.h"
+
+
+/**
+ * @brief The ExamValidator class. Validator of ITC2007 examination track solutions.
+ *
+ * Computes every hard constraint violation and the seven soft cost components of a
+ * solution given as the (period, room) of each exam, independently of the timetable
+ * containers and of the incremental evaluation of eoChromosome. It runs in time
+ * linear in the number of exams, conflicts (non-zero entries of the sparse conflict
+ * matrix), hard constraints and room-periods.
+ *
+ * Used by the validateExam executable, and at run time to check a solution against
+ * its incrementally maintained cost (see check()).
+ */
+class ExamValidator {
+
+public:
+    /**
+     * @brief The Report struct. Hard constraint violations and soft costs of a solution
+     */
+    struct Report {
+        //
+        // Hard constraint violations
+        //
+        // Exams with a missing or out of range period or room. The other counts
+        // only consider the exams with a valid assignment.
+        int invalidAssignments;
+        // Students sitting two exams in the same period
+        long conflicts;
+        // Room-periods with more students than seats
+        int roomOccupancy;
+        // Exams longer than their period
+        int periodUtilisation;
+        // Violated AFTER, EXAM_COINCIDENCE and EXCLUSION constraints
+        int periodRelated;
+        // ROOM_EXCLUSIVE exams sharing their room
+        int roomRelated;
+        //
+        // Soft costs, weighted
+        //
+        long twoInARow;
+        long twoInADay;
+        long periodSpread;
+        long mixedDurations;
+        long frontLoad;
+        long roomPenalty;
+        long periodPenalty;
+
+        /**
+         * @brief getDistanceToFeasibility
+         * @return Sum of the hard constraint violations
+         */
+        long getDistanceToFeasibility() const {
+            return invalidAssignments + conflicts + roomOccupancy + periodUtilisation + periodRelated + roomRelated;
+        }
+        /**
+         * @brief isFeasible
+         * @return
+         */
+        bool isFeasible() const { return getDistanceToFeasibility() == 0; }
+        /**
+         * @brief getSoftCost
+         * @return Solution cost, as defined by the competition
+         */
+        long getSoftCost() const {
+            return twoInARow + twoInADay + periodSpread + mixedDurations + frontLoad + roomPenalty + periodPenalty;
+        }
+    };
+
+    /**
+     * @brief ExamValidator Constructor
+     * @param _timetableProblemData
+     */
+    explicit ExamValidator(TimetableProblemData const *_timetableProblemData);
+
+    /**
+     * @brief validate
+     * @param _periods Period of each exam
+     * @param _rooms Room of each exam
+     * @return
+     */
+    Report validate(std::vector<int> const &_periods, std::vector<int> const &_rooms) const;
+    /**
+     * @brief validate
+     * @param _chrom Complete solution
+     * @return
+     */
+    Report validate(eoChromosome const &_chrom) const;
+    /**
+     * @brief validate Validate the solution of file _solutionFilename (.sln format).
+     * Throws std::runtime_error if the file is malformed.
+     * @param _solutionFilename
+     * @return
+     */
+    Report validate(std::string const &_solutionFilename) const;
+
+    /**
+     * @brief check Validate _chrom and compare with its incrementally maintained cost
+     * @param _chrom
+     * @param _os Receives a description of any discrepancy
+     * @return true if _chrom is feasible and its cost is right
+     */
+    bool check(eoChromosome const &_chrom, std::ostream &_os = std::cerr) const;
+
+    /**
+     * @brief print Print _report
+     * @param _os
+     * @param _report
+     */
+    static void print(std::ostream &_os, Report const &_report);
+
+protected:
+    /**
+     * @brief isSameDay
+     * @param _t1
+     * @param _t2
+     * @return true if periods _t1 and _t2 are on the same date
+     */
+    bool isSameDay(int _t1, int _t2) const;
+
+    // Instance
+    TimetableProblemData const *timetableProblemData;
+    // Conflict matrix in compressed sparse row form, built from the dense matrix
+    // if the instance doesn't have one
+    SparseIntMatrix conflicts;
+};
+
+
+#endif // EXAMVALIDATOR_H